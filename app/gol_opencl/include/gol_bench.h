@@ -0,0 +1,99 @@
+#ifndef GOL_BENCH_H
+#define GOL_BENCH_H
+
+#include "gol_engine.h"
+#include "gol_histogram.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * "bench" subcommand: a whole measurement sweep in one process. Points are the
+ * product of sizes x wrap x modes x local sizes (GPU modes) x steps (tiled only).
+ * The GPU points run on one gol_engine, so the context, queue, built programs and
+ * board buffers are shared by every point; each finished point is handed to a
+ * report callback, which prints it and appends its CSV row.
+ */
+
+#define GOL_BENCH_MAX_ITEMS 32
+
+// Engines a benchmark sweep can run.
+typedef enum GolBenchMode {
+    GOL_BENCH_CPU_SEQ = 0,
+    GOL_BENCH_CPU_PAR,
+    GOL_BENCH_NAIVE,
+    GOL_BENCH_TILED,
+    GOL_BENCH_PACKED
+} GolBenchMode;
+
+// One entry of --modes; lx 0 runs every --local size, "tiled@8x8" only that one.
+typedef struct GolBenchModeItem {
+    GolBenchMode mode;
+    size_t lx;
+    size_t ly;
+} GolBenchModeItem;
+
+// One board of --sizes; iters 0 takes the sweep-wide --iters.
+typedef struct GolBenchSize {
+    int rows;
+    int cols;
+    int iters;
+} GolBenchSize;
+
+typedef struct GolBenchSpec {
+    GolBenchSize sizes[GOL_BENCH_MAX_ITEMS];
+    int n_sizes;
+    GolBenchModeItem modes[GOL_BENCH_MAX_ITEMS];
+    int n_modes;
+    size_t local[GOL_BENCH_MAX_ITEMS][2];
+    int n_local;
+    int wraps[GOL_BENCH_MAX_ITEMS];
+    int n_wraps;
+    int steps[GOL_BENCH_MAX_ITEMS];
+    int n_steps;
+    int iters;
+    int repeat;
+    int warmup;
+    int threads;
+    unsigned int seed;
+    uint32_t rule;
+    const char* out_path;
+    const char* kernel_dir;
+    const char* kernel_cache;
+    int roofline;
+} GolBenchSpec;
+
+// One finished point; the sample arrays hold the repeat measured runs.
+typedef struct GolBenchPoint {
+    GolBenchMode mode;
+    int rows;
+    int cols;
+    int iters;
+    int wrap;
+    size_t lx;                // cpu_par: the threads used; cpu_seq: 1
+    size_t ly;
+    int steps_per_launch;
+    double* h2d_ms;           // NULL for the CPU engines
+    double* kernel_ms;
+    double* d2h_ms;           // NULL for the CPU engines
+    double* wall_ms;
+    GolBuildStats build;      // programs this point built; reused when earlier points built them all
+    const GolHistogram* gen_hist; // kernel ns per generation of a GPU point, NULL for the CPU engines
+} GolBenchPoint;
+
+// Called for every finished point; returns 0 to abort the sweep.
+typedef int (*GolBenchReport)(const GolBenchPoint* point, void* ctx);
+
+// Parse the arguments after "bench" into spec. Returns 0 to run the sweep, 1 after printing the
+// usage for --help, or -1 after printing what was wrong.
+int gol_bench_parse(GolBenchSpec* spec, int argc, char** argv, const char* argv0);
+
+// Whether the sweep has a GPU mode and so needs an engine.
+int gol_bench_needs_gpu(const GolBenchSpec* spec);
+
+// Run the sweep; engine may be NULL when gol_bench_needs_gpu is 0. Returns the number of
+// points run, with the points skipped because the device rejected their local size in
+// *skipped, or -1 when an engine failed or the report callback aborted.
+int gol_bench_run(const GolBenchSpec* spec, GolEngine* engine, GolBenchReport report, void* ctx, int* skipped);
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef GOL_BITPACK_H
+#define GOL_BITPACK_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Bit-packed grid layout used by the gol_step_packed kernel:
+ * every row holds gol_packed_words_per_row(cols) 64-bit words,
+ * bit j of word w is the cell in column w * 64 + j.
+ * Padding bits after the last column are always zero.
+ */
+
+// Number of 64-bit words needed to store one packed row.
+size_t gol_packed_words_per_row(int cols);
+
+// Pack a row-major 0/1 byte grid into the packed word layout.
+void gol_pack_grid(const unsigned char* grid, uint64_t* packed, int rows, int cols);
+
+// Unpack a packed word grid back into a row-major 0/1 byte grid.
+void gol_unpack_grid(const uint64_t* packed, unsigned char* grid, int rows, int cols);
+
+#endif
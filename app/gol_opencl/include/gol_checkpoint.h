@@ -0,0 +1,75 @@
+#ifndef GOL_CHECKPOINT_H
+#define GOL_CHECKPOINT_H
+
+#include "gol_cl.h"
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Asynchronous checkpoints for long GPU runs. The board is read without
+ * blocking into pinned staging buffers and a background thread writes it
+ * as a snapshot (gol_pattern.h) through a temporary file, so the kernels
+ * keep running while the file is written and a crash never leaves a torn
+ * checkpoint. Packed and Generations boards are expanded before writing.
+ */
+
+#define GOL_CHECKPOINT_SLOTS 2
+
+// One pinned staging area for a checkpoint in flight.
+typedef struct GolCheckpointSlot {
+    cl_mem staging;       // CL_MEM_ALLOC_HOST_PTR buffer, mapped for the whole run
+    void* host;           // pinned host view of staging; the board is read straight into it
+    cl_event ready;       // completion of the non-blocking read
+    uint64_t generation;
+    int pending;          // 1 while the read or the file write is outstanding
+} GolCheckpointSlot;
+
+// Background writer that turns staged boards into snapshot files while the kernels keep running.
+typedef struct GolCheckpointWriter {
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    GolCheckpointSlot slots[GOL_CHECKPOINT_SLOTS];
+    int fill;             // next slot the simulation thread fills
+    int drain;            // next slot the writer thread saves
+    int quit;
+
+    const char* path;
+    char tmp_path[1024];
+    int rows;
+    int cols;
+    int packed;
+    int state_bits;            // > 0 for the packed Generations layout
+    int wrap;
+    uint32_t rule;
+    int states;
+    unsigned int seed;
+    size_t bytes;
+    unsigned char* unpacked;   // packed and Generations boards are expanded here before writing
+
+    // Written by the writer thread, read after it has been joined.
+    int written;
+    int failed;
+    uint64_t last_generation;
+    double write_ms;
+} GolCheckpointWriter;
+
+// Allocate and map the pinned staging buffers and start the writer thread.
+// bytes is the device size of the board, in the layout selected by packed and states.
+// Returns 1 on success, 0 after printing why the writer could not be set up.
+int gol_checkpoint_start(GolCheckpointWriter* w, cl_context context, cl_command_queue queue,
+                         const char* path, size_t bytes, int rows, int cols,
+                         int packed, int wrap, uint32_t rule, int states, unsigned int seed);
+
+// Queue a copy of board for the writer; only blocks when both staging slots are still busy.
+void gol_checkpoint_enqueue(GolCheckpointWriter* w, cl_command_queue queue, cl_mem board, uint64_t generation);
+
+// Let the writer drain every queued checkpoint, then release the staging buffers.
+void gol_checkpoint_finish(GolCheckpointWriter* w, cl_command_queue queue);
+
+// True when advancing from generation before to after crosses a multiple of every.
+int gol_checkpoint_due(int every, uint64_t before, uint64_t after);
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef GOL_CL_H
+#define GOL_CL_H
+
+#define CL_TARGET_OPENCL_VERSION 220
+#include <CL/cl.h>
+
+#include <stddef.h>
+
+/*
+ * OpenCL helpers shared by the command-line front end, its engines and the
+ * gol_engine library API: timing, launch geometry checks, step kernel
+ * arguments and program builds through the binary cache (gol_program_cache.h).
+ */
+
+// Current time in milliseconds from a high-resolution monotonic clock.
+double gol_now_ms(void);
+
+// Report a failed OpenCL call and exit. Only the front end and its engines use it, never gol_engine.
+void gol_die_cl(const char* where, cl_int err);
+
+// Profiled execution time of a completed command in nanoseconds.
+cl_ulong gol_event_ns(cl_event ev);
+
+// Round value up to the next multiple; multiple 0 leaves it unchanged.
+size_t gol_round_up(size_t value, size_t multiple);
+
+// Print name, vendor, compute units and global memory of a device.
+void gol_print_device_info(cl_device_id device);
+
+// Explain why load_kernel (kernel_loader.h) could not return a kernel source.
+void gol_print_kernel_load_error(const char* name, const char* kernel_dir, int code);
+
+/*
+ * Check an lx x ly work-group against the device limits, the limit of kernel when
+ * it is not NULL and, for the tiled kernels, the local memory the tile of `steps`
+ * generations per launch needs. Returns 1 when it fits; otherwise 0 with the
+ * reason written to why.
+ */
+int gol_local_size_fits(cl_device_id device, cl_kernel kernel, size_t lx, size_t ly, int tiled, int steps,
+                        char* why, size_t why_size);
+
+/*
+ * Bind the arguments of one launch of a step kernel (gol_step, gol_step_tiled,
+ * gol_step_tiled_multi, gol_step_packed or gol_step_generations). multi_step
+ * selects the gol_step_tiled_multi layout, which computes launch_steps generations.
+ */
+cl_int gol_set_step_args(cl_kernel kernel, cl_mem cur, cl_mem next, int rows, int cols, int wrap,
+                         int tiled, int multi_step, int launch_steps, size_t lx, size_t ly);
+
+// Program builds of one run: binary cache hits and misses and the time spent creating programs.
+typedef struct GolBuildStats {
+    int hits;
+    int misses;
+    double build_ms;
+    int reused;     // bench points whose programs were all built by earlier points
+} GolBuildStats;
+
+/*
+ * Create and build a program for one device. With a cache directory a binary built
+ * earlier for the same device, driver, source and options is reused; otherwise the
+ * source is compiled and its binary stored for the next run. cache_dir NULL disables
+ * the cache. Returns NULL on failure, with the OpenCL code in *err and the compiler
+ * log printed to stderr.
+ */
+cl_program gol_build_program(cl_context context, cl_device_id device, const char* source, const char* options,
+                             const char* cache_dir, GolBuildStats* stats, cl_int* err);
+
+// Cache outcome of all builds of a run for the report and the CSV: hit, miss, mixed, off or reused.
+const char* gol_build_label(const GolBuildStats* stats);
+
+#endif
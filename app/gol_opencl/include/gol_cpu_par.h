@@ -0,0 +1,45 @@
+#ifndef GOL_CPU_PAR_H
+#define GOL_CPU_PAR_H
+
+#include <stdint.h>
+
+/*
+ * Multithreaded CPU engine.
+ * The board is split into horizontal row bands, one per worker thread.
+ * Each band runs a branch-free (SSE2 when available) interior loop and
+ * handles the first/last column separately, so wrap-around costs no
+ * modulo in the hot path. The interior loop is compiled once per common
+ * rule (see gol_rule.h) and once generically for all other rules.
+ */
+
+typedef struct GolCpuPool GolCpuPool;
+
+// Number of logical processors reported by the operating system (at least 1).
+int gol_cpu_count(void);
+
+// Start a pool with the given number of threads (the calling thread counts as one).
+// Returns NULL when the threads could not be created.
+GolCpuPool* gol_cpu_pool_create(int threads);
+
+// Stop and join all worker threads.
+void gol_cpu_pool_destroy(GolCpuPool* pool);
+
+// Number of threads (including the caller) that share the work.
+int gol_cpu_pool_threads(const GolCpuPool* pool);
+
+/*
+ * Run iters generations of the given rule table starting from grid_a, using grid_b as scratch.
+ * Both buffers must hold rows * cols bytes.
+ * Returns the buffer (grid_a or grid_b) that holds the final generation,
+ * or NULL on allocation failure.
+ */
+unsigned char* gol_cpu_par_run(GolCpuPool* pool,
+                               unsigned char* grid_a,
+                               unsigned char* grid_b,
+                               int rows,
+                               int cols,
+                               int iters,
+                               int wrap,
+                               uint32_t rule);
+
+#endif
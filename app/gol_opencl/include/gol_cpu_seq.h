@@ -0,0 +1,16 @@
+#ifndef GOL_CPU_SEQ_H
+#define GOL_CPU_SEQ_H
+
+#include <stdint.h>
+
+/*
+ * Sequential CPU reference step.
+ * One plain loop over every cell of a row-major, one byte per cell board,
+ * reading neighbours through bounds checks (or modulo with wrap). Every
+ * other engine is validated against it, so it stays deliberately simple.
+ */
+
+// Compute one generation of a rule table (a Generations rule when states > 2) from in into out.
+void gol_cpu_step(const unsigned char* in, unsigned char* out, int rows, int cols, int wrap, uint32_t rule, int states);
+
+#endif
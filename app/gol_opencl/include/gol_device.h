@@ -0,0 +1,15 @@
+#ifndef GOL_DEVICE_H
+#define GOL_DEVICE_H
+
+#define CL_TARGET_OPENCL_VERSION 220
+#include <CL/cl.h>
+
+/*
+ * OpenCL device selection shared by the CLI and the gol_engine library API:
+ * the first GPU of any platform, otherwise the first CPU device.
+ */
+
+// Returns the chosen device and stores its platform, or NULL when there is none.
+cl_device_id gol_pick_device(cl_platform_id* out_platform);
+
+#endif
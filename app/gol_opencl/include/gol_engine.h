@@ -0,0 +1,132 @@
+#ifndef GOL_ENGINE_H
+#define GOL_ENGINE_H
+
+#include "gol_cl.h"
+#include "gol_trace.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * libgol: a persistent OpenCL Game of Life engine for programs that run many
+ * simulations in one process. The gpu mode of the command-line front end and
+ * its benchmark sweep run on it too.
+ *
+ * An engine owns the device, context, queue and the two board buffers, and
+ * keeps the built step program of every rule and kernel variant it has seen
+ * (up to GOL_ENGINE_PROGRAMS), so loading another board of the same or a
+ * smaller size, or another rule seen before, creates no OpenCL objects and
+ * compiles nothing. Boards are row-major, one byte per cell with 0 = dead,
+ * 1 = alive (and the dying states 2 .. states - 1 of Generations rules);
+ * rules are tables from gol_rule_parse (see gol_rule.h). The bit-packed
+ * layouts are packed and unpacked by gol_load and gol_read.
+ *
+ * An engine is not thread-safe; use one per thread.
+ *
+ * Return codes:
+ *   0   = success
+ *  -1   = no OpenCL GPU or CPU device
+ *  -2   = an OpenCL call failed
+ *  -3   = kernel source load or program build failed
+ *  -4   = invalid argument, or no board loaded yet
+ *  -5   = host allocation failed
+ * gol_engine_message describes the last failure in more detail.
+ */
+
+#define GOL_ENGINE_OK 0
+#define GOL_ENGINE_ENODEV -1
+#define GOL_ENGINE_ECL -2
+#define GOL_ENGINE_EBUILD -3
+#define GOL_ENGINE_EARG -4
+#define GOL_ENGINE_ENOMEM -5
+
+#define GOL_ENGINE_PROGRAMS 8
+
+typedef struct GolEngine GolEngine;
+
+typedef struct GolEngineConfig {
+    const char* kernel_dir;   // NULL uses the kernels embedded in the library
+    const char* cache_dir;    // program binary cache directory, NULL for none
+    int tiled;                // 1 = local-memory tiled step kernel, 0 = naive
+    int lx;                   // work-group size; 0 means 16
+    int ly;
+    int packed;               // 1 = bit-packed Life-like kernel, 64 cells per work-item (not tiled)
+    int steps_per_launch;     // generations per launch of the tiled kernel; 0 means 1
+    int states;               // > 2 runs Generations rules on their packed kernel; 0 means 2
+    int sparse;               // 1 = only compute the tiles next to last generation's changes (naive layout)
+    int stats_slots;          // > 0 reduces population, changes and hash of each generation into a ring of slots
+    int batch;                // 1 = queue all launches of gol_step_n and wait once; 0 waits for each launch
+    int zero_copy;            // 1 = boards live in page-aligned host memory that is mapped instead of copied
+    int profile;              // 1 = profiling queue; gol_engine_profile reports the last calls
+    GolTrace* trace;          // a profiling engine records its commands here when not NULL
+} GolEngineConfig;
+
+// Profiled device time of the last gol_load, gol_step_n and gol_read (profile = 1).
+typedef struct GolEngineProfile {
+    uint64_t load_ns;         // upload, device copy or mapping of the board, with the sparse buffer copy
+    uint64_t step_ns;         // every kernel of the last gol_step_n
+    uint64_t read_ns;         // download or mapping of the board
+    const uint64_t* launch_ns; // kernel time of each launch (each generation for sparse), valid until the next call
+    int launches;
+    uint64_t active_tiles;    // sparse: tiles computed over all generations of the last gol_step_n
+    int tiles;                // sparse: tiles of the board
+} GolEngineProfile;
+
+// Select a device and create the context and queue, then apply config (NULL uses the defaults).
+// Returns NULL on failure, with the reason in *error when error is not NULL.
+GolEngine* gol_engine_create(const GolEngineConfig* config, int* error);
+
+// Release every OpenCL object of the engine.
+void gol_engine_destroy(GolEngine* engine);
+
+// Name of the device the engine runs on.
+const char* gol_engine_device_name(const GolEngine* engine);
+
+// Switch the kernel variant and launch settings; kernel_dir, cache_dir and profile stay as created.
+// The loaded board is dropped, while built programs and buffers are kept for later loads.
+int gol_engine_configure(GolEngine* engine, const GolEngineConfig* config);
+
+// Build the step program of a rule and size the buffers for a rows x cols board, so the next
+// gol_load of that size neither compiles nor allocates. Checks the work-group against the kernel.
+int gol_engine_prepare(GolEngine* engine, int rows, int cols, uint32_t rule);
+
+// Upload a rows x cols board and make it generation 0 of a new simulation.
+int gol_load(GolEngine* engine, const unsigned char* grid, int rows, int cols, int wrap, uint32_t rule);
+
+// Like gol_load, from a device buffer of the engine's context that already holds the board in the
+// layout of the configured kernel.
+int gol_load_buffer(GolEngine* engine, cl_mem board, int rows, int cols, int wrap, uint32_t rule);
+
+// Advance the loaded board by n generations; returns once they are done.
+int gol_step_n(GolEngine* engine, int n);
+
+// Copy the current board into grid, which must hold rows * cols bytes.
+int gol_read(GolEngine* engine, unsigned char* grid);
+
+// Generations computed since the last gol_load.
+uint64_t gol_generation(const GolEngine* engine);
+
+// Copy statistics slots [0, n) into words (GOL_STATS_WORDS each, see gol_stats.h) and zero them.
+// Generation g of a load is reduced into slot g % stats_slots.
+int gol_engine_read_stats(GolEngine* engine, uint32_t* words, int n);
+
+// Timings and sparse tile counts of the last calls.
+void gol_engine_profile(const GolEngine* engine, GolEngineProfile* profile);
+
+// Program builds since the engine was created, for reports.
+const GolBuildStats* gol_engine_build_stats(const GolEngine* engine);
+
+// Detail of the last failed call, or an empty string.
+const char* gol_engine_message(const GolEngine* engine);
+
+// The engine's OpenCL objects, for callers that enqueue their own commands next to the simulation
+// (checkpoints, frames, probes). The board buffer holds the current generation until the next step.
+cl_device_id gol_engine_device(const GolEngine* engine);
+cl_context gol_engine_context(const GolEngine* engine);
+cl_command_queue gol_engine_queue(const GolEngine* engine);
+cl_mem gol_engine_board(const GolEngine* engine);
+
+// Short description of a return code.
+const char* gol_engine_error_string(int code);
+
+#endif
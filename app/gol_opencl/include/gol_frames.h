@@ -0,0 +1,60 @@
+#ifndef GOL_FRAMES_H
+#define GOL_FRAMES_H
+
+#include "gol_cl.h"
+
+#include <stdint.h>
+#include <stdio.h>
+
+/*
+ * Downsampled density frames of a running GPU simulation
+ * (kernels/gol_frame.cl), written as binary PGM files or as one PGM
+ * stream on stdout. Byte-per-cell and bit-packed Life-like boards are
+ * supported; each pixel is the live fraction of a scale x scale block.
+ */
+
+#define GOL_FRAME_SLOTS 4
+#define GOL_FRAME_MAX_SIDE 1024
+
+// One downsampled frame in flight: the device image and the host copy it is read into.
+typedef struct GolFrameSlot {
+    cl_mem image;
+    unsigned char* host;
+    cl_event ready;       // completion of the non-blocking read
+    uint64_t generation;
+    int pending;          // 1 while the read is outstanding or the frame is not written yet
+} GolFrameSlot;
+
+// Density frames: a small kernel downsamples the board on the device and only
+// the image is read back, without blocking; a slot is written out when the ring comes back to it.
+typedef struct GolFrameStream {
+    cl_program program;
+    cl_kernel kernel;
+    GolFrameSlot slots[GOL_FRAME_SLOTS];
+    int fill;
+    int rows;
+    int cols;
+    int scale;
+    int frame_rows;
+    int frame_cols;
+    size_t global[2];
+    const char* prefix;   // "<prefix>_<generation>.pgm" files, or NULL for stdout
+    FILE* pipe;           // binary PGM stream on the original stdout
+    int written;
+    int failed;
+} GolFrameStream;
+
+// Build the frame kernel and allocate the slots; out is a file prefix or "-" for stdout.
+// With stdout the report lines are moved to stderr, so stdout carries nothing but frames.
+int gol_frames_start(GolFrameStream* fs, cl_context context, cl_device_id device,
+                     const char* kernel_dir, const char* kernel_cache,
+                     int rows, int cols, int packed, int words_per_row, int scale, const char* out);
+
+// Downsample board after the commands already queued and start reading the image back.
+// Only waits when the oldest slot is still pending, and then only for that frame.
+void gol_frames_enqueue(GolFrameStream* fs, cl_command_queue queue, cl_mem board, uint64_t generation);
+
+// Write the frames still in flight in generation order and release everything.
+void gol_frames_finish(GolFrameStream* fs);
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef GOL_GENERATIONS_H
+#define GOL_GENERATIONS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Packed board layout for Generations rules (see gol_rule.h).
+ * A cell takes gol_gens_bits_per_cell(states) bits: 2 bits for up to 4
+ * states, 4 bits for up to 16, one byte otherwise. Every row holds
+ * gol_gens_words_per_row(cols, bits) 32-bit words; cell y of a row is
+ * field y % (32 / bits) of word y / (32 / bits), field 0 in the low bits.
+ * Padding cells after the last column are always zero (dead).
+ *
+ * The layout and the per-word update below are shared with the
+ * gol_step_generations kernel in kernels/gol_generations.cl.
+ */
+
+// Bits per cell for a state count: 2, 4 or 8.
+int gol_gens_bits_per_cell(int states);
+
+// Number of 32-bit words needed to store one packed row.
+size_t gol_gens_words_per_row(int cols, int bits);
+
+// Pack a row-major grid with one state per byte into the packed layout.
+void gol_gens_pack(const unsigned char* grid, uint32_t* packed, int rows, int cols, int bits);
+
+// Unpack the packed layout back into one state per byte.
+void gol_gens_unpack(const uint32_t* packed, unsigned char* grid, int rows, int cols, int bits);
+
+// Compute one generation of the packed board on the CPU, one 32-bit word at a time.
+void gol_gens_step(const uint32_t* in, uint32_t* out, int rows, int cols, int wrap,
+                   uint32_t rule, int states);
+
+#endif
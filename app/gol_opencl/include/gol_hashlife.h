@@ -0,0 +1,37 @@
+#ifndef GOL_HASHLIFE_H
+#define GOL_HASHLIFE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * HashLife engine for very long runs on a toroidal (wrap = 1) board.
+ *
+ * The board is treated as one period of an infinite periodic pattern.
+ * Every jump builds a hash-consed quadtree of that pattern, asks the
+ * memoized RESULT (successor) function for the center advanced by 2^j
+ * generations and copies one period back into the row-major grid.
+ * Identical sub-squares share one node, so power-of-two boards and
+ * periodic patterns advance in far less than one step per generation.
+ */
+
+typedef struct GolHashlife GolHashlife;
+
+// Create an empty engine for one rule table (see gol_rule.h; the memoized results
+// are only valid for that rule). Returns NULL on allocation failure.
+GolHashlife* gol_hashlife_create(uint32_t rule);
+
+// Free all nodes and caches of the engine.
+void gol_hashlife_destroy(GolHashlife* hl);
+
+/*
+ * Advance a rows x cols toroidal grid (one 0/1 byte per cell, row-major)
+ * by the given number of generations in place.
+ * Returns 0 on success, -1 on allocation failure (grid is then unspecified).
+ */
+int gol_hashlife_run(GolHashlife* hl, unsigned char* grid, int rows, int cols, uint64_t generations);
+
+// Number of canonical nodes currently stored in the arena.
+size_t gol_hashlife_node_count(const GolHashlife* hl);
+
+#endif
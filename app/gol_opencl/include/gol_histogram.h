@@ -0,0 +1,37 @@
+#ifndef GOL_HISTOGRAM_H
+#define GOL_HISTOGRAM_H
+
+#include <stdint.h>
+
+/*
+ * Fixed-size log-bucket (HDR-style) histogram of nanosecond durations.
+ *
+ * Values below 2^GOL_HIST_SUB_BITS get one bucket each; every larger power
+ * of two is split into 2^GOL_HIST_SUB_BITS linear sub-buckets, so a recorded
+ * value is kept with a relative error below 1 / 2^GOL_HIST_SUB_BITS (~3%).
+ * All buckets live inside the struct: recording never allocates and costs a
+ * bit scan and an increment, so it can sit in the launch loop.
+ */
+
+#define GOL_HIST_SUB_BITS 5
+#define GOL_HIST_SUB_COUNT (1u << GOL_HIST_SUB_BITS)
+#define GOL_HIST_BUCKETS (GOL_HIST_SUB_COUNT * (64u - GOL_HIST_SUB_BITS + 1u))
+
+typedef struct GolHistogram {
+    uint64_t counts[GOL_HIST_BUCKETS];
+    uint64_t total;
+    uint64_t min;
+    uint64_t max;
+} GolHistogram;
+
+// Clear all counts.
+void gol_hist_reset(GolHistogram* h);
+
+// Add count occurrences of one value.
+void gol_hist_record(GolHistogram* h, uint64_t value, uint64_t count);
+
+// Value at quantile q in [0, 1]: the upper edge of the bucket holding it, clamped
+// to the exact min and max. 0 when the histogram is empty.
+uint64_t gol_hist_quantile(const GolHistogram* h, double q);
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef GOL_MAPPED_H
+#define GOL_MAPPED_H
+
+#include <stddef.h>
+
+/*
+ * A file mapped read/write into the address space, used to keep boards
+ * that do not fit into RAM. The operating system pages rows in and out
+ * on demand, so only the bands currently being streamed stay resident.
+ */
+typedef struct GolMappedFile {
+    unsigned char* data;
+    size_t size;
+#ifdef _WIN32
+    void* file;
+    void* mapping;
+#else
+    int fd;
+#endif
+} GolMappedFile;
+
+/*
+ * Create (or resize) the file at path to size bytes and map it.
+ * A NULL path maps an anonymous temporary file that is deleted on close.
+ * Returns 0 on success, -1 on failure (errno / GetLastError describe it).
+ */
+int gol_map_file(GolMappedFile* m, const char* path, size_t size);
+
+/*
+ * Map an existing file copy-on-write with its full size: writes through the
+ * mapping stay private and never reach the file.
+ * Returns 0 on success, -1 on failure.
+ */
+int gol_map_file_private(GolMappedFile* m, const char* path);
+
+// Hint that the mapping will be read front to back.
+void gol_map_advise_sequential(GolMappedFile* m);
+
+// Flush and unmap the file and close its handle.
+void gol_unmap_file(GolMappedFile* m);
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef GOL_MULTI_H
+#define GOL_MULTI_H
+
+#include "gol_cl.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Multi-device engine: the board is split into horizontal strips, one per
+ * OpenCL device (or sub-device of one partitioned device). Every generation
+ * computes the edge rows of each strip first and exchanges them through host
+ * memory while the interior rows are computed (kernels/gol_strip.cl).
+ * OpenCL failures end the program, like the other engines of the front end.
+ */
+
+#define GOL_MULTI_MAX_DEVICES 16
+
+// Timing summary of a multi-device run, averaged over the measured runs.
+typedef struct GolMultiStats {
+    int n_devices;
+    double h2d_ms;
+    double kernel_ms[GOL_MULTI_MAX_DEVICES];
+    double halo_ms;
+    double d2h_ms;
+    double wall_total_ms;
+    GolBuildStats build;
+} GolMultiStats;
+
+/*
+ * Run iters generations of a rows x cols board on `wanted` devices, repeat measured
+ * runs after warmup ones, and write the final board of the last run into result.
+ * split asks for sub-devices of one device even when there are enough root devices.
+ */
+void gol_multi_run(const unsigned char* initial,
+                   unsigned char* result,
+                   int rows,
+                   int cols,
+                   int iters,
+                   int wrap,
+                   uint32_t rule,
+                   int wanted,
+                   int split,
+                   size_t lx,
+                   size_t ly,
+                   int repeat,
+                   int warmup,
+                   const char* kernel_dir,
+                   const char* kernel_cache,
+                   GolMultiStats* stats);
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef GOL_PATTERN_H
+#define GOL_PATTERN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "gol_mapped.h"
+
+/*
+ * Pattern files for the initial and final board.
+ *   - RLE (.rle): run-length encoded, "x = .., y = .." header
+ *   - Life 1.06 (.lif, .life): "#Life 1.06" then one "x y" line per live cell
+ *   - plaintext (.cells, .txt): '.' dead, 'O' alive, '!' comment lines
+ *   - snapshot (anything else): GolSnapshotHeader padded to
+ *     GOL_SNAPSHOT_HEADER_BYTES, then rows * cols bytes of 0/1 cells,
+ *     so the cells start page aligned and can be mapped straight into
+ *     an OpenCL buffer.
+ * Text formats are parsed and written as a stream, so no intermediate
+ * copy of the board is built. Patterns smaller than the board are centered.
+ *
+ * Return codes:
+ *   0   = success
+ *  -1   = file open / read / write error
+ *  -2   = malformed file
+ *  -3   = pattern larger than the board
+ *  -4   = invalid argument
+ */
+
+typedef enum GolPatternFormat {
+    GOL_FORMAT_UNKNOWN = 0,
+    GOL_FORMAT_RLE,
+    GOL_FORMAT_LIFE106,
+    GOL_FORMAT_PLAINTEXT,
+    GOL_FORMAT_SNAPSHOT
+} GolPatternFormat;
+
+#define GOL_SNAPSHOT_MAGIC "GOLSNAP1"
+#define GOL_SNAPSHOT_HEADER_BYTES 4096u
+
+typedef struct GolSnapshotHeader {
+    char magic[8];          // GOL_SNAPSHOT_MAGIC, not null-terminated
+    uint32_t header_bytes;  // offset of the first cell
+    uint32_t wrap;
+    uint64_t rows;
+    uint64_t cols;
+    uint64_t generation;    // generations simulated since the seeded or loaded start
+    uint64_t seed;
+    char rule[32];          // null-terminated rule string, e.g. "B3/S23"
+} GolSnapshotHeader;
+
+// Printable name of a format.
+const char* gol_pattern_format_name(GolPatternFormat format);
+
+// Format to write for a file name, chosen by its extension (snapshot when unknown).
+GolPatternFormat gol_pattern_format_for_path(const char* path);
+
+// Detect the format of an existing file from its first bytes.
+GolPatternFormat gol_pattern_detect(const char* path);
+
+// Read the pattern extent. If header is not NULL it receives the snapshot header,
+// or for RLE files only the rule given in the "x = .." line (empty when absent).
+int gol_pattern_probe(const char* path, GolPatternFormat format, int* rows, int* cols, GolSnapshotHeader* header);
+
+// Clear the board and place the pattern at its center.
+int gol_pattern_load(const char* path, GolPatternFormat format, unsigned char* grid, int rows, int cols);
+
+// Fill the initial board: the pattern in path, or when path is NULL a random board
+// with the given live-cell fraction from gol_random_fill (gol_random.h) on every processor.
+int gol_board_init(unsigned char* grid, int rows, int cols, unsigned int seed, double density,
+                   const char* path, GolPatternFormat format);
+
+// Write the board; meta fills the snapshot header (generation, seed, wrap, rule) and may be NULL.
+int gol_pattern_save(const char* path, GolPatternFormat format,
+                     const unsigned char* grid, int rows, int cols,
+                     const GolSnapshotHeader* meta);
+
+// Map a snapshot copy-on-write and return its header and a pointer to the page-aligned cells.
+int gol_snapshot_map(GolMappedFile* m, const char* path, GolSnapshotHeader* header, unsigned char** cells);
+
+// Human-readable text for a return code.
+const char* gol_pattern_error_string(int code);
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef GOL_PERF_H
+#define GOL_PERF_H
+
+/*
+ * Hardware performance counters around a measured region (Linux perf_event_open).
+ *
+ * One counter group of cycles, instructions, last-level cache misses and
+ * branch misses, counted in user and kernel space for the calling thread.
+ * With inherit set, threads created after gol_perf_open are counted as well,
+ * which covers the worker threads of an OpenCL CPU runtime when the group is
+ * opened before the context.
+ *
+ * Counts of every start/stop interval are added up. If the kernel multiplexes
+ * the group, each interval is scaled by time enabled / time running. A counter
+ * the CPU or the perf_event_paranoid setting does not allow stays unavailable;
+ * on other systems gol_perf_open opens nothing.
+ */
+
+#include <stdint.h>
+
+enum {
+    GOL_PERF_CYCLES,
+    GOL_PERF_INSTRUCTIONS,
+    GOL_PERF_LLC_MISSES,
+    GOL_PERF_BRANCH_MISSES,
+    GOL_PERF_COUNTERS
+};
+
+// Bytes moved to or from memory per last-level cache miss, used for the bandwidth estimate.
+#define GOL_PERF_LINE_BYTES 64
+
+typedef struct GolPerf {
+    int fd[GOL_PERF_COUNTERS];          // -1 when not open
+    int available[GOL_PERF_COUNTERS];   // opened by gol_perf_open, kept after gol_perf_close
+    double value[GOL_PERF_COUNTERS];    // scaled sum over all intervals
+    int intervals;                      // start/stop pairs counted so far
+} GolPerf;
+
+// Open the counter group. Returns the number of counters available, 0 when none are.
+int gol_perf_open(GolPerf* p, int inherit);
+
+// Count from here until gol_perf_stop.
+void gol_perf_start(GolPerf* p);
+void gol_perf_stop(GolPerf* p);
+
+// 1 when the counter was opened; values stay readable after gol_perf_close.
+int gol_perf_has(const GolPerf* p, int counter);
+
+// Close all counters.
+void gol_perf_close(GolPerf* p);
+
+// Short counter name for reports.
+const char* gol_perf_name(int counter);
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef GOL_PROGRAM_CACHE_H
+#define GOL_PROGRAM_CACHE_H
+
+#include <stdint.h>
+
+#define CL_TARGET_OPENCL_VERSION 220
+#include <CL/cl.h>
+
+/*
+ * On-disk cache of built OpenCL program binaries, so repeated runs skip the
+ * source compile in clBuildProgram.
+ *
+ * The key is a 64-bit FNV-1a hash of the device name, device version, driver
+ * version, kernel source and build options: a driver update, an edited kernel
+ * or another rule table all miss instead of loading a stale binary. Each entry
+ * is one file "<dir>/<key>.bin" holding a small header (magic, key, size)
+ * followed by the CL_PROGRAM_BINARIES blob of a single-device program.
+ */
+
+// Cache key of one program build.
+uint64_t gol_program_cache_key(cl_device_id device, const char* source, const char* options);
+
+// Create and build the program from a cached binary.
+// Returns NULL on a miss or when the runtime rejects the binary.
+cl_program gol_program_cache_load(const char* dir, uint64_t key,
+                                  cl_context context, cl_device_id device, const char* options);
+
+// Store the binary of a built program, creating dir if needed.
+// Returns 0 on success, -1 on error.
+int gol_program_cache_store(const char* dir, uint64_t key, cl_program program);
+
+#endif
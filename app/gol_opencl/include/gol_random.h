@@ -0,0 +1,28 @@
+#ifndef GOL_RANDOM_H
+#define GOL_RANDOM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Counter-based random boards.
+ *
+ * Cell i is alive when the high 32 bits of splitmix64(key + i * GOL_RANDOM_GAMMA)
+ * are below density * 2^32, with key = splitmix64(seed). A cell depends only on
+ * the seed and its index, so the board does not depend on how many threads or
+ * work-items generate it, and kernels/gol_random.cl computes the same bits on
+ * the device.
+ */
+
+#define GOL_RANDOM_GAMMA 0x9E3779B97F4A7C15ull
+
+// Per-seed key added to every cell counter.
+uint64_t gol_random_key(unsigned int seed);
+
+// Density in [0, 1] as a threshold on the high 32 bits of a cell's hash.
+uint64_t gol_random_threshold(double density);
+
+// Fill n cells with 0/1 states; threads <= 0 uses every logical processor.
+void gol_random_fill(unsigned char* grid, size_t n, unsigned int seed, double density, int threads);
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef GOL_RULE_H
+#define GOL_RULE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Life-like (outer totalistic) rules in B/S notation, e.g. "B3/S23".
+ *
+ * A rule is stored as one 18-bit lookup table: bit n is the next state of
+ * a dead cell with n live neighbors (birth), bit 9 + n the next state of a
+ * live cell with n live neighbors (survival). The next state of any cell
+ * is then the branch-free (table >> (sum + 9 * alive)) & 1.
+ *
+ * The OpenCL kernels get the table as -DGOL_RULE_TABLE=... at build time,
+ * so it is a compile-time constant inside the step loops.
+ *
+ * "Generations" rules add a state count C > 2 ("B2/S/C3" for Brian's Brain):
+ * state 1 is alive, a live cell that does not survive enters state 2, and
+ * states 2..C-1 age by one per generation until they return to 0 (dead).
+ * Only state 1 counts as a live neighbor. C = 2 is the plain Life-like case.
+ *
+ * Rules with B0 are rejected: every engine relies on empty space (padding,
+ * board edges without wrap, inactive tiles, empty HashLife nodes) staying empty.
+ */
+
+#define GOL_RULE_CONWAY 0x1808u   // B3/S23
+#define GOL_RULE_MAX_STATES 256
+
+// Parse "B36/S23", "b36/s23", the older "23/36" (S/B) form, a Generations rule
+// "B2/S/C3" or "/2/3" (S/B/C), or one of the names conway, highlife, daynight,
+// seeds, briansbrain, starwars. states receives C (2 for Life-like rules).
+// Returns 0 on success, -1 if malformed, -2 for B0 rules.
+int gol_rule_parse(const char* text, uint32_t* table, int* states);
+
+// Write the canonical "B.../S..." form (with "/C<states>" for Generations rules) into buf.
+void gol_rule_format(uint32_t table, int states, char* buf, size_t size);
+
+// Write the OpenCL build options that bake the table (and the state count) into a kernel.
+void gol_rule_build_options(uint32_t table, int states, char* buf, size_t size);
+
+// Next state of one two-state cell.
+static inline unsigned char gol_rule_next(uint32_t table, int alive, int sum) {
+    return (unsigned char)((table >> (sum + 9 * alive)) & 1u);
+}
+
+// Next state of one cell of a Generations rule; sum counts neighbors in state 1.
+static inline unsigned char gol_rule_next_state(uint32_t table, int states, int state, int sum) {
+    if (state == 0) return gol_rule_next(table, 0, sum);
+    if (state == 1) return gol_rule_next(table, 1, sum) ? 1u : (unsigned char)(states > 2 ? 2 : 0);
+    return (unsigned char)(state + 1 < states ? state + 1 : 0);
+}
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef GOL_STATS_H
+#define GOL_STATS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Per-generation board statistics computed by the -D GOL_STATS step kernels
+ * (kernels/gol_stats.cl), and the early-stop checks built on them.
+ *
+ * The device writes GOL_STATS_WORDS uints per generation: population, changed
+ * cells and the two halves of a Zobrist hash, the XOR of a splitmix64-mixed
+ * key of every live cell index. gol_stats_board computes the same values on
+ * the host, so a device reduction can be checked against a board read back.
+ */
+
+#define GOL_STATS_WORDS 4
+
+typedef struct GolGenStats {
+    uint32_t population;
+    uint32_t changed;    // cells that differ from the previous generation
+    uint64_t hash;
+} GolGenStats;
+
+// Unpack n generations of device words.
+void gol_stats_decode(const uint32_t* words, int n, GolGenStats* out);
+
+// Population and hash of a byte-per-cell board; changed is left 0.
+GolGenStats gol_stats_board(const unsigned char* grid, size_t n);
+
+/*
+ * First generation in [from, to) at which the run can stop: with stable set
+ * when nothing changed or everything died, with period > 0 when the board
+ * equals the one period generations earlier (same hash and population).
+ * Returns -1 when none does; *reason is set to a short description otherwise.
+ */
+int gol_stats_find_stop(const GolGenStats* gens, int from, int to, int stable, int period, const char** reason);
+
+/*
+ * Rolling statistics of one run, for runs too long to keep every generation:
+ * the chunk of generations read from the device last, behind the keep
+ * generations before it that the stop checks look back on (the period, or
+ * one). gens[keep .. keep + count) is the chunk pushed last.
+ */
+typedef struct GolStatsHistory {
+    GolGenStats* gens;
+    int keep;
+    int chunk;
+    int kept;    // valid generations in front of the chunk, fewer than keep early in a run
+    int count;
+    int total;   // generations pushed since the last reset
+} GolStatsHistory;
+
+// Allocate room for chunks of up to chunk generations; returns 0, or -1 when allocation fails.
+int gol_stats_history_init(GolStatsHistory* h, int chunk, int period);
+
+// Start a new run.
+void gol_stats_history_reset(GolStatsHistory* h);
+
+// Decode the next n <= chunk generations of device words and run the stop checks on them.
+// Returns the generation of the run (0-based) to stop at, or -1 as gol_stats_find_stop does.
+int gol_stats_history_push(GolStatsHistory* h, const uint32_t* words, int n, int stable, int period,
+                           const char** reason);
+
+// Statistics of the newest generation pushed.
+const GolGenStats* gol_stats_history_last(const GolStatsHistory* h);
+
+void gol_stats_history_free(GolStatsHistory* h);
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef GOL_STREAM_H
+#define GOL_STREAM_H
+
+#include "gol_cl.h"
+#include "gol_mapped.h"
+#include "gol_pattern.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Out-of-core engine for boards larger than device memory (and, through a
+ * memory-mapped board file from gol_mapped.h, larger than RAM). The board
+ * is streamed through the device in horizontal bands with a halo of
+ * band_steps rows on each side, so every upload advances band_steps
+ * generations (kernels/gol_stream.cl). OpenCL failures end the program,
+ * like the other engines of the front end.
+ */
+
+// Timing summary of a streamed run, averaged over the measured runs.
+typedef struct GolStreamStats {
+    int band_rows;
+    int n_bands;
+    int passes;
+    double h2d_ms;
+    double kernel_ms;
+    double d2h_ms;
+    double wall_total_ms;
+    GolBuildStats build;
+} GolStreamStats;
+
+/*
+ * Run iters generations of the board in the mapped file; every run starts from the
+ * board gol_board_init makes from seed, density and load_path. band_rows 0 sizes
+ * the bands to about half of the device memory. The file holds the final board of
+ * the last run.
+ */
+void gol_stream_run(GolMappedFile* board,
+                    int rows,
+                    int cols,
+                    int iters,
+                    int wrap,
+                    uint32_t rule,
+                    unsigned int seed,
+                    double density,
+                    const char* load_path,
+                    GolPatternFormat load_format,
+                    int band_rows,
+                    int band_steps,
+                    size_t lx,
+                    size_t ly,
+                    int repeat,
+                    int warmup,
+                    const char* kernel_dir,
+                    const char* kernel_cache,
+                    GolStreamStats* stats);
+
+#endif
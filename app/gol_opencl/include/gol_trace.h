@@ -0,0 +1,38 @@
+#ifndef GOL_TRACE_H
+#define GOL_TRACE_H
+
+#define CL_TARGET_OPENCL_VERSION 220
+#include <CL/cl.h>
+
+/*
+ * Chrome trace (chrome://tracing, Perfetto) export of one run.
+ *
+ * Host phases are recorded with host timestamps in milliseconds; OpenCL
+ * commands with their queued, submit, start and end profiling times, which
+ * gol_trace_sync_device maps onto the host clock through one marker command.
+ * Records are kept in memory and the JSON is written by gol_trace_close, so
+ * recording only appends to an array.
+ *
+ * Each command appears twice: as its execution (start..end) on the
+ * "execution" track and as its wait (queued..start) on the "queued" track,
+ * so launch gaps and host stalls show up as holes between the spans.
+ */
+
+typedef struct GolTrace GolTrace;
+
+// Start a trace; origin_ms (host clock) becomes time 0. Returns NULL on allocation failure.
+GolTrace* gol_trace_open(const char* path, double origin_ms);
+
+// Align the device clock of queue with the host clock; host_ms is read right before the call.
+void gol_trace_sync_device(GolTrace* t, cl_command_queue queue, double host_ms);
+
+// Record a host phase. name must stay valid until gol_trace_close.
+void gol_trace_host(GolTrace* t, const char* name, double start_ms, double end_ms);
+
+// Record a finished OpenCL command. name and category must stay valid until gol_trace_close.
+void gol_trace_command(GolTrace* t, const char* name, const char* category, cl_event ev);
+
+// Write the JSON file and free the trace. Returns 0 on success, -1 on write error.
+int gol_trace_close(GolTrace* t);
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef GOL_TUNING_H
+#define GOL_TUNING_H
+
+/*
+ * Tuning database written by --autotune and read by later gpu runs.
+ *
+ * A plain text file with one tab-separated line per device and board:
+ *   device  driver  rows  cols  wrap  lx  ly  tiled  packed  steps  ms_per_gen
+ * Lines starting with '#' are comments. Storing a result replaces the line
+ * with the same device, driver, rows, cols and wrap.
+ *
+ * Return codes:
+ *   1   = entry found (lookup only)
+ *   0   = success / no entry
+ *  -1   = file open / read / write error
+ */
+
+typedef struct GolTuning {
+    int lx;
+    int ly;
+    int tiled;
+    int packed;
+    int steps_per_launch;
+    double ms_per_gen;   // profiled kernel time per generation of the winning configuration
+} GolTuning;
+
+// Find the tuned configuration of a device and board. A missing file is no entry.
+int gol_tuning_lookup(const char* path, const char* device, const char* driver,
+                      int rows, int cols, int wrap, GolTuning* out);
+
+// Add or replace the tuned configuration of a device and board.
+int gol_tuning_store(const char* path, const char* device, const char* driver,
+                     int rows, int cols, int wrap, const GolTuning* tuning);
+
+#endif
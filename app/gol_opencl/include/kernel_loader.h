@@ -17,4 +17,25 @@
  */
 char* load_kernel_source(const char* path, int* error_code);
 
+/*
+ * Kernel sources compiled into the executable. The Makefile generates the
+ * table from the .cl files in kernels/; it ends with a { NULL, NULL } entry.
+ */
+typedef struct EmbeddedKernel {
+    const char* name;    // file name, e.g. "gol_naive.cl"
+    const char* source;
+} EmbeddedKernel;
+
+extern const EmbeddedKernel embedded_kernels[];
+
+/*
+ * Returns the source of the named kernel file in a heap buffer (free with free()).
+ * With kernel_dir NULL the embedded copy is used, so no file is read;
+ * otherwise "<kernel_dir>/<name>" is loaded with load_kernel_source.
+ *
+ * error_code: as load_kernel_source, plus
+ *  -6   = no embedded kernel with that name
+ */
+char* load_kernel(const char* name, const char* kernel_dir, int* error_code);
+
 #endif
@@ -0,0 +1,8 @@
+// STREAM-style copy used by --roofline to measure the global memory bandwidth the
+// device sustains: every work-item moves one 16-byte vector, with no reuse.
+__kernel void gol_copy(__global const uint4* src,
+                       __global uint4* dst)
+{
+    const size_t i = get_global_id(0);
+    dst[i] = src[i];
+}
@@ -0,0 +1,55 @@
+// Downsampled density image for --frames-every: one work-item per pixel, holding the
+// live fraction of a scale x scale block of cells as 0..255. Blocks on the right and
+// bottom edge may be smaller and are averaged over the cells they actually cover.
+
+// Byte-per-cell boards (naive, tiled and sparse kernels).
+__kernel void gol_frame(__global const uchar* grid,
+                        __global uchar* frame,
+                        const int rows,
+                        const int cols,
+                        const int scale,
+                        const int frame_rows,
+                        const int frame_cols)
+{
+    const int fr = (int)get_global_id(0);
+    const int fc = (int)get_global_id(1);
+    if (fr >= frame_rows || fc >= frame_cols) return;
+
+    const int r0 = fr * scale;
+    const int c0 = fc * scale;
+    const int r1 = min(r0 + scale, rows);
+    const int c1 = min(c0 + scale, cols);
+    int live = 0;
+    for (int r = r0; r < r1; ++r) {
+        for (int c = c0; c < c1; ++c) live += grid[r * cols + c] != 0;
+    }
+    const int area = (r1 - r0) * (c1 - c0);
+    frame[fr * frame_cols + fc] = (uchar)((live * 255 + area / 2) / area);
+}
+
+// Bit-packed boards: bit j of word w in a row is the cell in column w * 64 + j.
+__kernel void gol_frame_packed(__global const ulong* grid,
+                               __global uchar* frame,
+                               const int rows,
+                               const int cols,
+                               const int scale,
+                               const int frame_rows,
+                               const int frame_cols,
+                               const int words_per_row)
+{
+    const int fr = (int)get_global_id(0);
+    const int fc = (int)get_global_id(1);
+    if (fr >= frame_rows || fc >= frame_cols) return;
+
+    const int r0 = fr * scale;
+    const int c0 = fc * scale;
+    const int r1 = min(r0 + scale, rows);
+    const int c1 = min(c0 + scale, cols);
+    int live = 0;
+    for (int r = r0; r < r1; ++r) {
+        __global const ulong* row = grid + (size_t)r * words_per_row;
+        for (int c = c0; c < c1; ++c) live += (int)((row[c >> 6] >> (c & 63)) & 1ul);
+    }
+    const int area = (r1 - r0) * (c1 - c0);
+    frame[fr * frame_cols + fc] = (uchar)((live * 255 + area / 2) / area);
+}
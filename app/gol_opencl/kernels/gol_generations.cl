@@ -0,0 +1,99 @@
+// Generations rules on a packed board: state 0 is dead, 1 alive, and a live cell that
+// does not survive ages through states 2 .. GOL_STATES - 1 back to 0. Only state 1
+// counts as a live neighbor. Each row is stored as 32-bit words of GOL_BITS-bit cells,
+// cell y in field y % CPW of word y / CPW; padding cells after the last column stay 0.
+// The layout matches gol_generations.h, whose CPU step mirrors this kernel.
+
+// Rule lookup table and state count, baked in at build time with -D (see gol_rule.h).
+#ifndef GOL_RULE_TABLE
+#define GOL_RULE_TABLE 0x00004u
+#endif
+#ifndef GOL_STATES
+#define GOL_STATES 3
+#endif
+
+#if GOL_STATES <= 4
+#define GOL_BITS 2
+#elif GOL_STATES <= 16
+#define GOL_BITS 4
+#else
+#define GOL_BITS 8
+#endif
+#define CPW (32 / GOL_BITS)
+#define CELL_MASK ((1u << GOL_BITS) - 1u)
+
+// Gather one flag per cell of a word, bit i set when cell i is alive (state 1).
+static inline uint alive_bits(uint word) {
+#if GOL_BITS == 2
+    uint x = word & ~(word >> 1) & 0x55555555u;
+    x = (x | (x >> 1)) & 0x33333333u;
+    x = (x | (x >> 2)) & 0x0F0F0F0Fu;
+    x = (x | (x >> 4)) & 0x00FF00FFu;
+    return (x | (x >> 8)) & 0x0000FFFFu;
+#elif GOL_BITS == 4
+    uint x = word & ~(word >> 1) & ~(word >> 2) & ~(word >> 3) & 0x11111111u;
+    x = (x | (x >> 3)) & 0x03030303u;
+    x = (x | (x >> 6)) & 0x000F000Fu;
+    return (x | (x >> 12)) & 0x000000FFu;
+#else
+    uint x = 0;
+    for (int i = 0; i < 4; ++i) x |= (uint)(((word >> (8 * i)) & 0xFFu) == 1u) << i;
+    return x;
+#endif
+}
+
+// Alive flags of word w of row x plus one neighbor column on each side: bit 0 is the
+// column left of the word, bit i + 1 is cell i, and the bit after the last real cell
+// is the column right of it. Rows outside the board are dead or wrapped.
+static inline uint row_window(__global const uint* grid, int x, int w, int rows, int cols, int wpr, int wrap) {
+    if (x < 0 || x >= rows) {
+        if (!wrap) return 0u;
+        x = (x < 0) ? x + rows : x - rows;
+    }
+    __global const uint* row = grid + x * wpr;
+
+    uint win = alive_bits(row[w]) << 1;
+    if (w > 0) {
+        win |= (alive_bits(row[w - 1]) >> (CPW - 1)) & 1u;
+    } else if (wrap) {
+        const int c = cols - 1;
+        win |= (alive_bits(row[c / CPW]) >> (c % CPW)) & 1u;
+    }
+    if (w < wpr - 1) win |= (alive_bits(row[w + 1]) & 1u) << (CPW + 1);
+    else if (wrap) win |= (alive_bits(row[0]) & 1u) << (cols - w * CPW + 1);
+    return win;
+}
+
+// Compute one generation for the CPW cells of one packed word.
+__kernel void gol_step_generations(__global const uint* grid,
+                                   __global uint* next,
+                                   const int rows,
+                                   const int cols,
+                                   const int wrap)
+{
+    // Map this work-item to one packed word: x is the row, w is the word inside the row.
+    const int x = (int)get_global_id(0);
+    const int w = (int)get_global_id(1);
+    const int wpr = (cols + CPW - 1) / CPW;
+    if (x >= rows || w >= wpr) return;
+
+    const uint up = row_window(grid, x - 1, w, rows, cols, wpr, wrap);
+    const uint mid = row_window(grid, x, w, rows, cols, wpr, wrap);
+    const uint down = row_window(grid, x + 1, w, rows, cols, wpr, wrap);
+    const uint word = grid[x * wpr + w];
+
+    // Padding cells of the last word are never written, so they stay dead.
+    const int n = min(cols - w * CPW, CPW);
+    uint result = 0u;
+    for (int i = 0; i < n; ++i) {
+        const int sum = (int)(popcount((up >> i) & 7u) + popcount((mid >> i) & 5u) + popcount((down >> i) & 7u));
+        const uint state = (word >> (i * GOL_BITS)) & CELL_MASK;
+
+        // Dead cells look up the birth bit, live cells the survival bit, dying cells age.
+        const uint look = (GOL_RULE_TABLE >> (sum + 9 * (int)(state == 1u))) & 1u;
+        const uint aged = (state + 1u < (uint)GOL_STATES) ? state + 1u : 0u;
+        const uint out = (state == 0u) ? look : (state == 1u) ? (look ? 1u : 2u) : aged;
+        result |= out << (i * GOL_BITS);
+    }
+    next[x * wpr + w] = result;
+}
@@ -1,15 +1,13 @@
-// Compute one Game of Life generation directly from global memory.
-__kernel void gol_step(__global const uchar* grid,
-                       __global uchar* next,
-                       const int rows,
-                       const int cols,
-                       const int wrap)
-{
-    // Map this work-item to one output cell.
-    const int x = (int)get_global_id(0);
-    const int y = (int)get_global_id(1);
-    if (x >= rows || y >= cols) return;
+// Rule lookup table, baked in at build time with -D GOL_RULE_TABLE (see gol_rule.h):
+// bit n is the next state of a dead cell with n live neighbors, bit 9 + n that of a live one.
+#ifndef GOL_RULE_TABLE
+#define GOL_RULE_TABLE 0x01808u
+#endif
 
+// Compute and store the next state of cell (x, y); returns it.
+static inline uchar gol_next_cell(__global const uchar* grid, __global uchar* next,
+                                  int x, int y, int rows, int cols, int wrap)
+{
     int sum = 0;
     // Visit the 3x3 neighborhood and skip the center cell itself.
     for (int dx = -1; dx <= 1; ++dx) {
@@ -36,14 +34,39 @@ __kernel void gol_step(__global const uchar* grid,
     // Convert the 2D coordinate into a linear buffer index.
     const int idx = x * cols + y;
     const uchar cell = grid[idx];
-    uchar out = 0;
-    if (cell) {
-        // Live cells survive only with two or three neighbors.
-        out = (sum == 2 || sum == 3) ? 1 : 0;
-    } else {
-        // Dead cells are born only when exactly three neighbors are alive.
-        out = (sum == 3) ? 1 : 0;
-    }
+    // Look up the birth bit for dead cells and the survival bit for live ones.
+    const uchar out = (uchar)((GOL_RULE_TABLE >> (sum + 9 * (int)cell)) & 1u);
     // Store the next-generation state for this cell.
     next[idx] = out;
+    return out;
+}
+
+// Compute one Game of Life generation directly from global memory.
+__kernel void gol_step(__global const uchar* grid,
+                       __global uchar* next,
+                       const int rows,
+                       const int cols,
+                       const int wrap
+#ifdef GOL_STATS
+                       , __global uint* stats,
+                       __local uint* stats_acc,
+                       const int gen
+#endif
+                       )
+{
+    // Map this work-item to one output cell.
+    const int x = (int)get_global_id(0);
+    const int y = (int)get_global_id(1);
+#ifdef GOL_STATS
+    // Padded work-items stay to the end, they take part in the work-group reduction.
+    gol_stats_begin(stats_acc);
+    if (x < rows && y < cols) {
+        const uchar cell = grid[x * cols + y];
+        gol_stats_cell(stats_acc, (ulong)x * cols + y, cell, gol_next_cell(grid, next, x, y, rows, cols, wrap));
+    }
+    gol_stats_end(stats_acc, stats, gen);
+#else
+    if (x >= rows || y >= cols) return;
+    gol_next_cell(grid, next, x, y, rows, cols, wrap);
+#endif
 }
@@ -0,0 +1,100 @@
+// Bit-packed Game of Life: every row is stored as ceil(cols / 64) ulong words,
+// bit j of word w holds column w * 64 + j. Padding bits past the last column stay zero.
+
+// Rule lookup table, baked in at build time with -D GOL_RULE_TABLE (see gol_rule.h):
+// bit n is the next state of a dead cell with n live neighbors, bit 9 + n that of a live one.
+#ifndef GOL_RULE_TABLE
+#define GOL_RULE_TABLE 0x01808u
+#endif
+
+// Load one packed row word, treating rows outside the board as dead or wrapped.
+static inline ulong load_row_word(__global const ulong* grid, int x, int w, int rows, int wpr, int wrap) {
+    if (x < 0 || x >= rows) {
+        if (!wrap) return (ulong)0;
+        x = (x < 0) ? x + rows : x - rows;
+    }
+    return grid[x * wpr + w];
+}
+
+// Build the west and east neighbor words of word w in one packed row.
+static inline void shifted_neighbors(__global const ulong* grid, int x, int w, int rows, int cols, int wpr, int wrap,
+                                     ulong center, ulong* west, ulong* east) {
+    const int last = wpr - 1;
+    const int last_bit = (cols - 1) & 63;
+
+    // Shift in the column left of bit 0 from the previous word or the wrapped last column.
+    ulong in_w = 0;
+    if (w > 0) in_w = load_row_word(grid, x, w - 1, rows, wpr, wrap) >> 63;
+    else if (wrap) in_w = (load_row_word(grid, x, last, rows, wpr, wrap) >> last_bit) & (ulong)1;
+    *west = (center << 1) | in_w;
+
+    // Shift in the column right of the last valid bit from the next word or the wrapped first column.
+    ulong e = center >> 1;
+    if (w < last) e |= load_row_word(grid, x, w + 1, rows, wpr, wrap) << 63;
+    else if (wrap) e |= (load_row_word(grid, x, 0, rows, wpr, wrap) & (ulong)1) << last_bit;
+    *east = e;
+}
+
+// Compute one generation for 64 cells at once with bit-sliced adder logic.
+__kernel void gol_step_packed(__global const ulong* grid,
+                              __global ulong* next,
+                              const int rows,
+                              const int cols,
+                              const int wrap)
+{
+    // Map this work-item to one packed word: x is the row, w is the word inside the row.
+    const int x = (int)get_global_id(0);
+    const int w = (int)get_global_id(1);
+    const int wpr = (cols + 63) >> 6;
+    if (x >= rows || w >= wpr) return;
+
+    // Gather the three row words and their west/east shifted copies.
+    const ulong up = load_row_word(grid, x - 1, w, rows, wpr, wrap);
+    const ulong mid = grid[x * wpr + w];
+    const ulong down = load_row_word(grid, x + 1, w, rows, wpr, wrap);
+
+    ulong up_w, up_e, mid_w, mid_e, down_w, down_e;
+    shifted_neighbors(grid, x - 1, w, rows, cols, wpr, wrap, up, &up_w, &up_e);
+    shifted_neighbors(grid, x, w, rows, cols, wpr, wrap, mid, &mid_w, &mid_e);
+    shifted_neighbors(grid, x + 1, w, rows, cols, wpr, wrap, down, &down_w, &down_e);
+
+    // Full adders sum the upper and lower neighbor triples, a half adder sums west and east.
+    const ulong u0 = up_w ^ up ^ up_e;
+    const ulong u1 = (up_w & up) | (up_e & (up_w ^ up));
+    const ulong l0 = down_w ^ down ^ down_e;
+    const ulong l1 = (down_w & down) | (down_e & (down_w ^ down));
+    const ulong m0 = mid_w ^ mid_e;
+    const ulong m1 = mid_w & mid_e;
+
+    // Combine the partial sums into the count bits (ones, twos, fours) of all 64 lanes.
+    const ulong ones = u0 ^ l0 ^ m0;
+    const ulong carry = (u0 & l0) | (m0 & (u0 ^ l0));
+    const ulong x0 = u1 ^ l1 ^ m1;
+    const ulong x1 = (u1 & l1) | (m1 & (u1 ^ l1));
+    const ulong twos = x0 ^ carry;
+    const ulong fours = x1 ^ (x0 & carry);
+
+#if GOL_RULE_TABLE == 0x01808u
+    // B3/S23: alive when the count is 3, or 2 with a live center cell (count 8 wraps to zero).
+    ulong out = twos & ~fours & (ones | mid);
+#else
+    // Other rules need the full count 0..8, then OR together the lanes whose count
+    // selects a set table bit; with a constant table the loop folds to a few terms.
+    const ulong eights = x1 & x0 & carry;
+    ulong out = 0;
+    for (int k = 0; k <= 8; ++k) {
+        const uint born = (GOL_RULE_TABLE >> k) & 1u;
+        const uint kept = (GOL_RULE_TABLE >> (9 + k)) & 1u;
+        if (!born && !kept) continue;
+        const ulong count_is_k = ((k & 1) ? ones : ~ones) & ((k & 2) ? twos : ~twos)
+                               & ((k & 4) ? fours : ~fours) & ((k & 8) ? eights : ~eights);
+        out |= count_is_k & ((born ? ~mid : (ulong)0) | (kept ? mid : (ulong)0));
+    }
+#endif
+
+    // Keep the padding bits after the last column dead.
+    if (w == wpr - 1 && (cols & 63) != 0) out &= (((ulong)1) << (cols & 63)) - (ulong)1;
+
+    // Store the next-generation word.
+    next[x * wpr + w] = out;
+}
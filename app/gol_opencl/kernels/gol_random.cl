@@ -0,0 +1,17 @@
+// Counter-based random board on the device, bit for bit the same as gol_random_fill
+// on the host: cell i is alive when the high half of splitmix64(key + i * gamma)
+// is below threshold (density * 2^32).
+__kernel void gol_random_fill(__global uchar* grid,
+                              const ulong n,
+                              const ulong key,
+                              const ulong threshold)
+{
+    const size_t i = get_global_id(0);
+    if ((ulong)i >= n) return;
+
+    ulong z = key + (ulong)i * 0x9E3779B97F4A7C15ul;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ul;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBul;
+    z ^= z >> 31;
+    grid[i] = (uchar)((z >> 32) < threshold);
+}
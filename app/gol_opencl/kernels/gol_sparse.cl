@@ -0,0 +1,112 @@
+// Sparse Game of Life: the board is split into tiles of one work-group each.
+// Only tiles that changed in the last generation, or touch such a tile, are computed.
+// Both grid buffers start with the same state, so a skipped tile already holds its
+// (unchanged) next-generation cells in the output buffer.
+
+// Rule lookup table, baked in at build time with -D GOL_RULE_TABLE (see gol_rule.h):
+// bit n is the next state of a dead cell with n live neighbors, bit 9 + n that of a live one.
+#ifndef GOL_RULE_TABLE
+#define GOL_RULE_TABLE 0x01808u
+#endif
+
+// Build the compacted list of active tiles for one generation.
+// One work-item per tile; the list length is accumulated in counts[gen].
+__kernel void gol_sparse_build_list(__global const uchar* changed,
+                                    __global uchar* changed_next,
+                                    __global int* tile_list,
+                                    __global int* counts,
+                                    const int tiles_x,
+                                    const int tiles_y,
+                                    const int wrap,
+                                    const int gen)
+{
+    const int t = (int)get_global_id(0);
+    if (t >= tiles_x * tiles_y) return;
+
+    const int tx = t / tiles_y;
+    const int ty = t - tx * tiles_y;
+
+    // A tile is active when it or one of its eight neighbor tiles changed last generation.
+    int active = 0;
+    for (int dx = -1; dx <= 1; ++dx) {
+        for (int dy = -1; dy <= 1; ++dy) {
+            int nx = tx + dx;
+            int ny = ty + dy;
+            if (wrap) {
+                if (nx < 0) nx += tiles_x;
+                if (nx >= tiles_x) nx -= tiles_x;
+                if (ny < 0) ny += tiles_y;
+                if (ny >= tiles_y) ny -= tiles_y;
+            } else if (nx < 0 || nx >= tiles_x || ny < 0 || ny >= tiles_y) {
+                continue;
+            }
+            active |= changed[nx * tiles_y + ny];
+        }
+    }
+
+    // Clear this tile's flag for the generation being computed; the step kernel sets it again.
+    changed_next[t] = 0;
+
+    if (active) {
+        const int slot = atomic_inc(&counts[gen]);
+        tile_list[slot] = t;
+    }
+}
+
+// Compute one generation for the active tiles only.
+// A fixed number of persistent work-groups strides over the compacted list, whose
+// length is read from device memory, so the host never has to read it back.
+__kernel void gol_step_sparse(__global const uchar* grid,
+                              __global uchar* next,
+                              const int rows,
+                              const int cols,
+                              const int wrap,
+                              __global const int* tile_list,
+                              __global const int* counts,
+                              __global uchar* changed_next,
+                              const int tiles_y,
+                              const int gen)
+{
+    const int lx = (int)get_local_id(0);
+    const int ly = (int)get_local_id(1);
+    const int LX = (int)get_local_size(0);
+    const int LY = (int)get_local_size(1);
+    const int active_tiles = counts[gen];
+
+    for (int i = (int)get_group_id(0); i < active_tiles; i += (int)get_num_groups(0)) {
+        // Map the work-item to its cell inside the listed tile.
+        const int t = tile_list[i];
+        const int tx = t / tiles_y;
+        const int ty = t - tx * tiles_y;
+        const int x = tx * LX + lx;
+        const int y = ty * LY + ly;
+        if (x >= rows || y >= cols) continue;
+
+        int sum = 0;
+        // Visit the 3x3 neighborhood and skip the center cell itself.
+        for (int dx = -1; dx <= 1; ++dx) {
+            for (int dy = -1; dy <= 1; ++dy) {
+                if (dx == 0 && dy == 0) continue;
+                int nx = x + dx;
+                int ny = y + dy;
+                if (wrap) {
+                    if (nx < 0) nx += rows;
+                    if (nx >= rows) nx -= rows;
+                    if (ny < 0) ny += cols;
+                    if (ny >= cols) ny -= cols;
+                    sum += (int)grid[nx * cols + ny];
+                } else if (nx >= 0 && nx < rows && ny >= 0 && ny < cols) {
+                    sum += (int)grid[nx * cols + ny];
+                }
+            }
+        }
+
+        const int idx = x * cols + y;
+        const uchar cell = grid[idx];
+        const uchar out = (uchar)((GOL_RULE_TABLE >> (sum + 9 * (int)cell)) & 1u);
+        next[idx] = out;
+
+        // Any changed cell marks the whole tile dirty for the next generation.
+        if (out != cell) changed_next[t] = 1;
+    }
+}
@@ -0,0 +1,50 @@
+// Fused per-generation statistics for the byte-per-cell step kernels. The host prepends
+// this file to gol_naive.cl or gol_tiled.cl and builds with -D GOL_STATS; the kernels
+// then take three extra arguments: the stats buffer, a __local scratch of
+// GOL_STATS_WORDS uints and the generation the launch computes.
+//
+// Every generation owns GOL_STATS_WORDS uints of the stats buffer, zeroed by the host:
+//   [0] population, [1] changed cells, [2..3] low and high half of the board hash.
+// The hash is a Zobrist hash, the XOR of a mixed 64-bit key of every live cell index,
+// so it does not depend on the order the work-groups finish in.
+#define GOL_STATS_WORDS 4
+
+// splitmix64 finalizer: spreads a cell index over all 64 bits.
+static inline ulong gol_stats_mix(ulong z) {
+    z += 0x9E3779B97F4A7C15ul;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ul;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBul;
+    return z ^ (z >> 31);
+}
+
+// Clear the work-group totals; every work-item of the group must call it.
+static inline void gol_stats_begin(__local uint* acc) {
+    if (get_local_id(0) == 0 && get_local_id(1) == 0) {
+        for (int i = 0; i < GOL_STATS_WORDS; ++i) acc[i] = 0u;
+    }
+    barrier(CLK_LOCAL_MEM_FENCE);
+}
+
+// Count the new state of one cell.
+// idx is the row-major cell index, 64-bit so boards past 2^31 cells hash every cell apart.
+static inline void gol_stats_cell(__local uint* acc, ulong idx, uchar cell, uchar out) {
+    if (out) {
+        const ulong h = gol_stats_mix(idx);
+        atomic_inc(&acc[0]);
+        atomic_xor(&acc[2], (uint)h);
+        atomic_xor(&acc[3], (uint)(h >> 32));
+    }
+    if (out != cell) atomic_inc(&acc[1]);
+}
+
+// Add the work-group totals to the slot of generation gen; every work-item must call it.
+static inline void gol_stats_end(__local uint* acc, __global uint* stats, int gen) {
+    barrier(CLK_LOCAL_MEM_FENCE);
+    if (get_local_id(0) == 0 && get_local_id(1) == 0) {
+        __global uint* slot = stats + (size_t)gen * GOL_STATS_WORDS;
+        if (acc[0]) atomic_add(&slot[0], acc[0]);
+        if (acc[1]) atomic_add(&slot[1], acc[1]);
+        if (acc[2]) atomic_xor(&slot[2], acc[2]);
+        if (acc[3]) atomic_xor(&slot[3], acc[3]);
+    }
+}
@@ -0,0 +1,49 @@
+// Rule lookup table, baked in at build time with -D GOL_RULE_TABLE (see gol_rule.h):
+// bit n is the next state of a dead cell with n live neighbors, bit 9 + n that of a live one.
+#ifndef GOL_RULE_TABLE
+#define GOL_RULE_TABLE 0x01808u
+#endif
+
+// One band of a board that is streamed through the device in horizontal bands.
+// The band buffer holds the band's own rows plus `halo` rows above and below,
+// so `halo` generations can be computed before the band has to go back to the host.
+// Generation s recomputes local rows [row_begin, row_begin + row_count), shrinking
+// by one row at each end per generation as the outer halo rows become stale.
+__kernel void gol_step_band(__global const uchar* grid,
+                            __global uchar* next,
+                            const int cols,
+                            const int wrap,
+                            const int row_begin,
+                            const int row_count,
+                            const int board_row0,
+                            const int rows)
+{
+    // Map this work-item to one cell of the band buffer.
+    const int i = (int)get_global_id(0);
+    const int y = (int)get_global_id(1);
+    if (i >= row_count || y >= cols) return;
+    const int x = row_begin + i;
+    const int idx = x * cols + y;
+
+    // Without wrap-around the halo rows outside the board must stay dead in every generation.
+    const int board_row = board_row0 + x;
+    if (!wrap && (board_row < 0 || board_row >= rows)) {
+        next[idx] = 0;
+        return;
+    }
+
+    const int yl = (y > 0) ? y - 1 : (wrap ? cols - 1 : -1);
+    const int yr = (y < cols - 1) ? y + 1 : (wrap ? 0 : -1);
+
+    __global const uchar* up = grid + (x - 1) * cols;
+    __global const uchar* mid = grid + x * cols;
+    __global const uchar* down = grid + (x + 1) * cols;
+
+    int sum = (int)up[y] + (int)down[y];
+    if (yl >= 0) sum += (int)up[yl] + (int)mid[yl] + (int)down[yl];
+    if (yr >= 0) sum += (int)up[yr] + (int)mid[yr] + (int)down[yr];
+
+    // Look up the birth or survival bit of the rule table.
+    const uchar cell = mid[y];
+    next[idx] = (uchar)((GOL_RULE_TABLE >> (sum + 9 * (int)cell)) & 1u);
+}
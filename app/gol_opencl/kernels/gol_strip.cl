@@ -0,0 +1,41 @@
+// Rule lookup table, baked in at build time with -D GOL_RULE_TABLE (see gol_rule.h):
+// bit n is the next state of a dead cell with n live neighbors, bit 9 + n that of a live one.
+#ifndef GOL_RULE_TABLE
+#define GOL_RULE_TABLE 0x01808u
+#endif
+
+// One horizontal strip of a board split across several devices.
+// The strip buffer holds strip_rows owned rows plus one halo row above (row 0)
+// and one below (row strip_rows + 1); the halo rows are filled by the host.
+// Rows row_begin + i * row_stride for i < row_count are computed, so one kernel
+// covers both the two edge rows and the contiguous interior.
+__kernel void gol_step_strip(__global const uchar* grid,
+                             __global uchar* next,
+                             const int cols,
+                             const int wrap,
+                             const int row_begin,
+                             const int row_stride,
+                             const int row_count)
+{
+    // Map this work-item to one output cell of the strip.
+    const int i = (int)get_global_id(0);
+    const int y = (int)get_global_id(1);
+    if (i >= row_count || y >= cols) return;
+    const int x = row_begin + i * row_stride;
+
+    // Columns wrap or end at the board edge; rows always have a neighbor thanks to the halos.
+    const int yl = (y > 0) ? y - 1 : (wrap ? cols - 1 : -1);
+    const int yr = (y < cols - 1) ? y + 1 : (wrap ? 0 : -1);
+
+    __global const uchar* up = grid + (x - 1) * cols;
+    __global const uchar* mid = grid + x * cols;
+    __global const uchar* down = grid + (x + 1) * cols;
+
+    int sum = (int)up[y] + (int)down[y];
+    if (yl >= 0) sum += (int)up[yl] + (int)mid[yl] + (int)down[yl];
+    if (yr >= 0) sum += (int)up[yr] + (int)mid[yr] + (int)down[yr];
+
+    // Look up the birth or survival bit of the rule table.
+    const uchar cell = mid[y];
+    next[x * cols + y] = (uchar)((GOL_RULE_TABLE >> (sum + 9 * (int)cell)) & 1u);
+}
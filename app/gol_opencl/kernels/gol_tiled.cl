@@ -1,3 +1,9 @@
+// Rule lookup table, baked in at build time with -D GOL_RULE_TABLE (see gol_rule.h):
+// bit n is the next state of a dead cell with n live neighbors, bit 9 + n that of a live one.
+#ifndef GOL_RULE_TABLE
+#define GOL_RULE_TABLE 0x01808u
+#endif
+
 // Normalize coordinates into the valid range for toroidal wrap-around.
 static inline int wrap_coord(int v, int maxv) {
     int r = v % maxv;
@@ -15,13 +21,37 @@ static inline uchar read_cell(__global const uchar* grid, int x, int y, int rows
     return grid[x * cols + y];
 }
 
+// Next state of the cell at tile position (lx + 1, ly + 1) from its eight neighbors in local memory.
+static inline uchar gol_tile_next_cell(__local const uchar* tile, int pitch, int lx, int ly) {
+    int sum = 0;
+    // Sum the eight neighbors from fast local memory instead of global memory.
+    sum += tile[(lx + 0) * pitch + (ly + 0)];
+    sum += tile[(lx + 0) * pitch + (ly + 1)];
+    sum += tile[(lx + 0) * pitch + (ly + 2)];
+    sum += tile[(lx + 1) * pitch + (ly + 0)];
+    sum += tile[(lx + 1) * pitch + (ly + 2)];
+    sum += tile[(lx + 2) * pitch + (ly + 0)];
+    sum += tile[(lx + 2) * pitch + (ly + 1)];
+    sum += tile[(lx + 2) * pitch + (ly + 2)];
+
+    // Read the current cell state from the tile center.
+    const uchar alive = tile[(lx + 1) * pitch + (ly + 1)];
+    return (uchar)((GOL_RULE_TABLE >> (sum + 9 * (int)alive)) & 1u);
+}
+
 // Compute one generation using local-memory tiles with a 1-cell halo.
 __kernel void gol_step_tiled(__global const uchar* grid,
                             __global uchar* next,
                             const int rows,
                             const int cols,
                             const int wrap,
-                            __local uchar* tile)
+                            __local uchar* tile
+#ifdef GOL_STATS
+                            , __global uint* stats,
+                            __local uint* stats_acc,
+                            const int gen
+#endif
+                            )
 {
     // Global IDs locate the output cell in the full board.
     const int gx = (int)get_global_id(0); // row
@@ -66,26 +96,107 @@ __kernel void gol_step_tiled(__global const uchar* grid,
     // Wait until the full tile and halo are available in local memory.
     barrier(CLK_LOCAL_MEM_FENCE);
 
+#ifdef GOL_STATS
+    // Padded work-items stay to the end, they take part in the work-group reduction.
+    gol_stats_begin(stats_acc);
+    if (gx < rows && gy < cols) {
+        const uchar out = gol_tile_next_cell(tile, pitch, lx, ly);
+        next[gx * cols + gy] = out;
+        gol_stats_cell(stats_acc, (ulong)gx * cols + gy, tile[(lx + 1) * pitch + (ly + 1)], out);
+    }
+    gol_stats_end(stats_acc, stats, gen);
+#else
     // Ignore padded work-items that fall outside the real grid.
     if (gx >= rows || gy >= cols) return;
 
-    int sum = 0;
-    // Sum the eight neighbors from fast local memory instead of global memory.
-    sum += tile[(lx + 0) * pitch + (ly + 0)];
-    sum += tile[(lx + 0) * pitch + (ly + 1)];
-    sum += tile[(lx + 0) * pitch + (ly + 2)];
-    sum += tile[(lx + 1) * pitch + (ly + 0)];
-    sum += tile[(lx + 1) * pitch + (ly + 2)];
-    sum += tile[(lx + 2) * pitch + (ly + 0)];
-    sum += tile[(lx + 2) * pitch + (ly + 1)];
-    sum += tile[(lx + 2) * pitch + (ly + 2)];
+    // Write the computed next-generation value back to global memory.
+    next[gx * cols + gy] = gol_tile_next_cell(tile, pitch, lx, ly);
+#endif
+}
 
-    // Read the current cell state from the tile center.
-    const uchar alive = tile[(lx + 1) * pitch + (ly + 1)];
-    uchar out;
-    if (alive) out = (sum == 2 || sum == 3) ? (uchar)1 : (uchar)0;
-    else       out = (sum == 3) ? (uchar)1 : (uchar)0;
+// Advance several generations per launch inside one local tile with a steps-wide halo.
+// The tile holds (LX + 2*steps) x (LY + 2*steps) cells in two ping-pong halves; after
+// each generation the valid region shrinks by one cell per side until only the
+// LX x LY center is left, which is written back to global memory.
+__kernel void gol_step_tiled_multi(__global const uchar* grid,
+                                   __global uchar* next,
+                                   const int rows,
+                                   const int cols,
+                                   const int wrap,
+                                   __local uchar* tiles,
+                                   const int steps)
+{
+    // Local IDs and sizes describe the output block owned by this work-group.
+    const int lx = (int)get_local_id(0);
+    const int ly = (int)get_local_id(1);
+    const int LX = (int)get_local_size(0);
+    const int LY = (int)get_local_size(1);
 
-    // Write the computed next-generation value back to global memory.
-    next[gx * cols + gy] = out;
+    // The extended tile carries a halo of one cell per generation on every side.
+    const int TX = LX + 2 * steps;
+    const int TY = LY + 2 * steps;
+    const int tile_cells = TX * TY;
+    const int lane = lx * LY + ly;
+    const int lanes = LX * LY;
+
+    // Global coordinates of the extended tile's top-left corner.
+    const int ox = (int)get_group_id(0) * LX - steps;
+    const int oy = (int)get_group_id(1) * LY - steps;
+
+    __local uchar* src = tiles;
+    __local uchar* dst = tiles + tile_cells;
+
+    // All work-items cooperatively load the tile and its halo in strided order.
+    for (int i = lane; i < tile_cells; i += lanes) {
+        const int tx = i / TY;
+        const int ty = i - tx * TY;
+        src[i] = read_cell(grid, ox + tx, oy + ty, rows, cols, wrap);
+    }
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    // Run the generations in local memory, shrinking the computed region each time.
+    for (int s = 1; s <= steps; ++s) {
+        const int RX = TX - 2 * s;
+        const int RY = TY - 2 * s;
+        for (int i = lane; i < RX * RY; i += lanes) {
+            const int rx = i / RY;
+            const int tx = s + rx;
+            const int ty = s + (i - rx * RY);
+            const int c = tx * TY + ty;
+
+            int sum = 0;
+            sum += src[c - TY - 1];
+            sum += src[c - TY];
+            sum += src[c - TY + 1];
+            sum += src[c - 1];
+            sum += src[c + 1];
+            sum += src[c + TY - 1];
+            sum += src[c + TY];
+            sum += src[c + TY + 1];
+
+            uchar out = (uchar)((GOL_RULE_TABLE >> (sum + 9 * (int)src[c])) & 1u);
+
+            // Without wrap-around, cells outside the board stay dead in every generation.
+            if (!wrap) {
+                const int gxx = ox + tx;
+                const int gyy = oy + ty;
+                if (gxx < 0 || gxx >= rows || gyy < 0 || gyy >= cols) out = (uchar)0;
+            }
+            dst[c] = out;
+        }
+
+        // Make the new generation visible before it becomes the next input.
+        barrier(CLK_LOCAL_MEM_FENCE);
+        __local uchar* tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    // Ignore padded work-items that fall outside the real grid.
+    const int gx = (int)get_global_id(0);
+    const int gy = (int)get_global_id(1);
+    if (gx >= rows || gy >= cols) return;
+
+    // Write the center cell after the final generation.
+    next[gx * cols + gy] = src[(lx + steps) * TY + (ly + steps)];
 }
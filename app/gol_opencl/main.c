@@ -1,4 +1,27 @@
 #include "kernel_loader.h"
+#include "gol_bitpack.h"
+#include "gol_generations.h"
+#include "gol_cpu_par.h"
+#include "gol_cpu_seq.h"
+#include "gol_hashlife.h"
+#include "gol_histogram.h"
+#include "gol_perf.h"
+#include "gol_mapped.h"
+#include "gol_pattern.h"
+#include "gol_program_cache.h"
+#include "gol_tuning.h"
+#include "gol_trace.h"
+#include "gol_rule.h"
+#include "gol_stats.h"
+#include "gol_random.h"
+#include "gol_device.h"
+#include "gol_cl.h"
+#include "gol_multi.h"
+#include "gol_stream.h"
+#include "gol_checkpoint.h"
+#include "gol_frames.h"
+#include "gol_engine.h"
+#include "gol_bench.h"
 
 #define CL_TARGET_OPENCL_VERSION 220
 #include <CL/cl.h>
@@ -6,8 +29,10 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
 #include <time.h>
 #include <errno.h>
+#include <limits.h>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -17,204 +42,385 @@
 
 typedef enum RunMode {
     MODE_GPU = 0,
-    MODE_CPU_SEQ = 1
+    MODE_CPU_SEQ = 1,
+    MODE_CPU_PAR = 2,
+    MODE_HASHLIFE = 3,
+    MODE_MULTI = 4,
+    MODE_STREAM = 5
 } RunMode;
 
-// Return the current time in milliseconds using a high-resolution timer.
-static double now_ms(void) {
-#ifdef _WIN32
-    static LARGE_INTEGER freq;
-    static int initialized = 0;
-    LARGE_INTEGER counter;
-    if (!initialized) {
-        QueryPerformanceFrequency(&freq);
-        initialized = 1;
-    }
-    QueryPerformanceCounter(&counter);
-    return (double)counter.QuadPart * 1000.0 / (double)freq.QuadPart;
-#else
-    struct timespec ts;
-    clock_gettime(CLOCK_MONOTONIC, &ts);
-    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1e6;
-#endif
+// Check whether the given file already exists.
+static int file_exists(const char* path) {
+    FILE* f = fopen(path, "r");
+    if (f) {
+        fclose(f);
+        return 1;
+    }
+    return 0;
 }
 
-// Abort the program when an OpenCL call fails.
-static void die_cl(const char* where, cl_int err) {
-    fprintf(stderr, "[OpenCL ERROR] %s failed, code=%d\n", where, err);
-    exit(1);
+// Result CSV header. The first 13 columns are the original schema; later columns are only ever appended.
+static const char csv_header[] =
+    "mode,rows,cols,iters,wrap,lx,ly,h2d_ms,kernel_ms,d2h_ms,total_ms,wall_total_ms,tiled,"
+    "steps_per_launch,pipeline,devices,device_kernel_ms,halo_ms,rule,states,kernel_cache,build_ms,"
+    "runs,kernel_ms_median,kernel_ms_p95,kernel_ms_stddev,wall_ms_median,wall_ms_p95,wall_ms_stddev,"
+    "gen_us_min,gen_us_median,gen_us_p99,gen_us_max,"
+    "perf_cycles,perf_instructions,perf_llc_misses,perf_branch_misses,cells_per_cycle,bytes_per_cell,"
+    "cell_updates_per_s,model_bytes_per_cell,effective_gb_s,peak_copy_gb_s,pct_peak_bw,zero_copy,saved_copy_ms\n";
+
+// 1 when an existing, non-empty CSV file starts with a different header than this build writes.
+static int csv_header_differs(const char* path) {
+    FILE* f = fopen(path, "r");
+    if (!f) return 0;
+    char line[sizeof(csv_header) + 1];
+    const int differs = fgets(line, (int)sizeof(line), f) != NULL && strcmp(line, csv_header) != 0;
+    fclose(f);
+    return differs;
 }
 
-// Select the first available GPU, otherwise fall back to a CPU device.
-static cl_device_id pick_device(cl_platform_id* out_platform) {
-    cl_int err;
-    cl_uint n_platforms = 0;
-    err = clGetPlatformIDs(0, NULL, &n_platforms);
-    if (err != CL_SUCCESS || n_platforms == 0) die_cl("clGetPlatformIDs(count)", err);
-
-    cl_platform_id* plats = (cl_platform_id*)calloc(n_platforms, sizeof(cl_platform_id));
-    if (!plats) {
-        fprintf(stderr, "Platform allocation failed.\n");
-        exit(1);
-    }
-
-    err = clGetPlatformIDs(n_platforms, plats, NULL);
-    if (err != CL_SUCCESS) die_cl("clGetPlatformIDs(list)", err);
+// Convert the selected run mode to the corresponding CSV label.
+static const char* mode_to_csv_name(RunMode mode, int tiled, int packed, int sparse, int states) {
+    if (states > 2) return mode == MODE_CPU_SEQ ? "cpu_generations" : "gpu_generations";
+    if (mode == MODE_CPU_SEQ) return "cpu_seq";
+    if (mode == MODE_CPU_PAR) return "cpu_par";
+    if (mode == MODE_HASHLIFE) return "hashlife";
+    if (mode == MODE_MULTI) return "gpu_multi";
+    if (mode == MODE_STREAM) return "gpu_stream";
+    if (packed) return "gpu_packed";
+    if (sparse) return "gpu_sparse";
+    return tiled ? "gpu_tiled" : "gpu_naive";
+}
 
-    cl_device_id chosen = NULL;
-    cl_platform_id chosen_plat = NULL;
+// Spread of one measured time over the repeated runs; runs == 0 means it was not collected.
+typedef struct RunSpread {
+    int runs;
+    double median;
+    double p95;
+    double stddev;
+} RunSpread;
+
+static int compare_doubles(const void* a, const void* b) {
+    const double x = *(const double*)a;
+    const double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
 
-    // Try to find a GPU device first.
-    for (cl_uint p = 0; p < n_platforms && !chosen; ++p) {
-        cl_uint n_dev = 0;
-        err = clGetDeviceIDs(plats[p], CL_DEVICE_TYPE_GPU, 0, NULL, &n_dev);
-        if (err == CL_SUCCESS && n_dev > 0) {
-            err = clGetDeviceIDs(plats[p], CL_DEVICE_TYPE_GPU, 1, &chosen, NULL);
-            if (err == CL_SUCCESS) chosen_plat = plats[p];
-        }
-    }
+// Median, nearest-rank 95th percentile and sample standard deviation; sorts the samples in place.
+static RunSpread run_spread(double* samples, int n) {
+    RunSpread s = { n, 0.0, 0.0, 0.0 };
+    if (n <= 0) return s;
+    qsort(samples, (size_t)n, sizeof(double), compare_doubles);
+    s.median = (n % 2) ? samples[n / 2] : 0.5 * (samples[n / 2 - 1] + samples[n / 2]);
+    int rank = (95 * n + 99) / 100;
+    s.p95 = samples[rank - 1];
+
+    double mean = 0.0;
+    for (int i = 0; i < n; ++i) mean += samples[i];
+    mean /= (double)n;
+    double var = 0.0;
+    for (int i = 0; i < n; ++i) var += (samples[i] - mean) * (samples[i] - mean);
+    s.stddev = n > 1 ? sqrt(var / (double)(n - 1)) : 0.0;
+    return s;
+}
 
-    // Fall back to a CPU device if no GPU was found.
-    if (!chosen) {
-        for (cl_uint p = 0; p < n_platforms && !chosen; ++p) {
-            cl_uint n_dev = 0;
-            err = clGetDeviceIDs(plats[p], CL_DEVICE_TYPE_CPU, 0, NULL, &n_dev);
-            if (err == CL_SUCCESS && n_dev > 0) {
-                err = clGetDeviceIDs(plats[p], CL_DEVICE_TYPE_CPU, 1, &chosen, NULL);
-                if (err == CL_SUCCESS) chosen_plat = plats[p];
-            }
-        }
-    }
+// One benchmark result row; columns a mode does not use stay zero.
+typedef struct CsvRow {
+    RunMode mode;
+    int rows;
+    int cols;
+    int iters;
+    int wrap;
+    size_t lx;
+    size_t ly;
+    double h2d_ms;
+    double kernel_ms;
+    double d2h_ms;
+    double total_ms;
+    double wall_total_ms;
+    int tiled;
+    int packed;
+    int sparse;
+    int steps_per_launch;
+    int pipeline;
+    int devices;                    // 0 is written as 1
+    const double* device_kernel_ms; // one entry per device, NULL when kernel_ms is the only one
+    double halo_ms;
+    const char* rule;               // NULL is written as B3/S23
+    int states;                     // 0 is written as 2
+    const char* kernel_cache;       // hit, miss, mixed, off or reused; NULL (CPU modes) is written as none
+    double build_ms;                // program creation and build, including cache lookups
+    RunSpread kernel_spread;        // per-run kernel_ms, empty columns when not collected
+    RunSpread wall_spread;          // per-run wall_total_ms, likewise
+    const GolHistogram* gen_hist;   // kernel ns per generation over the measured runs, NULL when not collected
+    const GolPerf* perf;            // hardware counters over the measured runs, NULL when not collected
+    double model_bytes_per_cell;    // modelled global memory traffic per cell update, 0 when not modelled
+    double peak_gb_s;               // measured copy bandwidth of the device, 0 when not measured
+    int zero_copy;                  // grid buffers in host memory, transferred by map/unmap
+    double saved_copy_ms;           // write + read copy time minus the zero-copy transfer time
+} CsvRow;
+
+// Write the runs count of a spread and its statistics, or empty fields when it was not collected.
+static void write_spread(FILE* f, const RunSpread* s) {
+    if (s->runs > 0) fprintf(f, ",%.6f,%.6f,%.6f", s->median, s->p95, s->stddev);
+    else fprintf(f, ",,,");
+}
 
-    free(plats);
+// Per-run average of one counter, or -1 when it was not collected.
+static double perf_per_run(const GolPerf* perf, int counter) {
+    if (!perf || perf->intervals == 0 || !gol_perf_has(perf, counter)) return -1.0;
+    return perf->value[counter] / (double)perf->intervals;
+}
 
-    if (!chosen) {
-        fprintf(stderr, "No OpenCL GPU/CPU device found.\n");
-        exit(1);
+// Write the counter columns with cells/cycle and the memory traffic estimate in bytes/cell.
+static void write_perf_columns(FILE* f, const GolPerf* perf, double cell_updates) {
+    for (int c = 0; c < GOL_PERF_COUNTERS; ++c) {
+        const double v = perf_per_run(perf, c);
+        if (v >= 0.0) fprintf(f, ",%.0f", v);
+        else fprintf(f, ",");
     }
-
-    *out_platform = chosen_plat;
-    return chosen;
+    const double cycles = perf_per_run(perf, GOL_PERF_CYCLES);
+    const double misses = perf_per_run(perf, GOL_PERF_LLC_MISSES);
+    if (cycles > 0.0) fprintf(f, ",%.6f", cell_updates / cycles);
+    else fprintf(f, ",");
+    if (misses >= 0.0 && cell_updates > 0.0) fprintf(f, ",%.6f", misses * GOL_PERF_LINE_BYTES / cell_updates);
+    else fprintf(f, ",");
 }
 
-// Print basic information about the selected OpenCL device.
-static void print_device_info(cl_device_id dev) {
-    char name[256];
-    char vendor[256];
-    cl_uint cu = 0;
-    cl_ulong gmem = 0;
-
-    clGetDeviceInfo(dev, CL_DEVICE_NAME, sizeof(name), name, NULL);
-    clGetDeviceInfo(dev, CL_DEVICE_VENDOR, sizeof(vendor), vendor, NULL);
-    clGetDeviceInfo(dev, CL_DEVICE_MAX_COMPUTE_UNITS, sizeof(cu), &cu, NULL);
-    clGetDeviceInfo(dev, CL_DEVICE_GLOBAL_MEM_SIZE, sizeof(gmem), &gmem, NULL);
-
-    printf("Device: %s (%s), CU=%u, GlobalMem=%.2f MB\n",
-           name, vendor, cu, (double)gmem / (1024.0 * 1024.0));
+// Print the per-run counter averages and the derived rates.
+static void print_perf_counters(const GolPerf* perf, double cell_updates) {
+    if (!perf || perf->intervals == 0) return;
+    printf("Hardware counters per run:");
+    for (int c = 0; c < GOL_PERF_COUNTERS; ++c) {
+        const double v = perf_per_run(perf, c);
+        if (v >= 0.0) printf(" %s=%.0f", gol_perf_name(c), v);
+        else printf(" %s=n/a", gol_perf_name(c));
+    }
+    printf("\n");
+    const double cycles = perf_per_run(perf, GOL_PERF_CYCLES);
+    const double instructions = perf_per_run(perf, GOL_PERF_INSTRUCTIONS);
+    const double misses = perf_per_run(perf, GOL_PERF_LLC_MISSES);
+    if (cycles > 0.0) {
+        printf("Cells per cycle: %.4f", cell_updates / cycles);
+        if (instructions >= 0.0) printf(" (IPC %.2f)", instructions / cycles);
+        printf("\n");
+    }
+    if (misses >= 0.0) printf("LLC miss traffic: %.3f bytes/cell\n", misses * GOL_PERF_LINE_BYTES / cell_updates);
 }
 
-// Check whether the given file already exists.
-static int file_exists(const char* path) {
-    FILE* f = fopen(path, "r");
-    if (f) {
-        fclose(f);
-        return 1;
-    }
-    return 0;
+// Cell updates per second of the measured kernel time, 0 when there is none.
+static double cell_updates_per_s(int rows, int cols, int iters, double kernel_ms) {
+    return kernel_ms > 0.0 ? (double)rows * (double)cols * (double)iters / (kernel_ms / 1e3) : 0.0;
 }
 
-// Convert the selected run mode to the corresponding CSV label.
-static const char* mode_to_csv_name(RunMode mode, int tiled) {
-    if (mode == MODE_CPU_SEQ) return "cpu_seq";
-    return tiled ? "gpu_tiled" : "gpu_naive";
+// Write the throughput and roofline columns; the bandwidth ones stay empty without a model or peak.
+static void write_roofline_columns(FILE* f, const CsvRow* row) {
+    const double cups = cell_updates_per_s(row->rows, row->cols, row->iters, row->kernel_ms);
+    const double gb_s = cups * row->model_bytes_per_cell / 1e9;
+    if (cups > 0.0) fprintf(f, ",%.0f", cups);
+    else fprintf(f, ",");
+    if (row->model_bytes_per_cell > 0.0 && cups > 0.0) fprintf(f, ",%.6f,%.6f", row->model_bytes_per_cell, gb_s);
+    else fprintf(f, ",,");
+    if (row->peak_gb_s > 0.0) fprintf(f, ",%.6f", row->peak_gb_s);
+    else fprintf(f, ",");
+    if (row->peak_gb_s > 0.0 && gb_s > 0.0) fprintf(f, ",%.3f", 100.0 * gb_s / row->peak_gb_s);
+    else fprintf(f, ",");
 }
 
-// Append one benchmark result row to a CSV file.
-static void append_csv_row(const char* out_path,
-                           RunMode mode,
-                           int rows, int cols, int iters, int wrap,
-                           size_t lx, size_t ly,
-                           double h2d_ms, double kernel_ms, double d2h_ms,
-                           double total_ms, double wall_total_ms,
-                           int tiled)
+// Append one benchmark result row to a CSV file; returns 0 when the row could not be written.
+// A file with another header (from an older build) is left alone rather than given rows of another width.
+static int append_csv_row(const char* out_path, const CsvRow* row)
 {
+    if (csv_header_differs(out_path)) {
+        fprintf(stderr, "%s has a different CSV header than this build writes; not appending. "
+                        "Remove it or choose another --out file.\n", out_path);
+        return 0;
+    }
     int exists = file_exists(out_path);
     FILE* f = fopen(out_path, "a");
     if (!f) {
         fprintf(stderr, "Could not open output file: %s\n", out_path);
-        return;
+        return 0;
     }
 
-    // Write the CSV header when the file is created for the first time.
-    if (!exists) {
-        fprintf(f, "mode,rows,cols,iters,wrap,lx,ly,h2d_ms,kernel_ms,d2h_ms,total_ms,wall_total_ms,tiled\n");
+    // Write the CSV header when the file is created for the first time, or was left empty.
+    if (!exists || ftell(f) == 0) fputs(csv_header, f);
+
+    fprintf(f, "%s,%d,%d,%d,%d,%u,%u,%.6f,%.6f,%.6f,%.6f,%.6f,%d,%d,%d,",
+            mode_to_csv_name(row->mode, row->tiled, row->packed, row->sparse, row->states),
+            row->rows, row->cols, row->iters, row->wrap,
+            (unsigned)row->lx, (unsigned)row->ly,
+            row->h2d_ms, row->kernel_ms, row->d2h_ms, row->total_ms, row->wall_total_ms,
+            row->tiled, row->steps_per_launch, row->pipeline);
+
+    // Per-device kernel times share one column, separated by ';' so the row keeps its width.
+    const int devices = row->devices > 0 ? row->devices : 1;
+    fprintf(f, "%d,", devices);
+    if (row->device_kernel_ms) {
+        for (int d = 0; d < devices; ++d) fprintf(f, "%s%.6f", d ? ";" : "", row->device_kernel_ms[d]);
+    } else {
+        fprintf(f, "%.6f", row->kernel_ms);
     }
+    fprintf(f, ",%.6f,%s,%d,%s,%.6f", row->halo_ms, row->rule ? row->rule : "B3/S23", row->states > 2 ? row->states : 2,
+            row->kernel_cache ? row->kernel_cache : "none", row->build_ms);
+    fprintf(f, ",%d", row->kernel_spread.runs > row->wall_spread.runs ? row->kernel_spread.runs : row->wall_spread.runs);
+    write_spread(f, &row->kernel_spread);
+    write_spread(f, &row->wall_spread);
+    if (row->gen_hist && row->gen_hist->total > 0) {
+        const GolHistogram* h = row->gen_hist;
+        fprintf(f, ",%.3f,%.3f,%.3f,%.3f", (double)h->min / 1e3, (double)gol_hist_quantile(h, 0.5) / 1e3,
+                (double)gol_hist_quantile(h, 0.99) / 1e3, (double)h->max / 1e3);
+    } else {
+        fprintf(f, ",,,,");
+    }
+    write_perf_columns(f, row->perf, (double)row->rows * (double)row->cols * (double)row->iters);
+    write_roofline_columns(f, row);
+    fprintf(f, ",%d", row->zero_copy);
+    if (row->zero_copy) fprintf(f, ",%.6f", row->saved_copy_ms);
+    else fprintf(f, ",");
+    fputc('\n', f);
+
+    return fclose(f) == 0;
+}
 
-    fprintf(f, "%s,%d,%d,%d,%d,%u,%u,%.6f,%.6f,%.6f,%.6f,%.6f,%d\n",
-            mode_to_csv_name(mode, tiled),
-            rows, cols, iters, wrap,
-            (unsigned)lx, (unsigned)ly,
-            h2d_ms, kernel_ms, d2h_ms, total_ms, wall_total_ms,
-            tiled);
-
-    fclose(f);
+/*
+ * Add the kernel times of one measured run to the per-generation histogram and the
+ * optional trace. Launch k covers up to steps generations starting at k * steps;
+ * its time is spread evenly over them.
+ */
+static void record_generation_times(GolHistogram* hist, FILE* trace, int run,
+                                    const cl_ulong* launch_ns, int n_launches, int iters, int steps)
+{
+    for (int k = 0; k < n_launches; ++k) {
+        const int first = k * steps;
+        const int gens = (iters - first < steps) ? (iters - first) : steps;
+        const uint64_t per_gen = (uint64_t)launch_ns[k] / (uint64_t)gens;
+        gol_hist_record(hist, per_gen, (uint64_t)gens);
+        if (trace) {
+            fprintf(trace, "%d,%d,%d,%d,%llu,%llu\n", run, k, first, gens,
+                    (unsigned long long)launch_ns[k], (unsigned long long)per_gen);
+        }
+    }
 }
 
-// Round a value up to the next valid multiple.
-static size_t round_up(size_t value, size_t multiple) {
-    if (multiple == 0) return value;
-    size_t rem = value % multiple;
-    return rem == 0 ? value : value + (multiple - rem);
+// Print the per-generation distribution of the kernel time.
+static void print_generation_times(const GolHistogram* hist) {
+    if (hist->total == 0) return;
+    printf("Kernel per generation min / median / p99 / max: %.3f / %.3f / %.3f / %.3f us\n",
+           (double)hist->min / 1e3, (double)gol_hist_quantile(hist, 0.5) / 1e3,
+           (double)gol_hist_quantile(hist, 0.99) / 1e3, (double)hist->max / 1e3);
 }
 
-// Wrap a coordinate into the valid grid range.
-static int wrap_coord_cpu(int v, int maxv) {
-    int r = v % maxv;
-    return (r < 0) ? (r + maxv) : r;
+// Write and free the Chrome trace if one is open; later calls do nothing.
+static void finish_trace(GolTrace** trace, const char* path) {
+    if (!*trace) return;
+    if (gol_trace_close(*trace) != 0) fprintf(stderr, "Could not write trace file: %s\n", path);
+    *trace = NULL;
 }
 
-// Read one cell from the CPU grid with optional wrap-around.
-static unsigned char read_cell_cpu(const unsigned char* grid,
-                                   int x,
-                                   int y,
-                                   int rows,
-                                   int cols,
-                                   int wrap)
-{
-    if (wrap) {
-        x = wrap_coord_cpu(x, rows);
-        y = wrap_coord_cpu(y, cols);
-        return grid[(size_t)x * (size_t)cols + (size_t)y];
+// Generations between two reads of the statistics buffer while waiting for a stop condition,
+// and when they are only written out. The device keeps one chunk of slots, reused round-robin.
+#define STATS_CHECK_GENERATIONS 16
+#define STATS_STREAM_GENERATIONS 1024
+
+// Append n generations of statistics to the --gen-stats CSV; the first is generation first + 1.
+static void write_gen_stats(FILE* f, const GolGenStats* gens, int n, uint64_t first) {
+    for (int g = 0; g < n; ++g) {
+        fprintf(f, "%llu,%u,%u,%016llx\n", (unsigned long long)(first + (uint64_t)g + 1),
+                (unsigned)gens[g].population, (unsigned)gens[g].changed, (unsigned long long)gens[g].hash);
     }
-    if (x < 0 || x >= rows || y < 0 || y >= cols) return 0;
-    return grid[(size_t)x * (size_t)cols + (size_t)y];
 }
 
-// Compute one CPU reference step of the Game of Life.
-static void gol_cpu_step(const unsigned char* in,
-                         unsigned char* out,
-                         int rows,
-                         int cols,
-                         int wrap)
-{
-    for (int x = 0; x < rows; ++x) {
-        for (int y = 0; y < cols; ++y) {
-            int sum = 0;
-            // Sum the eight neighboring cells around the current cell.
-            for (int dx = -1; dx <= 1; ++dx) {
-                for (int dy = -1; dy <= 1; ++dy) {
-                    if (dx == 0 && dy == 0) continue;
-                    sum += (int)read_cell_cpu(in, x + dx, y + dy, rows, cols, wrap);
-                }
-            }
+// Report a failed engine call and exit, like gol_die_cl for direct OpenCL calls.
+static void die_engine(const GolEngine* engine, int rc, const char* where) {
+    if (rc == GOL_ENGINE_OK) return;
+    const char* detail = gol_engine_message(engine);
+    fprintf(stderr, "%s failed: %s\n", where, detail[0] ? detail : gol_engine_error_string(rc));
+    exit(1);
+}
 
-            const size_t idx = (size_t)x * (size_t)cols + (size_t)y;
-            const unsigned char alive = in[idx];
-            // Apply the standard Conway birth and survival rules.
-            if (alive) out[idx] = (sum == 2 || sum == 3) ? 1u : 0u;
-            else       out[idx] = (sum == 3) ? 1u : 0u;
+// First launch boundary, counted in generations of the run, at or after the next multiple of every
+// past generation base + done; launches cover steps generations each from the start of the run.
+static int next_launch_boundary(int every, uint64_t base, int done, int steps) {
+    const uint64_t next = ((base + (uint64_t)done) / (uint64_t)every + 1) * (uint64_t)every - base;
+    const uint64_t boundary = (next + (uint64_t)steps - 1) / (uint64_t)steps * (uint64_t)steps;
+    return boundary > (uint64_t)INT_MAX ? INT_MAX : (int)boundary;
+}
+
+// Wall-clock time of the measured runs of a CPU engine.
+typedef struct CpuTiming {
+    double avg_ms;
+    RunSpread spread;
+} CpuTiming;
+
+// One CPU engine for time_cpu_runs: reset restores the initial board untimed before every run,
+// step advances it by the requested generations; both return 0 on failure.
+typedef struct CpuRunner {
+    int (*reset)(void* ctx);
+    int (*step)(void* ctx);
+    void* ctx;
+} CpuRunner;
+
+// Run warmup + repeat times, timing only step (and counting it in perf when not NULL), and
+// average the measured runs. Returns 0 as soon as a call fails.
+static int time_cpu_runs(const CpuRunner* runner, int repeat, int warmup, GolPerf* perf, CpuTiming* timing) {
+    double* samples = (double*)malloc((size_t)repeat * sizeof(double));
+    if (!samples) {
+        fprintf(stderr, "Host allocation failed (run samples)\n");
+        return 0;
+    }
+    int ok = 1;
+    double wall_sum = 0.0;
+    for (int run = 0; ok && run < warmup + repeat; ++run) {
+        const int measured = run >= warmup;
+        ok = runner->reset(runner->ctx);
+        if (!ok) break;
+        if (perf && measured) gol_perf_start(perf);
+        const double start_ms = gol_now_ms();
+        ok = runner->step(runner->ctx);
+        const double elapsed_ms = gol_now_ms() - start_ms;
+        if (perf && measured) gol_perf_stop(perf);
+        if (measured) {
+            samples[run - warmup] = elapsed_ms;
+            wall_sum += elapsed_ms;
         }
     }
+    if (ok) {
+        timing->avg_ms = wall_sum / (double)repeat;
+        timing->spread = run_spread(samples, repeat);
+    }
+    free(samples);
+    return ok;
+}
+
+// Byte-per-cell boards of the sequential reference and the parallel engine.
+typedef struct CpuBoards {
+    const unsigned char* initial;
+    unsigned char* cur;
+    unsigned char* next;
+    size_t n;
+    int rows;
+    int cols;
+    int iters;
+    int wrap;
+    uint32_t rule;
+    GolCpuPool* pool;
+} CpuBoards;
+
+static int reset_cpu_boards(void* ctx) {
+    CpuBoards* b = (CpuBoards*)ctx;
+    memcpy(b->cur, b->initial, b->n);
+    return 1;
+}
+
+static int step_cpu_seq(void* ctx) {
+    CpuBoards* b = (CpuBoards*)ctx;
+    for (int t = 0; t < b->iters; ++t) {
+        gol_cpu_step(b->cur, b->next, b->rows, b->cols, b->wrap, b->rule, 2);
+        unsigned char* tmp = b->cur;
+        b->cur = b->next;
+        b->next = tmp;
+    }
+    return 1;
 }
 
 // Run the sequential CPU reference implementation and measure its wall-clock time.
@@ -224,42 +430,255 @@ static void run_cpu_seq(const unsigned char* initial,
                         int cols,
                         int iters,
                         int wrap,
+                        uint32_t rule,
                         int repeat,
                         int warmup,
-                        double* avg_wall_total_ms)
+                        GolPerf* perf,
+                        CpuTiming* timing)
 {
     const size_t n = (size_t)rows * (size_t)cols;
-    unsigned char* cpu_a = (unsigned char*)malloc(n);
-    unsigned char* cpu_b = (unsigned char*)malloc(n);
-    if (!cpu_a || !cpu_b) {
+    CpuBoards b = { initial, (unsigned char*)malloc(n), (unsigned char*)malloc(n), n, rows, cols, iters, wrap, rule, NULL };
+    if (!b.cur || !b.next) {
         fprintf(stderr, "CPU benchmark allocation failed.\n");
-        free(cpu_a);
-        free(cpu_b);
+        free(b.cur);
+        free(b.next);
         exit(1);
     }
 
-    double wall_sum = 0.0;
+    const CpuRunner runner = { reset_cpu_boards, step_cpu_seq, &b };
+    if (!time_cpu_runs(&runner, repeat, warmup, perf, timing)) exit(1);
+    memcpy(result, b.cur, n);
 
-    for (int run = 0; run < warmup + repeat; ++run) {
-        memcpy(cpu_a, initial, n);
-        double start_ms = now_ms();
+    free(b.cur);
+    free(b.next);
+}
 
-        for (int t = 0; t < iters; ++t) {
-            gol_cpu_step(cpu_a, cpu_b, rows, cols, wrap);
-            unsigned char* tmp = cpu_a;
-            cpu_a = cpu_b;
-            cpu_b = tmp;
-        }
+// Packed words of a Generations rule on the CPU engine.
+typedef struct CpuGenerations {
+    const uint32_t* initial;
+    uint32_t* cur;
+    uint32_t* next;
+    size_t words;
+    int rows;
+    int cols;
+    int iters;
+    int wrap;
+    uint32_t rule;
+    int states;
+} CpuGenerations;
+
+static int reset_cpu_generations(void* ctx) {
+    CpuGenerations* g = (CpuGenerations*)ctx;
+    memcpy(g->cur, g->initial, g->words * sizeof(uint32_t));
+    return 1;
+}
 
-        double elapsed_ms = now_ms() - start_ms;
-        if (run >= warmup) wall_sum += elapsed_ms;
+static int step_cpu_generations(void* ctx) {
+    CpuGenerations* g = (CpuGenerations*)ctx;
+    for (int t = 0; t < g->iters; ++t) {
+        gol_gens_step(g->cur, g->next, g->rows, g->cols, g->wrap, g->rule, g->states);
+        uint32_t* tmp = g->cur;
+        g->cur = g->next;
+        g->next = tmp;
     }
+    return 1;
+}
 
-    memcpy(result, cpu_a, n);
-    *avg_wall_total_ms = wall_sum / (double)repeat;
+// Run a Generations rule on the packed CPU engine and measure its wall-clock time.
+static void run_cpu_generations(const unsigned char* initial,
+                                unsigned char* result,
+                                int rows,
+                                int cols,
+                                int iters,
+                                int wrap,
+                                uint32_t rule,
+                                int states,
+                                int repeat,
+                                int warmup,
+                                GolPerf* perf,
+                                CpuTiming* timing)
+{
+    const int bits = gol_gens_bits_per_cell(states);
+    const size_t words = (size_t)rows * gol_gens_words_per_row(cols, bits);
+    uint32_t* initial_packed = (uint32_t*)malloc(words * sizeof(uint32_t));
+    CpuGenerations g = {
+        initial_packed, (uint32_t*)malloc(words * sizeof(uint32_t)), (uint32_t*)malloc(words * sizeof(uint32_t)),
+        words, rows, cols, iters, wrap, rule, states
+    };
+    if (!initial_packed || !g.cur || !g.next) {
+        fprintf(stderr, "CPU benchmark allocation failed.\n");
+        free(initial_packed);
+        free(g.cur);
+        free(g.next);
+        exit(1);
+    }
+    gol_gens_pack(initial, initial_packed, rows, cols, bits);
 
-    free(cpu_a);
-    free(cpu_b);
+    const CpuRunner runner = { reset_cpu_generations, step_cpu_generations, &g };
+    if (!time_cpu_runs(&runner, repeat, warmup, perf, timing)) exit(1);
+    gol_gens_unpack(g.cur, result, rows, cols, bits);
+
+    free(initial_packed);
+    free(g.cur);
+    free(g.next);
+}
+
+static int step_cpu_par(void* ctx) {
+    CpuBoards* b = (CpuBoards*)ctx;
+    unsigned char* final_grid = gol_cpu_par_run(b->pool, b->cur, b->next, b->rows, b->cols, b->iters, b->wrap, b->rule);
+    if (!final_grid) {
+        fprintf(stderr, "CPU parallel engine allocation failed.\n");
+        return 0;
+    }
+    // The engine ping-pongs between both boards; keep the final one as cur for the result.
+    if (final_grid != b->cur) {
+        b->next = b->cur;
+        b->cur = final_grid;
+    }
+    return 1;
+}
+
+// Run the multithreaded CPU engine and measure its wall-clock time.
+static int run_cpu_par(const unsigned char* initial,
+                       unsigned char* result,
+                       int rows,
+                       int cols,
+                       int iters,
+                       int wrap,
+                       uint32_t rule,
+                       int threads,
+                       int repeat,
+                       int warmup,
+                       CpuTiming* timing,
+                       int* used_threads)
+{
+    const size_t n = (size_t)rows * (size_t)cols;
+    CpuBoards b = { initial, (unsigned char*)malloc(n), (unsigned char*)malloc(n), n, rows, cols, iters, wrap, rule,
+                    gol_cpu_pool_create(threads) };
+    if (!b.cur || !b.next || !b.pool) {
+        fprintf(stderr, "CPU parallel engine setup failed.\n");
+        free(b.cur);
+        free(b.next);
+        gol_cpu_pool_destroy(b.pool);
+        return 0;
+    }
+
+    // The pool is created once so warmup and measured runs reuse the same threads.
+    const CpuRunner runner = { reset_cpu_boards, step_cpu_par, &b };
+    const int ok = time_cpu_runs(&runner, repeat, warmup, NULL, timing);
+    if (ok) memcpy(result, b.cur, n);
+    *used_threads = gol_cpu_pool_threads(b.pool);
+
+    gol_cpu_pool_destroy(b.pool);
+    free(b.cur);
+    free(b.next);
+    return ok;
+}
+
+// HashLife state of one run; each run starts from a fresh node cache.
+typedef struct CpuHashlife {
+    const unsigned char* initial;
+    unsigned char* board;
+    int rows;
+    int cols;
+    int iters;
+    uint32_t rule;
+    GolHashlife* hl;
+    size_t node_count;
+} CpuHashlife;
+
+static int reset_hashlife(void* ctx) {
+    CpuHashlife* h = (CpuHashlife*)ctx;
+    // A reused cache would already hold every result, so each run starts cold.
+    gol_hashlife_destroy(h->hl);
+    h->hl = gol_hashlife_create(h->rule);
+    if (!h->hl) {
+        fprintf(stderr, "HashLife engine allocation failed.\n");
+        return 0;
+    }
+    memcpy(h->board, h->initial, (size_t)h->rows * (size_t)h->cols);
+    return 1;
+}
+
+static int step_hashlife(void* ctx) {
+    CpuHashlife* h = (CpuHashlife*)ctx;
+    const int rc = gol_hashlife_run(h->hl, h->board, h->rows, h->cols, (uint64_t)h->iters);
+    h->node_count = gol_hashlife_node_count(h->hl);
+    if (rc != 0) {
+        fprintf(stderr, "HashLife engine ran out of memory.\n");
+        return 0;
+    }
+    return 1;
+}
+
+// Run the HashLife engine with a fresh node cache per run and measure its wall-clock time.
+static int run_hashlife(const unsigned char* initial,
+                        unsigned char* result,
+                        int rows,
+                        int cols,
+                        int iters,
+                        uint32_t rule,
+                        int repeat,
+                        int warmup,
+                        CpuTiming* timing,
+                        size_t* node_count)
+{
+    CpuHashlife h = { initial, result, rows, cols, iters, rule, NULL, 0 };
+    const CpuRunner runner = { reset_hashlife, step_hashlife, &h };
+    const int ok = time_cpu_runs(&runner, repeat, warmup, NULL, timing);
+    *node_count = h.node_count;
+    gol_hashlife_destroy(h.hl);
+    return ok;
+}
+
+// Fraction of live cells in a random board unless --density says otherwise.
+#define DEFAULT_DENSITY 0.5
+
+// Fill the initial board from --load, or from the seeded generator when no file was given.
+static int init_board(unsigned char* grid, int rows, int cols, unsigned int seed, double density,
+                      const char* load_path, GolPatternFormat load_format)
+{
+    int rc = gol_board_init(grid, rows, cols, seed, density, load_path, load_format);
+    if (rc != 0) {
+        fprintf(stderr, "Could not load %s: %s\n", load_path, gol_pattern_error_string(rc));
+        return 0;
+    }
+    return 1;
+}
+
+// Release the initial grid, which is either heap memory or a mapped snapshot.
+static void free_initial_grid(unsigned char* grid, GolMappedFile* snapshot) {
+    if (snapshot->data) gol_unmap_file(snapshot);
+    else free(grid);
+}
+
+// Write the final board when --save was given; returns the process exit status.
+static int save_result(const char* save_path, const unsigned char* grid, int rows, int cols,
+                       uint64_t generation, unsigned int seed, int wrap, uint32_t rule, int states)
+{
+    if (!save_path) return 0;
+
+    // The text formats only know live and dead cells.
+    const GolPatternFormat format = gol_pattern_format_for_path(save_path);
+    if (states > 2 && format != GOL_FORMAT_SNAPSHOT) {
+        fprintf(stderr, "Could not save %s: boards with %d states can only be saved as snapshots\n", save_path, states);
+        return 1;
+    }
+
+    GolSnapshotHeader meta;
+    memset(&meta, 0, sizeof(meta));
+    meta.generation = generation;
+    meta.seed = seed;
+    meta.wrap = (uint32_t)wrap;
+    gol_rule_format(rule, states, meta.rule, sizeof(meta.rule));
+
+    int rc = gol_pattern_save(save_path, format, grid, rows, cols, &meta);
+    if (rc != 0) {
+        fprintf(stderr, "Could not save %s: %s\n", save_path, gol_pattern_error_string(rc));
+        return 1;
+    }
+    printf("Saved: %s (%s, generation %llu)\n", save_path, gol_pattern_format_name(format), (unsigned long long)generation);
+    return 0;
 }
 
 // Compare the GPU result against the CPU reference implementation.
@@ -268,7 +687,9 @@ static int validate_against_cpu(const unsigned char* initial,
                                 int rows,
                                 int cols,
                                 int iters,
-                                int wrap)
+                                int wrap,
+                                uint32_t rule,
+                                int states)
 {
     const size_t n = (size_t)rows * (size_t)cols;
     unsigned char* cpu_a = (unsigned char*)malloc(n);
@@ -284,7 +705,7 @@ static int validate_against_cpu(const unsigned char* initial,
     memcpy(cpu_a, initial, n);
     // Run the same number of iterations on the CPU for validation.
     for (int t = 0; t < iters; ++t) {
-        gol_cpu_step(cpu_a, cpu_b, rows, cols, wrap);
+        gol_cpu_step(cpu_a, cpu_b, rows, cols, wrap, rule, states);
         unsigned char* tmp = cpu_a;
         cpu_a = cpu_b;
         cpu_b = tmp;
@@ -317,19 +738,487 @@ static int validate_against_cpu(const unsigned char* initial,
     return 1;
 }
 
+/*
+ * Global memory traffic of one cell update, modelled from each kernel's access
+ * pattern under perfect on-chip reuse: the state is read and written once per
+ * launch, a work-group also reads its halo, and the bit-packed layouts move
+ * 1 or bits bits per cell. Sparse runs only touch their active tiles.
+ */
+static double model_bytes_per_cell(int tiled, int packed, int gens_bits, int steps_per_launch,
+                                   size_t lx, size_t ly, double active_fraction) {
+    if (packed) return 2.0 / 8.0;
+    if (gens_bits > 0) return 2.0 * (double)gens_bits / 8.0;
+    double read = 1.0;
+    if (tiled) {
+        const double k = (double)steps_per_launch;
+        read = ((double)lx + 2.0 * k) * ((double)ly + 2.0 * k) / ((double)lx * (double)ly);
+    }
+    return (read + 1.0) / (double)steps_per_launch * active_fraction;
+}
+
+// Bytes moved by each copy of the bandwidth probe; smaller when the device cannot allocate it.
+#define COPY_PROBE_BYTES ((size_t)64 << 20)
+#define COPY_PROBE_RUNS 5
+
+/*
+ * Measure the copy bandwidth of a device with the STREAM-like gol_copy kernel:
+ * the best of a few timed runs after one warmup, counting the bytes read plus
+ * written. Returns GB/s, or 0 when the probe could not run.
+ */
+static double measure_copy_bandwidth(cl_context context, cl_device_id device, cl_command_queue queue,
+                                     const char* kernel_dir, const char* kernel_cache) {
+    cl_int err;
+    cl_ulong max_alloc = 0;
+    clGetDeviceInfo(device, CL_DEVICE_MAX_MEM_ALLOC_SIZE, sizeof(max_alloc), &max_alloc, NULL);
+    size_t bytes = COPY_PROBE_BYTES;
+    if (max_alloc > 0 && bytes > (size_t)max_alloc) bytes = (size_t)max_alloc & ~(size_t)15;
+    if (bytes < 16) return 0.0;
+
+    int loader_err = 0;
+    char* src = load_kernel("gol_bandwidth.cl", kernel_dir, &loader_err);
+    if (loader_err != 0 || !src) {
+        gol_print_kernel_load_error("gol_bandwidth.cl", kernel_dir, loader_err);
+        return 0.0;
+    }
+    // The probe's build is not part of the run's program build statistics.
+    GolBuildStats build = {0, 0, 0.0, 0};
+    cl_program program = gol_build_program(context, device, src, "", kernel_cache, &build, &err);
+    if (!program) gol_die_cl("clBuildProgram", err);
+    free(src);
+    cl_kernel kernel = clCreateKernel(program, "gol_copy", &err);
+    if (!kernel || err != CL_SUCCESS) gol_die_cl("clCreateKernel(gol_copy)", err);
+
+    cl_mem d_src = clCreateBuffer(context, CL_MEM_READ_WRITE, bytes, NULL, &err);
+    cl_mem d_dst = d_src ? clCreateBuffer(context, CL_MEM_READ_WRITE, bytes, NULL, &err) : NULL;
+    double best_ns = 0.0;
+    if (d_src && d_dst) {
+        const cl_uchar zero = 0;
+        err  = clEnqueueFillBuffer(queue, d_src, &zero, sizeof(zero), 0, bytes, 0, NULL, NULL);
+        err |= clSetKernelArg(kernel, 0, sizeof(cl_mem), &d_src);
+        err |= clSetKernelArg(kernel, 1, sizeof(cl_mem), &d_dst);
+        if (err != CL_SUCCESS) gol_die_cl("gol_copy setup", err);
+        const size_t global = bytes / 16;
+        for (int run = 0; run <= COPY_PROBE_RUNS; ++run) {
+            cl_event ev;
+            err = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, &global, NULL, 0, NULL, &ev);
+            if (err != CL_SUCCESS) gol_die_cl("clEnqueueNDRangeKernel(gol_copy)", err);
+            clWaitForEvents(1, &ev);
+            const double ns = (double)gol_event_ns(ev);
+            clReleaseEvent(ev);
+            if (run > 0 && ns > 0.0 && (best_ns == 0.0 || ns < best_ns)) best_ns = ns;
+        }
+    }
+    if (d_src) clReleaseMemObject(d_src);
+    if (d_dst) clReleaseMemObject(d_dst);
+    clReleaseKernel(kernel);
+    clReleaseProgram(program);
+    return best_ns > 0.0 ? 2.0 * (double)bytes / best_ns : 0.0;
+}
+
+// Generate the seeded random board of n cells into a device buffer with gol_random_fill.
+// Returns the profiled kernel time in ms.
+static double fill_random_board(cl_context context, cl_device_id device, cl_command_queue queue, cl_mem grid,
+                                size_t n, unsigned int seed, double density,
+                                const char* kernel_dir, const char* kernel_cache, GolTrace* trace) {
+    cl_int err;
+    int loader_err = 0;
+    char* src = load_kernel("gol_random.cl", kernel_dir, &loader_err);
+    if (loader_err != 0 || !src) {
+        gol_print_kernel_load_error("gol_random.cl", kernel_dir, loader_err);
+        exit(1);
+    }
+    // Like the bandwidth probe, this build is not part of the run's program build statistics.
+    GolBuildStats build = {0, 0, 0.0, 0};
+    cl_program program = gol_build_program(context, device, src, "", kernel_cache, &build, &err);
+    if (!program) gol_die_cl("clBuildProgram", err);
+    free(src);
+    cl_kernel kernel = clCreateKernel(program, "gol_random_fill", &err);
+    if (!kernel || err != CL_SUCCESS) gol_die_cl("clCreateKernel(gol_random_fill)", err);
+
+    const cl_ulong cells = (cl_ulong)n;
+    const cl_ulong key = (cl_ulong)gol_random_key(seed);
+    const cl_ulong threshold = (cl_ulong)gol_random_threshold(density);
+    err  = clSetKernelArg(kernel, 0, sizeof(cl_mem), &grid);
+    err |= clSetKernelArg(kernel, 1, sizeof(cl_ulong), &cells);
+    err |= clSetKernelArg(kernel, 2, sizeof(cl_ulong), &key);
+    err |= clSetKernelArg(kernel, 3, sizeof(cl_ulong), &threshold);
+    if (err != CL_SUCCESS) gol_die_cl("clSetKernelArg(gol_random_fill)", err);
+
+    const size_t global = gol_round_up(n, 256);
+    cl_event ev;
+    err = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, &global, NULL, 0, NULL, &ev);
+    if (err != CL_SUCCESS) gol_die_cl("clEnqueueNDRangeKernel(gol_random_fill)", err);
+    clWaitForEvents(1, &ev);
+    const double ms = (double)gol_event_ns(ev) / 1e6;
+    if (trace) gol_trace_command(trace, "gol_random_fill", "kernel", ev);
+    clReleaseEvent(ev);
+    clReleaseKernel(kernel);
+    clReleaseProgram(program);
+    return ms;
+}
+
+// Profiled time of one write and one read of a plain device buffer, the transfers zero-copy mode replaces.
+// Both go through the host buffer staging, zeroed first: a device-generated board never exists on the host.
+static double measure_transfer_ms(cl_context context, cl_command_queue queue, size_t bytes, void* staging) {
+    cl_int err;
+    memset(staging, 0, bytes);
+    cl_mem probe = clCreateBuffer(context, CL_MEM_READ_WRITE, bytes, NULL, &err);
+    if (!probe || err != CL_SUCCESS) gol_die_cl("clCreateBuffer(transfer probe)", err);
+    cl_event ev[2];
+    err  = clEnqueueWriteBuffer(queue, probe, CL_TRUE, 0, bytes, staging, 0, NULL, &ev[0]);
+    err |= clEnqueueReadBuffer(queue, probe, CL_TRUE, 0, bytes, staging, 0, NULL, &ev[1]);
+    if (err != CL_SUCCESS) gol_die_cl("transfer probe", err);
+    const double ms = (double)(gol_event_ns(ev[0]) + gol_event_ns(ev[1])) / 1e6;
+    clReleaseEvent(ev[0]);
+    clReleaseEvent(ev[1]);
+    clReleaseMemObject(probe);
+    return ms;
+}
+
+// Print cell updates per second and, with a traffic model, the effective and relative bandwidth.
+static void print_throughput(int rows, int cols, int iters, double kernel_ms, double model_bytes, double peak_gb_s) {
+    const double cups = cell_updates_per_s(rows, cols, iters, kernel_ms);
+    if (cups <= 0.0) return;
+    printf("Cell updates per second: %.3e\n", cups);
+    if (model_bytes <= 0.0) return;
+    const double gb_s = cups * model_bytes / 1e9;
+    printf("Effective bandwidth: %.3f GB/s (%.4f bytes per cell update)", gb_s, model_bytes);
+    if (peak_gb_s > 0.0) printf(", %.1f%% of the %.3f GB/s copy peak", 100.0 * gb_s / peak_gb_s, peak_gb_s);
+    printf("\n");
+}
+
+// Generations each autotune candidate is profiled for; a multiple of every tried steps-per-launch.
+#define AUTOTUNE_GENERATIONS 16
+
+// Kernel variants tried by --autotune, grouped by source file so each program is built once.
+typedef struct AutotuneVariant {
+    const char* file;
+    const char* kernel;
+    const char* label;
+    int tiled;
+    int packed;
+    int steps_per_launch;
+} AutotuneVariant;
+
+static const AutotuneVariant autotune_variants[] = {
+    { "gol_naive.cl",  "gol_step",             "naive",           0, 0, 1 },
+    { "gol_tiled.cl",  "gol_step_tiled",       "tiled",           1, 0, 1 },
+    { "gol_tiled.cl",  "gol_step_tiled_multi", "tiled, 2 steps",  1, 0, 2 },
+    { "gol_tiled.cl",  "gol_step_tiled_multi", "tiled, 4 steps",  1, 0, 4 },
+    { "gol_tiled.cl",  "gol_step_tiled_multi", "tiled, 8 steps",  1, 0, 8 },
+    { "gol_packed.cl", "gol_step_packed",      "packed",          0, 1, 1 }
+};
+
+/*
+ * Profile AUTOTUNE_GENERATIONS generations from the initial board for every kernel
+ * variant and power-of-two local size within the kernel's work-group limit and the
+ * device's work-item sizes, and return the configuration with the lowest kernel time
+ * per generation. Each candidate gets one untimed launch first and starts from a
+ * fresh upload, so all candidates see the same board.
+ */
+static GolTuning autotune_gpu(cl_device_id device, const unsigned char* initial,
+                              int rows, int cols, int wrap, uint32_t rule,
+                              const char* kernel_dir, const char* kernel_cache)
+{
+    cl_int err;
+    size_t max_wi[3] = {0, 0, 0};
+    cl_ulong local_mem = 0;
+    clGetDeviceInfo(device, CL_DEVICE_MAX_WORK_ITEM_SIZES, sizeof(max_wi), max_wi, NULL);
+    clGetDeviceInfo(device, CL_DEVICE_LOCAL_MEM_SIZE, sizeof(local_mem), &local_mem, NULL);
+
+    cl_context context = clCreateContext(NULL, 1, &device, NULL, NULL, &err);
+    if (!context || err != CL_SUCCESS) gol_die_cl("clCreateContext(autotune)", err);
+    const cl_queue_properties props[] = { CL_QUEUE_PROPERTIES, (cl_queue_properties)CL_QUEUE_PROFILING_ENABLE, 0 };
+    cl_command_queue queue = clCreateCommandQueueWithProperties(context, device, props, &err);
+    if (!queue || err != CL_SUCCESS) gol_die_cl("clCreateCommandQueueWithProperties(autotune)", err);
+
+    // Both layouts share the buffers, so they are sized for the larger one.
+    const size_t n = (size_t)rows * (size_t)cols;
+    const size_t words_per_row = gol_packed_words_per_row(cols);
+    const size_t packed_bytes = (size_t)rows * words_per_row * sizeof(cl_ulong);
+    const size_t buf_bytes = packed_bytes > n ? packed_bytes : n;
+    uint64_t* packed_initial = (uint64_t*)malloc(packed_bytes);
+    if (!packed_initial) {
+        fprintf(stderr, "Host allocation failed (autotune)\n");
+        exit(1);
+    }
+    gol_pack_grid(initial, packed_initial, rows, cols);
+
+    cl_mem d_a = clCreateBuffer(context, CL_MEM_READ_WRITE, buf_bytes, NULL, &err);
+    if (!d_a || err != CL_SUCCESS) gol_die_cl("clCreateBuffer(autotune)", err);
+    cl_mem d_b = clCreateBuffer(context, CL_MEM_READ_WRITE, buf_bytes, NULL, &err);
+    if (!d_b || err != CL_SUCCESS) gol_die_cl("clCreateBuffer(autotune)", err);
+
+    char build_options[64];
+    gol_rule_build_options(rule, 2, build_options, sizeof(build_options));
+    GolBuildStats build = {0, 0, 0.0, 0};
+    cl_program program = NULL;
+    cl_event events[AUTOTUNE_GENERATIONS];
+
+    GolTuning best;
+    memset(&best, 0, sizeof(best));
+    int tried = 0;
+    const double t0 = gol_now_ms();
+
+    const int n_variants = (int)(sizeof(autotune_variants) / sizeof(autotune_variants[0]));
+    for (int v = 0; v < n_variants; ++v) {
+        const AutotuneVariant* var = &autotune_variants[v];
+        if (!program || strcmp(var->file, autotune_variants[v - 1].file) != 0) {
+            if (program) clReleaseProgram(program);
+            int loader_err = 0;
+            char* src = load_kernel(var->file, kernel_dir, &loader_err);
+            if (loader_err != 0 || !src) {
+                gol_print_kernel_load_error(var->file, kernel_dir, loader_err);
+                exit(1);
+            }
+            program = gol_build_program(context, device, src, build_options, kernel_cache, &build, &err);
+            if (!program) gol_die_cl("clBuildProgram", err);
+            free(src);
+        }
+        cl_kernel kernel = clCreateKernel(program, var->kernel, &err);
+        if (!kernel || err != CL_SUCCESS) gol_die_cl("clCreateKernel(autotune)", err);
+
+        // Local memory kernels may allow fewer work-items per group than the device maximum.
+        size_t kernel_wg = 0;
+        clGetKernelWorkGroupInfo(kernel, device, CL_KERNEL_WORK_GROUP_SIZE, sizeof(kernel_wg), &kernel_wg, NULL);
+        const int multi_step = var->steps_per_launch > 1;
+        const size_t extent_y = var->packed ? words_per_row : (size_t)cols;
+        GolTuning var_best;
+        memset(&var_best, 0, sizeof(var_best));
+
+        for (size_t lx = 1; lx <= max_wi[0] && lx <= kernel_wg; lx *= 2) {
+            for (size_t ly = 1; ly <= max_wi[1] && lx * ly <= kernel_wg; ly *= 2) {
+                // Tiny groups waste the device; groups far wider than the board only add padding.
+                if (lx * ly < 16 && lx * ly < kernel_wg) continue;
+                if (lx >= 2 * (size_t)rows || ly >= 2 * extent_y) continue;
+                const size_t halo = 2u * (size_t)var->steps_per_launch;
+                if (var->tiled && (multi_step ? 2u : 1u) * (lx + halo) * (ly + halo) > (size_t)local_mem) continue;
+
+                const size_t global[2] = { gol_round_up((size_t)rows, lx), gol_round_up(extent_y, ly) };
+                const size_t local[2] = { lx, ly };
+                const void* upload = var->packed ? (const void*)packed_initial : (const void*)initial;
+                err = clEnqueueWriteBuffer(queue, d_a, CL_TRUE, 0, var->packed ? packed_bytes : n, upload, 0, NULL, NULL);
+                if (err != CL_SUCCESS) gol_die_cl("clEnqueueWriteBuffer(autotune)", err);
+
+                // The untimed launch absorbs first-use costs; an unsupported shape is skipped.
+                err  = gol_set_step_args(kernel, d_a, d_b, rows, cols, wrap, var->tiled, multi_step,
+                                     var->steps_per_launch, lx, ly);
+                err |= clEnqueueNDRangeKernel(queue, kernel, 2, NULL, global, local, 0, NULL, NULL);
+                if (err != CL_SUCCESS || clFinish(queue) != CL_SUCCESS) continue;
+
+                int launches = 0;
+                cl_mem cur = d_a;
+                cl_mem next = d_b;
+                for (int t = 0; t < AUTOTUNE_GENERATIONS; t += var->steps_per_launch) {
+                    err = gol_set_step_args(kernel, cur, next, rows, cols, wrap, var->tiled, multi_step,
+                                        var->steps_per_launch, lx, ly);
+                    if (err != CL_SUCCESS) gol_die_cl("clSetKernelArg(autotune)", err);
+                    err = clEnqueueNDRangeKernel(queue, kernel, 2, NULL, global, local, 0, NULL, &events[launches]);
+                    if (err != CL_SUCCESS) gol_die_cl("clEnqueueNDRangeKernel(autotune)", err);
+                    ++launches;
+                    cl_mem tmp = cur;
+                    cur = next;
+                    next = tmp;
+                }
+                clFinish(queue);
+                cl_ulong kernel_ns = 0;
+                for (int k = 0; k < launches; ++k) {
+                    kernel_ns += gol_event_ns(events[k]);
+                    clReleaseEvent(events[k]);
+                }
+                ++tried;
+
+                const double ms_per_gen = (double)kernel_ns / 1e6 / (double)AUTOTUNE_GENERATIONS;
+                if (var_best.lx == 0 || ms_per_gen < var_best.ms_per_gen) {
+                    var_best.lx = (int)lx;
+                    var_best.ly = (int)ly;
+                    var_best.tiled = var->tiled;
+                    var_best.packed = var->packed;
+                    var_best.steps_per_launch = var->steps_per_launch;
+                    var_best.ms_per_gen = ms_per_gen;
+                }
+            }
+        }
+        clReleaseKernel(kernel);
+
+        if (var_best.lx == 0) {
+            printf("Autotune %-15s no valid local size\n", var->label);
+            continue;
+        }
+        printf("Autotune %-15s best %d x %d at %.6f ms per generation\n",
+               var->label, var_best.lx, var_best.ly, var_best.ms_per_gen);
+        if (best.lx == 0 || var_best.ms_per_gen < best.ms_per_gen) best = var_best;
+    }
+
+    if (best.lx == 0) {
+        fprintf(stderr, "Autotune found no configuration that runs on this device.\n");
+        exit(1);
+    }
+    printf("Autotune: %d configurations in %.3f ms (program builds %.3f ms)\n",
+           tried, gol_now_ms() - t0, build.build_ms);
+
+    clReleaseProgram(program);
+    clReleaseMemObject(d_a);
+    clReleaseMemObject(d_b);
+    clReleaseCommandQueue(queue);
+    clReleaseContext(context);
+    free(packed_initial);
+    return best;
+}
+
+// What the bench report callback needs besides the point itself.
+typedef struct BenchReport {
+    const GolBenchSpec* spec;
+    const char* rule_name;
+    double peak_gb_s;          // copy bandwidth measured once per sweep with --roofline
+} BenchReport;
+
+static double bench_mean(const double* v, int n) {
+    double sum = 0.0;
+    for (int i = 0; i < n; ++i) sum += v[i];
+    return sum / (double)n;
+}
+
+// Print and record one finished point; the spreads sort the sample arrays. Returns 0 when the row could not be written.
+static int bench_report(const GolBenchPoint* point, void* ctx) {
+    const BenchReport* report = (const BenchReport*)ctx;
+    const int n = report->spec->repeat;
+    const int gpu = point->mode >= GOL_BENCH_NAIVE;
+    CsvRow row;
+    memset(&row, 0, sizeof(row));
+    row.mode = point->mode == GOL_BENCH_CPU_SEQ ? MODE_CPU_SEQ : point->mode == GOL_BENCH_CPU_PAR ? MODE_CPU_PAR : MODE_GPU;
+    row.rows = point->rows;
+    row.cols = point->cols;
+    row.iters = point->iters;
+    row.wrap = point->wrap;
+    row.lx = point->lx;
+    row.ly = point->ly;
+    row.tiled = point->mode == GOL_BENCH_TILED;
+    row.packed = point->mode == GOL_BENCH_PACKED;
+    row.steps_per_launch = point->steps_per_launch;
+    row.rule = report->rule_name;
+    row.states = 2;
+    if (gpu) {
+        row.kernel_cache = gol_build_label(&point->build);
+        row.build_ms = point->build.build_ms;
+        row.gen_hist = point->gen_hist;
+        row.model_bytes_per_cell = model_bytes_per_cell(row.tiled, row.packed, 0, row.steps_per_launch, row.lx, row.ly, 1.0);
+        row.peak_gb_s = report->peak_gb_s;
+    }
+
+    row.h2d_ms = point->h2d_ms ? bench_mean(point->h2d_ms, n) : 0.0;
+    row.kernel_ms = bench_mean(point->kernel_ms, n);
+    row.d2h_ms = point->d2h_ms ? bench_mean(point->d2h_ms, n) : 0.0;
+    row.total_ms = row.h2d_ms + row.kernel_ms + row.d2h_ms;
+    row.wall_total_ms = bench_mean(point->wall_ms, n);
+    row.kernel_spread = run_spread(point->kernel_ms, n);
+    row.wall_spread = run_spread(point->wall_ms, n);
+
+    printf("%-10s %5d x %-5d iters=%-5d wrap=%d local=%ux%u k=%d  kernel mean %.3f median %.3f p95 %.3f sd %.3f ms",
+           mode_to_csv_name(row.mode, row.tiled, row.packed, 0, 2), row.rows, row.cols, row.iters, row.wrap,
+           (unsigned)row.lx, (unsigned)row.ly, row.steps_per_launch,
+           row.kernel_ms, row.kernel_spread.median, row.kernel_spread.p95, row.kernel_spread.stddev);
+    if (row.gen_hist) printf(", p99 %.3f us/gen", (double)gol_hist_quantile(row.gen_hist, 0.99) / 1e3);
+    printf("\n");
+    return !report->spec->out_path || append_csv_row(report->spec->out_path, &row);
+}
+
+// "bench" subcommand: the sweep itself lives in gol_bench.c; this front end owns the
+// engine, the roofline probe and the printed and CSV report of every point.
+static int run_bench(int argc, char** argv, const char* argv0) {
+    GolBenchSpec spec;
+    const int parsed = gol_bench_parse(&spec, argc, argv, argv0);
+    if (parsed != 0) return parsed < 0 ? 1 : 0;
+    char rule_name[32];
+    gol_rule_format(spec.rule, 2, rule_name, sizeof(rule_name));
+    BenchReport report = { &spec, rule_name, 0.0 };
+
+    // The OpenCL engine is only created when the sweep has a GPU mode.
+    GolEngine* engine = NULL;
+    if (gol_bench_needs_gpu(&spec)) {
+        GolEngineConfig engine_config = { .kernel_dir = spec.kernel_dir, .cache_dir = spec.kernel_cache, .profile = 1 };
+        int engine_err = 0;
+        engine = gol_engine_create(&engine_config, &engine_err);
+        if (!engine) {
+            if (engine_err == GOL_ENGINE_ENODEV) fprintf(stderr, "No OpenCL GPU/CPU device found.\n");
+            else fprintf(stderr, "OpenCL setup failed: %s\n", gol_engine_error_string(engine_err));
+            return 1;
+        }
+        gol_print_device_info(gol_engine_device(engine));
+        if (spec.roofline) {
+            report.peak_gb_s = measure_copy_bandwidth(gol_engine_context(engine), gol_engine_device(engine),
+                                                      gol_engine_queue(engine), spec.kernel_dir, spec.kernel_cache);
+            if (report.peak_gb_s > 0.0) printf("Copy bandwidth: %.3f GB/s\n", report.peak_gb_s);
+            else fprintf(stderr, "Copy bandwidth probe failed; the roofline columns stay empty.\n");
+        }
+    }
+
+    int skipped = 0;
+    const double sweep_start_ms = gol_now_ms();
+    const int points = gol_bench_run(&spec, engine, bench_report, &report, &skipped);
+    if (points >= 0) {
+        const GolBuildStats none = { 0 };
+        const GolBuildStats* build = engine ? gol_engine_build_stats(engine) : &none;
+        printf("Bench: %d points (%d skipped) in %.3f ms, program builds %.3f ms (kernel cache %s)%s%s\n",
+               points, skipped, gol_now_ms() - sweep_start_ms, build->build_ms, gol_build_label(build),
+               spec.out_path ? ", results in " : "", spec.out_path ? spec.out_path : "");
+    }
+    gol_engine_destroy(engine);
+    return points >= 0 ? 0 : 1;
+}
+
 // Print the command-line usage and default parameter values.
 static void usage(const char* argv0) {
-    printf("Usage: %s [--rows N] [--cols N] [--iters N] [--seed N] [--wrap 0|1] [--mode gpu|cpu_seq] [--tiled 0|1] [--lx N] [--ly N] [--validate 0|1] [--csv] [--out FILE] [--repeat N] [--warmup N]\n", argv0);
-    printf("Defaults: rows=1024 cols=1024 iters=500 seed=time wrap=0 mode=gpu tiled=0 lx=16 ly=16 validate=0 repeat=1 warmup=0\n");
+    printf("Usage: %s [--rows N] [--cols N] [--iters N] [--seed N] [--density D] [--wrap 0|1] [--rule B3/S23] [--mode gpu|cpu_seq|cpu_par|hashlife|multi|stream] [--threads N] [--devices N] [--split-device 0|1] [--board-file FILE] [--band-rows N] [--band-steps K] [--load FILE] [--save FILE] [--checkpoint-every N] [--checkpoint-file FILE] [--resume FILE] [--frames-every N] [--frame-scale S] [--frames-out PREFIX|-] [--kernel-cache 0|1] [--kernel-cache-dir DIR] [--kernel-dir DIR] [--tiled 0|1] [--packed 0|1] [--steps-per-launch K] [--pipeline 0|1] [--sparse 0|1] [--zero-copy 0|1] [--lx N] [--ly N] [--autotune] [--tuning-db FILE] [--use-tuning 0|1] [--validate 0|1] [--csv] [--out FILE] [--repeat N] [--warmup N] [--iter-trace FILE] [--trace FILE] [--perf 0|1] [--roofline] [--stop-on-stable] [--stop-on-period P] [--gen-stats FILE]\n", argv0);
+    printf("Defaults: rows=1024 cols=1024 iters=500 seed=time density=0.5 wrap=0 mode=gpu threads=all devices=2 split-device=0 board-file=temporary band-rows=auto band-steps=4 load=random save=none frames-every=0 frame-scale=auto frames-out=frame kernel-cache=1 kernel-cache-dir=none kernel-dir=embedded tiled=0 packed=0 steps-per-launch=1 pipeline=0 sparse=0 zero-copy=0 lx=16 ly=16 tuning-db=none use-tuning=1 validate=0 repeat=1 warmup=0 iter-trace=none trace=none perf=0 stop-on-period=0 gen-stats=none\n");
+    printf("   or: %s bench --help for the in-process benchmark sweep\n", argv0);
 }
 
 int main(int argc, char** argv) {
+    // "gol_opencl bench ..." runs a whole measurement sweep in this process.
+    if (argc > 1 && !strcmp(argv[1], "bench")) return run_bench(argc - 1, argv + 1, argv[0]);
+
     int rows = 1024;
     int cols = 1024;
     int iters = 500;
     unsigned int seed = (unsigned int)time(NULL);
+    double density = DEFAULT_DENSITY;
     int wrap = 0;
+    const char* rule_arg = NULL;
     int tiled = 0;
+    int packed = 0;
+    int steps_per_launch = 1;
+    int threads = 0;
+    int devices = 2;
+    int split_device = 0;
+    const char* board_file = NULL;
+    int band_rows = 0;
+    int band_steps = 4;
+    const char* load_path = NULL;
+    const char* save_path = NULL;
+    int checkpoint_every = 0;
+    const char* checkpoint_path = "gol_checkpoint.snap";
+    int frames_every = 0;
+    int frame_scale = 0;
+    const char* frames_out = "frame";
+    const char* resume_path = NULL;
+    int kernel_cache_on = 1;
+    const char* kernel_cache_dir = NULL;
+    const char* kernel_dir = NULL;
+    int autotune = 0;
+    const char* iter_trace_path = NULL;
+    const char* trace_path = NULL;
+    int perf_on = 0;
+    int roofline = 0;
+    int stop_on_stable = 0;
+    int zero_copy = 0;
+    int stop_on_period = 0;
+    const char* gen_stats_path = NULL;
+    const char* tuning_db = NULL;
+    int use_tuning = 1;
+    int rows_set = 0, cols_set = 0, wrap_set = 0, launch_set = 0;
+    int pipeline = 0;
+    int sparse = 0;
     int validate = 0;
     int csv = 0;
     int lx_arg = 16;
@@ -341,19 +1230,57 @@ int main(int argc, char** argv) {
 
     // Parse command-line arguments and override defaults.
     for (int i = 1; i < argc; ++i) {
-        if (!strcmp(argv[i], "--rows") && i + 1 < argc) rows = atoi(argv[++i]);
-        else if (!strcmp(argv[i], "--cols") && i + 1 < argc) cols = atoi(argv[++i]);
+        if (!strcmp(argv[i], "--rows") && i + 1 < argc) { rows = atoi(argv[++i]); rows_set = 1; }
+        else if (!strcmp(argv[i], "--cols") && i + 1 < argc) { cols = atoi(argv[++i]); cols_set = 1; }
         else if (!strcmp(argv[i], "--iters") && i + 1 < argc) iters = atoi(argv[++i]);
         else if (!strcmp(argv[i], "--seed") && i + 1 < argc) seed = (unsigned int)strtoul(argv[++i], NULL, 10);
-        else if (!strcmp(argv[i], "--wrap") && i + 1 < argc) wrap = atoi(argv[++i]);
-        else if (!strcmp(argv[i], "--tiled") && i + 1 < argc) tiled = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--density") && i + 1 < argc) density = strtod(argv[++i], NULL);
+        else if (!strcmp(argv[i], "--wrap") && i + 1 < argc) { wrap = atoi(argv[++i]); wrap_set = 1; }
+        else if (!strcmp(argv[i], "--rule") && i + 1 < argc) rule_arg = argv[++i];
+        else if (!strcmp(argv[i], "--tiled") && i + 1 < argc) { tiled = atoi(argv[++i]); launch_set = 1; }
+        else if (!strcmp(argv[i], "--packed") && i + 1 < argc) { packed = atoi(argv[++i]); launch_set = 1; }
+        else if (!strcmp(argv[i], "--steps-per-launch") && i + 1 < argc) { steps_per_launch = atoi(argv[++i]); launch_set = 1; }
+        else if (!strcmp(argv[i], "--pipeline") && i + 1 < argc) pipeline = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--sparse") && i + 1 < argc) sparse = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--zero-copy") && i + 1 < argc) zero_copy = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--threads") && i + 1 < argc) threads = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--devices") && i + 1 < argc) devices = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--split-device") && i + 1 < argc) split_device = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--board-file") && i + 1 < argc) board_file = argv[++i];
+        else if (!strcmp(argv[i], "--band-rows") && i + 1 < argc) band_rows = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--band-steps") && i + 1 < argc) band_steps = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--load") && i + 1 < argc) load_path = argv[++i];
+        else if (!strcmp(argv[i], "--save") && i + 1 < argc) save_path = argv[++i];
+        else if (!strcmp(argv[i], "--checkpoint-every") && i + 1 < argc) checkpoint_every = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--frames-every") && i + 1 < argc) frames_every = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--frame-scale") && i + 1 < argc) frame_scale = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--frames-out") && i + 1 < argc) frames_out = argv[++i];
+        else if (!strcmp(argv[i], "--checkpoint-file") && i + 1 < argc) checkpoint_path = argv[++i];
+        else if (!strcmp(argv[i], "--resume") && i + 1 < argc) resume_path = argv[++i];
+        else if (!strcmp(argv[i], "--kernel-cache") && i + 1 < argc) kernel_cache_on = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--kernel-cache-dir") && i + 1 < argc) kernel_cache_dir = argv[++i];
+        else if (!strcmp(argv[i], "--kernel-dir") && i + 1 < argc) kernel_dir = argv[++i];
         else if (!strcmp(argv[i], "--validate") && i + 1 < argc) validate = atoi(argv[++i]);
-        else if (!strcmp(argv[i], "--lx") && i + 1 < argc) lx_arg = atoi(argv[++i]);
-        else if (!strcmp(argv[i], "--ly") && i + 1 < argc) ly_arg = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--lx") && i + 1 < argc) { lx_arg = atoi(argv[++i]); launch_set = 1; }
+        else if (!strcmp(argv[i], "--ly") && i + 1 < argc) { ly_arg = atoi(argv[++i]); launch_set = 1; }
+        else if (!strcmp(argv[i], "--autotune")) autotune = 1;
+        else if (!strcmp(argv[i], "--roofline")) roofline = 1;
+        else if (!strcmp(argv[i], "--stop-on-stable")) stop_on_stable = 1;
+        else if (!strcmp(argv[i], "--stop-on-period") && i + 1 < argc) stop_on_period = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--gen-stats") && i + 1 < argc) gen_stats_path = argv[++i];
+        else if (!strcmp(argv[i], "--iter-trace") && i + 1 < argc) iter_trace_path = argv[++i];
+        else if (!strcmp(argv[i], "--trace") && i + 1 < argc) trace_path = argv[++i];
+        else if (!strcmp(argv[i], "--perf") && i + 1 < argc) perf_on = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--tuning-db") && i + 1 < argc) tuning_db = argv[++i];
+        else if (!strcmp(argv[i], "--use-tuning") && i + 1 < argc) use_tuning = atoi(argv[++i]);
         else if (!strcmp(argv[i], "--mode") && i + 1 < argc) {
             const char* mode_arg = argv[++i];
             if (!strcmp(mode_arg, "gpu")) mode = MODE_GPU;
             else if (!strcmp(mode_arg, "cpu_seq")) mode = MODE_CPU_SEQ;
+            else if (!strcmp(mode_arg, "cpu_par")) mode = MODE_CPU_PAR;
+            else if (!strcmp(mode_arg, "hashlife")) mode = MODE_HASHLIFE;
+            else if (!strcmp(mode_arg, "multi")) mode = MODE_MULTI;
+            else if (!strcmp(mode_arg, "stream")) mode = MODE_STREAM;
             else {
                 fprintf(stderr, "Unknown mode: %s\n", mode_arg);
                 usage(argv[0]);
@@ -372,12 +1299,94 @@ int main(int argc, char** argv) {
         }
     }
 
+    // Built program binaries are only cached in a directory named by --kernel-cache-dir, so a plain
+    // run neither reads nor writes files next to wherever it was started; --kernel-cache 0 turns it off.
+    const char* kernel_cache = kernel_cache_on ? kernel_cache_dir : NULL;
+
+    // --resume is a snapshot load that also restores the seed and treats --iters as the final generation.
+    if (resume_path) {
+        if (load_path) {
+            fprintf(stderr, "--resume and --load cannot be combined.\n");
+            return 1;
+        }
+        load_path = resume_path;
+    }
+
+    // A loaded pattern sets the board size unless --rows/--cols were given; snapshots also carry wrap.
+    GolPatternFormat load_format = GOL_FORMAT_UNKNOWN;
+    GolSnapshotHeader load_header;
+    memset(&load_header, 0, sizeof(load_header));
+    if (load_path) {
+        load_format = gol_pattern_detect(load_path);
+        if (load_format == GOL_FORMAT_UNKNOWN) {
+            fprintf(stderr, "Could not detect the format of %s\n", load_path);
+            return 1;
+        }
+        if (resume_path && load_format != GOL_FORMAT_SNAPSHOT) {
+            fprintf(stderr, "--resume needs a snapshot written by --checkpoint-every or --save: %s\n", resume_path);
+            return 1;
+        }
+        int prows = 0, pcols = 0;
+        int rc = gol_pattern_probe(load_path, load_format, &prows, &pcols, &load_header);
+        if (rc != 0) {
+            fprintf(stderr, "Could not read %s: %s\n", load_path, gol_pattern_error_string(rc));
+            return 1;
+        }
+        if (!rows_set) rows = prows;
+        if (!cols_set) cols = pcols;
+        if (load_format == GOL_FORMAT_SNAPSHOT && !wrap_set) wrap = (int)load_header.wrap;
+        if (prows > rows || pcols > cols) {
+            fprintf(stderr, "Pattern %s is %d x %d, larger than the %d x %d board.\n", load_path, prows, pcols, rows, cols);
+            return 1;
+        }
+        printf("Loaded: %s (%s, %d x %d)\n", load_path, gol_pattern_format_name(load_format), prows, pcols);
+    }
+    if (resume_path) {
+        if (load_header.generation >= (uint64_t)iters) {
+            printf("Checkpoint %s is already at generation %llu of %d; nothing to run.\n",
+                   resume_path, (unsigned long long)load_header.generation, iters);
+            return 0;
+        }
+        seed = (unsigned int)load_header.seed;
+        iters -= (int)load_header.generation;
+        printf("Resuming at generation %llu, %d generations left.\n", (unsigned long long)load_header.generation, iters);
+    }
+    const uint64_t end_generation = load_header.generation + (uint64_t)iters;
+
+    // --rule wins; otherwise a loaded snapshot or RLE header supplies the rule, else Conway's B3/S23.
+    uint32_t rule = GOL_RULE_CONWAY;
+    int states = 2;
+    const char* rule_text = rule_arg ? rule_arg : (load_header.rule[0] ? load_header.rule : NULL);
+    if (rule_text) {
+        int rc = gol_rule_parse(rule_text, &rule, &states);
+        if (rc != 0) {
+            fprintf(stderr, "%s rule: %s\n", rc == -2 ? "Unsupported (B0)" : "Malformed", rule_text);
+            return 1;
+        }
+    }
+    if (resume_path && rule_arg && load_header.rule[0]) {
+        uint32_t stored = 0;
+        int stored_states = 0;
+        if (gol_rule_parse(load_header.rule, &stored, &stored_states) != 0 || stored != rule || stored_states != states) {
+            fprintf(stderr, "--rule %s does not match the rule %s stored in %s\n", rule_arg, load_header.rule, resume_path);
+            return 1;
+        }
+    }
+    char rule_name[32];
+    gol_rule_format(rule, states, rule_name, sizeof(rule_name));
+
     // Validate the main numeric input parameters.
     if (rows <= 0 || cols <= 0 || iters <= 0) {
         fprintf(stderr, "rows/cols/iters must be > 0\n");
         return 1;
     }
 
+    // The step kernels index cells with int, so a board on one device stays below 2^31 cells.
+    if ((mode == MODE_GPU || mode == MODE_MULTI) && (uint64_t)rows * (uint64_t)cols > (uint64_t)INT_MAX) {
+        fprintf(stderr, "The OpenCL kernels run boards of at most %d cells; use --mode stream for larger boards.\n", INT_MAX);
+        return 1;
+    }
+
     // Validate the requested local work-group size.
     if (lx_arg <= 0 || ly_arg <= 0) {
         fprintf(stderr, "lx/ly must be > 0\n");
@@ -390,227 +1399,774 @@ int main(int argc, char** argv) {
         return 1;
     }
 
-    // Reject tiled execution when the program is running in CPU sequential mode.
-    if (mode == MODE_CPU_SEQ && tiled) {
-        fprintf(stderr, "CPU sequential mode does not use the tiled kernel flag.\n");
+    // Validate the live-cell fraction of random boards.
+    if (!(density >= 0.0 && density <= 1.0)) {
+        fprintf(stderr, "--density must be between 0 and 1\n");
+        return 1;
+    }
+
+    // Reject tiled execution when the program is running in a CPU mode.
+    if (mode != MODE_GPU && tiled) {
+        fprintf(stderr, "CPU modes do not use the tiled kernel flag.\n");
+        return 1;
+    }
+
+    // Reject flag combinations the bit-packed kernel does not support.
+    if (packed && (mode != MODE_GPU || tiled)) {
+        fprintf(stderr, "The packed kernel runs only in gpu mode without --tiled.\n");
+        return 1;
+    }
+
+    // Multi-generation launches are implemented only by the tiled kernel.
+    if (steps_per_launch <= 0) {
+        fprintf(stderr, "steps-per-launch must be > 0\n");
+        return 1;
+    }
+    if (steps_per_launch > 1 && (mode != MODE_GPU || !tiled)) {
+        fprintf(stderr, "--steps-per-launch > 1 requires gpu mode with --tiled 1.\n");
+        return 1;
+    }
+
+    // The pipelined launch loop only exists for the OpenCL path.
+    if (pipeline && mode != MODE_GPU) {
+        fprintf(stderr, "--pipeline 1 requires gpu mode.\n");
+        return 1;
+    }
+
+    // Active-tile tracking is built on the naive per-cell kernel and is always enqueued back to back.
+    if (sparse && (mode != MODE_GPU || tiled || packed || pipeline)) {
+        fprintf(stderr, "--sparse 1 requires gpu mode without --tiled, --packed or --pipeline.\n");
+        return 1;
+    }
+
+    if (zero_copy && mode != MODE_GPU) {
+        fprintf(stderr, "--zero-copy 1 requires gpu mode.\n");
+        return 1;
+    }
+
+    // Population, change counts and board hashes are reduced by the single-step byte-per-cell kernels.
+    const int stats_on = stop_on_stable || stop_on_period != 0 || gen_stats_path != NULL;
+    if (stop_on_period < 0) {
+        fprintf(stderr, "--stop-on-period must be >= 0\n");
+        return 1;
+    }
+    if (stats_on && (mode != MODE_GPU || packed || sparse || steps_per_launch > 1 || states > 2 || autotune)) {
+        fprintf(stderr, "--stop-on-stable, --stop-on-period and --gen-stats require gpu mode with the naive or tiled "
+                        "kernel and a Life-like rule (no --packed, --sparse, --steps-per-launch > 1 or --autotune).\n");
+        return 1;
+    }
+
+    // HashLife treats the board as one period of an infinite pattern, which only matches the torus.
+    if (mode == MODE_HASHLIFE && !wrap) {
+        fprintf(stderr, "--mode hashlife requires --wrap 1.\n");
+        return 1;
+    }
+
+    // Every device needs at least one row of the board.
+    if (mode == MODE_MULTI && (devices <= 0 || devices > GOL_MULTI_MAX_DEVICES || devices > rows)) {
+        fprintf(stderr, "--devices must be between 1 and min(%d, rows).\n", GOL_MULTI_MAX_DEVICES);
+        return 1;
+    }
+
+    // Generations rules have their own packed engines: the gpu kernel and the cpu_seq engine.
+    if (states > 2 && ((mode != MODE_GPU && mode != MODE_CPU_SEQ) || tiled || packed || sparse)) {
+        fprintf(stderr, "Generations rules run only in gpu mode (without --tiled, --packed or --sparse) or cpu_seq mode.\n");
         return 1;
     }
 
+    // The autotuner searches the Life-like kernels of the single-device OpenCL loop.
+    if (autotune && (mode != MODE_GPU || sparse || states > 2)) {
+        fprintf(stderr, "--autotune requires gpu mode without --sparse and a Life-like rule.\n");
+        return 1;
+    }
+    // The tuning database is never implied, so results do not end up split across working directories.
+    if (autotune && !tuning_db) {
+        fprintf(stderr, "--autotune requires --tuning-db FILE to store its result.\n");
+        return 1;
+    }
+
+    // Per-launch kernel times are only kept by the single-device OpenCL loop.
+    if (iter_trace_path && mode != MODE_GPU) {
+        fprintf(stderr, "--iter-trace requires gpu mode.\n");
+        return 1;
+    }
+
+    // The command trace follows the queue of the single-device OpenCL loop.
+    if (trace_path && mode != MODE_GPU) {
+        fprintf(stderr, "--trace requires gpu mode.\n");
+        return 1;
+    }
+
+    // The copy probe runs on the device of the single-device OpenCL loop.
+    if (roofline && mode != MODE_GPU) {
+        fprintf(stderr, "--roofline requires gpu mode.\n");
+        return 1;
+    }
+
+    // Counters wrap the sequential reference loop and the single-device kernel loop.
+    if (perf_on && mode != MODE_CPU_SEQ && mode != MODE_GPU) {
+        fprintf(stderr, "--perf requires cpu_seq or gpu mode.\n");
+        return 1;
+    }
+
+    // Checkpoints are taken from the single-device OpenCL loop.
+    if (checkpoint_every < 0 || (checkpoint_every > 0 && mode != MODE_GPU)) {
+        fprintf(stderr, "--checkpoint-every must be >= 0 and requires gpu mode.\n");
+        return 1;
+    }
+
+    // So are density frames, from the byte-per-cell and bit-packed Life-like layouts.
+    if (frames_every < 0 || frame_scale < 0 || (frames_every > 0 && (mode != MODE_GPU || states > 2))) {
+        fprintf(stderr, "--frames-every and --frame-scale must be >= 0; frames require gpu mode and a Life-like rule.\n");
+        return 1;
+    }
+
+    // Sparse runs never wait on the host between generations, so they collect events like the pipeline.
+    const int batched = pipeline || sparse;
+
+    // Streamed boards may exceed RAM, so this mode runs before any full-size host buffer exists.
+    if (mode == MODE_STREAM) {
+        if (band_steps <= 0 || band_rows < 0) {
+            fprintf(stderr, "--band-steps must be > 0 and --band-rows must be >= 0 (0 = auto).\n");
+            return 1;
+        }
+
+        const size_t board_bytes = (size_t)rows * (size_t)cols;
+        GolMappedFile board;
+        if (gol_map_file(&board, board_file, board_bytes) != 0) {
+            fprintf(stderr, "Could not map a %.2f MB board file%s%s: %s\n",
+                    (double)board_bytes / (1024.0 * 1024.0),
+                    board_file ? " at " : "", board_file ? board_file : "", strerror(errno));
+            return 1;
+        }
+
+        GolStreamStats st;
+        gol_stream_run(&board, rows, cols, iters, wrap, rule, seed, density, load_path, load_format, band_rows, band_steps,
+                   (size_t)lx_arg, (size_t)ly_arg, repeat, warmup, kernel_dir, kernel_cache, &st);
+
+        // Validation needs the whole board in RAM twice, so it is only practical for small boards.
+        if (validate) {
+            unsigned char* initial = (unsigned char*)malloc(board_bytes);
+            int validation_ok = -1;
+            if (initial) {
+                validation_ok = init_board(initial, rows, cols, seed, density, load_path, load_format)
+                              ? validate_against_cpu(initial, board.data, rows, cols, iters, wrap, rule, states) : 0;
+                free(initial);
+            }
+            if (validation_ok <= 0) {
+                if (validation_ok < 0) fprintf(stderr, "Validation could not be completed due to allocation failure.\n");
+                gol_unmap_file(&board);
+                return 2;
+            }
+            printf("Validation OK (CPU reference matched streamed result).\n");
+        }
+
+        const double total_ms = st.h2d_ms + st.kernel_ms + st.d2h_ms;
+        printf("Mode: gpu_stream\n");
+        printf("Rows x Cols: %d x %d\n", rows, cols);
+        printf("Iterations: %d\n", iters);
+        printf("Wrap: %d\n", wrap);
+        printf("Rule: %s\n", rule_name);
+        printf("Board file: %s\n", board_file ? board_file : "(temporary)");
+        printf("Bands: %d of %d rows, %d generations per upload (%d passes)\n",
+               st.n_bands, st.band_rows, band_steps, st.passes);
+        printf("Local size: %d x %d\n", lx_arg, ly_arg);
+        printf("Repeat / Warmup: %d / %d\n", repeat, warmup);
+        printf("Program build: %.3f ms (kernel cache %s)\n", st.build.build_ms, gol_build_label(&st.build));
+        printf("Host->Device: %.3f ms\n", st.h2d_ms);
+        printf("Kernel total: %.3f ms\n", st.kernel_ms);
+        printf("Device->Host: %.3f ms\n", st.d2h_ms);
+        printf("Profiled GPU total: %.3f ms\n", total_ms);
+        printf("Wall total: %.3f ms\n", st.wall_total_ms);
+        printf("Kernel per iteration: %.6f ms\n", st.kernel_ms / (double)iters);
+
+        // The generations per upload go into the steps_per_launch column.
+        if (csv && out_path) {
+            const CsvRow row = {
+                .mode = mode, .rows = rows, .cols = cols, .iters = iters, .wrap = wrap,
+                .lx = (size_t)lx_arg, .ly = (size_t)ly_arg,
+                .h2d_ms = st.h2d_ms, .kernel_ms = st.kernel_ms, .d2h_ms = st.d2h_ms,
+                .total_ms = total_ms, .wall_total_ms = st.wall_total_ms, .steps_per_launch = band_steps,
+                .rule = rule_name, .states = states,
+                .kernel_cache = gol_build_label(&st.build), .build_ms = st.build.build_ms
+            };
+            append_csv_row(out_path, &row);
+        }
+
+        int status = save_result(save_path, board.data, rows, cols, end_generation, seed, wrap, rule, states);
+        gol_unmap_file(&board);
+        return status;
+    }
+
     const size_t n = (size_t)rows * (size_t)cols;
-    unsigned char* h_grid = (unsigned char*)malloc(n);
+
+    // A snapshot of exactly the board size is mapped instead of copied; the GPU path
+    // also wraps the mapping in a CL_MEM_USE_HOST_PTR buffer for a zero-copy upload.
+    GolMappedFile snapshot_map;
+    memset(&snapshot_map, 0, sizeof(snapshot_map));
+    unsigned char* h_grid = NULL;
+    if (load_format == GOL_FORMAT_SNAPSHOT && load_header.rows == (uint64_t)rows && load_header.cols == (uint64_t)cols) {
+        int rc = gol_snapshot_map(&snapshot_map, load_path, &load_header, &h_grid);
+        if (rc != 0) {
+            fprintf(stderr, "Could not map %s: %s\n", load_path, gol_pattern_error_string(rc));
+            return 1;
+        }
+    } else {
+        h_grid = (unsigned char*)malloc(n);
+    }
     unsigned char* h_tmp  = (unsigned char*)malloc(n);
 
     // Allocate host buffers for the input and output grids.
     if (!h_grid || !h_tmp) {
         fprintf(stderr, "Host allocation failed (n=%u)\n", (unsigned)n);
-        free(h_grid);
+        free_initial_grid(h_grid, &snapshot_map);
         free(h_tmp);
         return 1;
     }
 
-    // Fill the initial grid with random 0/1 cell states.
-    srand(seed);
-    for (size_t k = 0; k < n; ++k) {
-        h_grid[k] = (unsigned char)(rand() & 1);
+    // Start the Chrome trace here so the host phases before the first command are on it.
+    GolTrace* trace = NULL;
+    if (trace_path) {
+        trace = gol_trace_open(trace_path, gol_now_ms());
+        if (!trace) {
+            fprintf(stderr, "Host allocation failed (trace)\n");
+            free_initial_grid(h_grid, &snapshot_map);
+            free(h_tmp);
+            return 1;
+        }
+    }
+
+    // Fill the initial grid with random 0/1 cell states or the loaded pattern.
+    // A random gpu board is left for the device to generate (see device_init below).
+    const int defer_random = mode == MODE_GPU && !load_path && !autotune;
+    const double init_start_ms = gol_now_ms();
+    if (!snapshot_map.data && !defer_random && !init_board(h_grid, rows, cols, seed, density, load_path, load_format)) {
+        free_initial_grid(h_grid, &snapshot_map);
+        free(h_tmp);
+        return 1;
+    }
+    if (trace && !snapshot_map.data && !defer_random) gol_trace_host(trace, "init", init_start_ms, gol_now_ms());
+
+    // Open the counters before any OpenCL context, so CPU runtime worker threads inherit them.
+    GolPerf perf_counters;
+    GolPerf* perf = NULL;
+    if (perf_on) {
+        if (gol_perf_open(&perf_counters, 1) > 0) perf = &perf_counters;
+        else fprintf(stderr, "Hardware counters are not available (perf_event_open failed, see /proc/sys/kernel/perf_event_paranoid).\n");
     }
 
     // Execute the sequential CPU benchmark path and optionally write its result to CSV.
     if (mode == MODE_CPU_SEQ) {
-        double cpu_wall_total_ms = 0.0;
-        run_cpu_seq(h_grid, h_tmp, rows, cols, iters, wrap, repeat, warmup, &cpu_wall_total_ms);
+        CpuTiming cpu_timing = { 0 };
+        if (states > 2) {
+            // Generations rules run on the packed engine, checked against the byte-per-cell reference.
+            run_cpu_generations(h_grid, h_tmp, rows, cols, iters, wrap, rule, states, repeat, warmup, perf, &cpu_timing);
+            if (validate) {
+                int validation_ok = validate_against_cpu(h_grid, h_tmp, rows, cols, iters, wrap, rule, states);
+                if (validation_ok <= 0) {
+                    if (validation_ok < 0) fprintf(stderr, "Validation could not be completed due to allocation failure.\n");
+                    free_initial_grid(h_grid, &snapshot_map);
+                    free(h_tmp);
+                    return 2;
+                }
+                printf("Validation OK (CPU reference matched packed Generations result).\n");
+            }
+        } else {
+            run_cpu_seq(h_grid, h_tmp, rows, cols, iters, wrap, rule, repeat, warmup, perf, &cpu_timing);
+        }
 
-        printf("Mode: cpu_seq\n");
+        printf("Mode: %s\n", mode_to_csv_name(mode, 0, 0, 0, states));
         printf("Execution device: Host CPU (sequential reference, single-threaded)\n");
         printf("Rows x Cols: %d x %d\n", rows, cols);
         printf("Iterations: %d\n", iters);
         printf("Wrap: %d\n", wrap);
+        printf("Rule: %s\n", rule_name);
+        if (states > 2) printf("States: %d (%d bits per cell)\n", states, gol_gens_bits_per_cell(states));
         printf("Repeat / Warmup: %d / %d\n", repeat, warmup);
-        printf("CPU sequential total wall time: %.3f ms\n", cpu_wall_total_ms);
-        printf("CPU sequential time per iteration: %.6f ms\n", cpu_wall_total_ms / (double)iters);
+        printf("CPU sequential total wall time: %.3f ms\n", cpu_timing.avg_ms);
+        printf("CPU sequential time per iteration: %.6f ms\n", cpu_timing.avg_ms / (double)iters);
+        print_perf_counters(perf, (double)rows * (double)cols * (double)iters);
 
         if (csv && out_path) {
-            append_csv_row(out_path, mode, rows, cols, iters, wrap, 1u, 1u,
-                           0.0, cpu_wall_total_ms, 0.0,
-                           cpu_wall_total_ms, cpu_wall_total_ms, 0);
+            const CsvRow row = {
+                .mode = mode, .rows = rows, .cols = cols, .iters = iters, .wrap = wrap, .lx = 1u, .ly = 1u,
+                .kernel_ms = cpu_timing.avg_ms, .total_ms = cpu_timing.avg_ms, .wall_total_ms = cpu_timing.avg_ms,
+                .kernel_spread = cpu_timing.spread, .wall_spread = cpu_timing.spread,
+                .steps_per_launch = 1,
+                .rule = rule_name, .states = states, .perf = perf
+            };
+            append_csv_row(out_path, &row);
         }
 
-        free(h_grid);
+        int status = save_result(save_path, h_tmp, rows, cols, end_generation, seed, wrap, rule, states);
+        if (perf) gol_perf_close(perf);
+        free_initial_grid(h_grid, &snapshot_map);
         free(h_tmp);
-        return 0;
+        return status;
     }
 
-    cl_int err;
-    cl_platform_id platform;
-    cl_device_id device = pick_device(&platform);
-    print_device_info(device);
+    // Execute the HashLife engine and report it through the same CSV columns.
+    if (mode == MODE_HASHLIFE) {
+        CpuTiming hl_timing = { 0 };
+        size_t node_count = 0;
+        if (!run_hashlife(h_grid, h_tmp, rows, cols, iters, rule, repeat, warmup,
+                          &hl_timing, &node_count)) {
+            free_initial_grid(h_grid, &snapshot_map);
+            free(h_tmp);
+            return 1;
+        }
 
-    size_t max_wg = 0;
-    size_t max_wi[3] = {0, 0, 0};
+        if (validate) {
+            int validation_ok = validate_against_cpu(h_grid, h_tmp, rows, cols, iters, wrap, rule, states);
+            if (validation_ok <= 0) {
+                if (validation_ok < 0) fprintf(stderr, "Validation could not be completed due to allocation failure.\n");
+                free_initial_grid(h_grid, &snapshot_map);
+                free(h_tmp);
+                return 2;
+            }
+            printf("Validation OK (CPU reference matched HashLife result).\n");
+        }
 
-    // Query device limits for valid work-group dimensions.
-    clGetDeviceInfo(device, CL_DEVICE_MAX_WORK_GROUP_SIZE, sizeof(max_wg), &max_wg, NULL);
-    clGetDeviceInfo(device, CL_DEVICE_MAX_WORK_ITEM_SIZES, sizeof(max_wi), max_wi, NULL);
+        printf("Mode: hashlife\n");
+        printf("Execution device: Host CPU (HashLife quadtree, single-threaded)\n");
+        printf("Rows x Cols: %d x %d\n", rows, cols);
+        printf("Iterations: %d\n", iters);
+        printf("Wrap: %d\n", wrap);
+        printf("Rule: %s\n", rule_name);
+        printf("Repeat / Warmup: %d / %d\n", repeat, warmup);
+        printf("HashLife nodes in last run: %zu\n", node_count);
+        printf("HashLife total wall time: %.3f ms\n", hl_timing.avg_ms);
+        printf("HashLife time per iteration: %.6f ms\n", hl_timing.avg_ms / (double)iters);
 
-    // Reject unsupported local sizes before launching the kernel.
-    if ((size_t)lx_arg > max_wi[0] || (size_t)ly_arg > max_wi[1] ||
-        (size_t)lx_arg * (size_t)ly_arg > max_wg) {
-        fprintf(stderr,
-                "Invalid local size lx=%d ly=%d for this device (max_wi=%ux%u, max_wg=%u)\n",
-                lx_arg, ly_arg,
-                (unsigned)max_wi[0], (unsigned)max_wi[1], (unsigned)max_wg);
-        free(h_grid);
+        if (csv && out_path) {
+            const CsvRow row = {
+                .mode = mode, .rows = rows, .cols = cols, .iters = iters, .wrap = wrap, .lx = 1u, .ly = 1u,
+                .kernel_ms = hl_timing.avg_ms, .total_ms = hl_timing.avg_ms, .wall_total_ms = hl_timing.avg_ms,
+                .kernel_spread = hl_timing.spread, .wall_spread = hl_timing.spread,
+                .steps_per_launch = 1,
+                .rule = rule_name, .states = states
+            };
+            append_csv_row(out_path, &row);
+        }
+
+        int status = save_result(save_path, h_tmp, rows, cols, end_generation, seed, wrap, rule, states);
+        free_initial_grid(h_grid, &snapshot_map);
         free(h_tmp);
-        return 1;
+        return status;
     }
 
-    size_t lx = (size_t)lx_arg;
-    size_t ly = (size_t)ly_arg;
-    size_t gx = round_up((size_t)rows, lx);
-    size_t gy = round_up((size_t)cols, ly);
+    // Split the board across several devices and report the per-device kernel times.
+    if (mode == MODE_MULTI) {
+        GolMultiStats ms;
+        gol_multi_run(h_grid, h_tmp, rows, cols, iters, wrap, rule, devices, split_device,
+                      (size_t)lx_arg, (size_t)ly_arg, repeat, warmup, kernel_dir, kernel_cache, &ms);
+
+        if (validate) {
+            int validation_ok = validate_against_cpu(h_grid, h_tmp, rows, cols, iters, wrap, rule, states);
+            if (validation_ok <= 0) {
+                if (validation_ok < 0) fprintf(stderr, "Validation could not be completed due to allocation failure.\n");
+                free_initial_grid(h_grid, &snapshot_map);
+                free(h_tmp);
+                return 2;
+            }
+            printf("Validation OK (CPU reference matched multi-device result).\n");
+        }
 
-    size_t global[2] = { gx, gy };
-    size_t local[2]  = { lx, ly };
+        // The strips run concurrently, so the slowest device bounds the kernel time.
+        double max_kernel_ms = 0.0;
+        for (int d = 0; d < ms.n_devices; ++d) {
+            if (ms.kernel_ms[d] > max_kernel_ms) max_kernel_ms = ms.kernel_ms[d];
+        }
+        const double total_ms = ms.h2d_ms + max_kernel_ms + ms.d2h_ms;
 
-    // Create an OpenCL context for the selected device.
-    cl_context context = clCreateContext(NULL, 1, &device, NULL, NULL, &err);
-    if (!context || err != CL_SUCCESS) die_cl("clCreateContext", err);
+        printf("Mode: gpu_multi\n");
+        printf("Rows x Cols: %d x %d\n", rows, cols);
+        printf("Iterations: %d\n", iters);
+        printf("Wrap: %d\n", wrap);
+        printf("Rule: %s\n", rule_name);
+        printf("Devices: %d%s\n", ms.n_devices, split_device ? " (sub-devices requested)" : "");
+        for (int d = 0; d < ms.n_devices; ++d) {
+            printf("  Device %d kernel total: %.3f ms\n", d, ms.kernel_ms[d]);
+        }
+        printf("Local size: %d x %d\n", lx_arg, ly_arg);
+        printf("Repeat / Warmup: %d / %d\n", repeat, warmup);
+        printf("Program build (all devices): %.3f ms (kernel cache %s)\n", ms.build.build_ms, gol_build_label(&ms.build));
+        printf("Host->Device: %.3f ms\n", ms.h2d_ms);
+        printf("Kernel total (slowest device): %.3f ms\n", max_kernel_ms);
+        printf("Halo exchange (all devices): %.3f ms\n", ms.halo_ms);
+        printf("Device->Host: %.3f ms\n", ms.d2h_ms);
+        printf("Profiled GPU total: %.3f ms\n", total_ms);
+        printf("Wall total: %.3f ms\n", ms.wall_total_ms);
+        printf("Kernel per iteration: %.6f ms\n", max_kernel_ms / (double)iters);
 
-    // Create a profiling-enabled command queue for timing measurements.
-    cl_command_queue queue = clCreateCommandQueueWithProperties(
-        context, device,
-        (cl_queue_properties[]){ CL_QUEUE_PROPERTIES, (cl_queue_properties)CL_QUEUE_PROFILING_ENABLE, 0 },
-        &err
-    );
-    if (!queue || err != CL_SUCCESS) die_cl("clCreateCommandQueueWithProperties", err);
+        if (csv && out_path) {
+            const CsvRow row = {
+                .mode = mode, .rows = rows, .cols = cols, .iters = iters, .wrap = wrap,
+                .lx = (size_t)lx_arg, .ly = (size_t)ly_arg,
+                .h2d_ms = ms.h2d_ms, .kernel_ms = max_kernel_ms, .d2h_ms = ms.d2h_ms,
+                .total_ms = total_ms, .wall_total_ms = ms.wall_total_ms, .steps_per_launch = 1,
+                .devices = ms.n_devices, .device_kernel_ms = ms.kernel_ms, .halo_ms = ms.halo_ms,
+                .rule = rule_name, .states = states,
+                .kernel_cache = gol_build_label(&ms.build), .build_ms = ms.build.build_ms
+            };
+            append_csv_row(out_path, &row);
+        }
 
-    int loader_err = 0;
-    const char* kernel_path = tiled ? "kernels/gol_tiled.cl" : "kernels/gol_naive.cl";
-    const char* kernel_name = tiled ? "gol_step_tiled" : "gol_step";
+        int status = save_result(save_path, h_tmp, rows, cols, end_generation, seed, wrap, rule, states);
+        free_initial_grid(h_grid, &snapshot_map);
+        free(h_tmp);
+        return status;
+    }
 
-    // Choose and load the requested kernel source file.
-    const char* src = load_kernel_source(kernel_path, &loader_err);
-    if (loader_err != 0 || !src) {
-        fprintf(stderr, "Kernel source load failed. Did you run from project root?\n");
-        clReleaseCommandQueue(queue);
-        clReleaseContext(context);
-        free(h_grid);
+    // Execute the multithreaded CPU engine and report it through the same CSV columns.
+    if (mode == MODE_CPU_PAR) {
+        if (threads <= 0) threads = gol_cpu_count();
+
+        CpuTiming cpu_timing = { 0 };
+        int used_threads = 0;
+        if (!run_cpu_par(h_grid, h_tmp, rows, cols, iters, wrap, rule, threads, repeat, warmup,
+                         &cpu_timing, &used_threads)) {
+            free_initial_grid(h_grid, &snapshot_map);
+            free(h_tmp);
+            return 1;
+        }
+
+        if (validate) {
+            int validation_ok = validate_against_cpu(h_grid, h_tmp, rows, cols, iters, wrap, rule, states);
+            if (validation_ok <= 0) {
+                if (validation_ok < 0) fprintf(stderr, "Validation could not be completed due to allocation failure.\n");
+                free_initial_grid(h_grid, &snapshot_map);
+                free(h_tmp);
+                return 2;
+            }
+            printf("Validation OK (CPU reference matched CPU parallel result).\n");
+        }
+
+        printf("Mode: cpu_par\n");
+        printf("Execution device: Host CPU (%d threads, row bands)\n", used_threads);
+        printf("Rows x Cols: %d x %d\n", rows, cols);
+        printf("Iterations: %d\n", iters);
+        printf("Wrap: %d\n", wrap);
+        printf("Rule: %s\n", rule_name);
+        printf("Repeat / Warmup: %d / %d\n", repeat, warmup);
+        printf("CPU parallel total wall time: %.3f ms\n", cpu_timing.avg_ms);
+        printf("CPU parallel time per iteration: %.6f ms\n", cpu_timing.avg_ms / (double)iters);
+
+        // The CPU engine has no work-group, so the thread count goes into the lx column.
+        if (csv && out_path) {
+            const CsvRow row = {
+                .mode = mode, .rows = rows, .cols = cols, .iters = iters, .wrap = wrap, .lx = (size_t)used_threads, .ly = 1u,
+                .kernel_ms = cpu_timing.avg_ms, .total_ms = cpu_timing.avg_ms, .wall_total_ms = cpu_timing.avg_ms,
+                .kernel_spread = cpu_timing.spread, .wall_spread = cpu_timing.spread,
+                .steps_per_launch = 1,
+                .rule = rule_name, .states = states
+            };
+            append_csv_row(out_path, &row);
+        }
+
+        int status = save_result(save_path, h_tmp, rows, cols, end_generation, seed, wrap, rule, states);
+        free_initial_grid(h_grid, &snapshot_map);
+        free(h_tmp);
+        return status;
+    }
+
+    // The engine owns the device, context, queue, program builds and board buffers of the gpu mode.
+    GolEngineConfig engine_config = {
+        .kernel_dir = kernel_dir, .cache_dir = kernel_cache, .profile = 1, .trace = trace
+    };
+    int engine_err = 0;
+    GolEngine* engine = gol_engine_create(&engine_config, &engine_err);
+    if (!engine) {
+        if (engine_err == GOL_ENGINE_ENODEV) fprintf(stderr, "No OpenCL GPU/CPU device found.\n");
+        else fprintf(stderr, "OpenCL setup failed: %s\n", gol_engine_error_string(engine_err));
+        exit(1);
+    }
+    cl_device_id device = gol_engine_device(engine);
+    cl_context context = gol_engine_context(engine);
+    cl_command_queue queue = gol_engine_queue(engine);
+    gol_print_device_info(device);
+    if (trace) gol_trace_sync_device(trace, queue, gol_now_ms());
+
+    // --autotune picks the launch configuration for this device and board and stores it;
+    // later runs without explicit launch flags take it from the tuning database.
+    char driver_version[256] = "";
+    const char* device_name = gol_engine_device_name(engine);
+    clGetDeviceInfo(device, CL_DRIVER_VERSION, sizeof(driver_version) - 1, driver_version, NULL);
+    GolTuning tuning;
+    int tuned = 0;
+    if (autotune) {
+        tuning = autotune_gpu(device, h_grid, rows, cols, wrap, rule, kernel_dir, kernel_cache);
+        tuned = 1;
+        if (gol_tuning_store(tuning_db, device_name, driver_version, rows, cols, wrap, &tuning) != 0) {
+            fprintf(stderr, "Could not write the tuning database %s\n", tuning_db);
+        }
+    } else if (use_tuning && tuning_db && !launch_set && !sparse && !stats_on && states == 2) {
+        tuned = gol_tuning_lookup(tuning_db, device_name, driver_version, rows, cols, wrap, &tuning) == 1;
+    }
+    if (tuned) {
+        lx_arg = tuning.lx;
+        ly_arg = tuning.ly;
+        tiled = tuning.tiled;
+        packed = tuning.packed;
+        steps_per_launch = tuning.steps_per_launch;
+    }
+
+    size_t lx = (size_t)lx_arg;
+    size_t ly = (size_t)ly_arg;
+
+    // Statistics are reduced into one chunk of slots, read back and zeroed again once the chunk is done;
+    // the host keeps the chunk and the generations the period check looks back on.
+    int stats_check = (stop_on_stable || stop_on_period > 0) ? STATS_CHECK_GENERATIONS : STATS_STREAM_GENERATIONS;
+    if (stats_check > iters) stats_check = iters;
+
+    // Build the step program with the rule baked in and size the buffers; the engine also checks
+    // the work-group against the device and the kernel.
+    engine_config.tiled = tiled;
+    engine_config.lx = lx_arg;
+    engine_config.ly = ly_arg;
+    engine_config.packed = packed;
+    engine_config.steps_per_launch = steps_per_launch;
+    engine_config.states = states;
+    engine_config.sparse = sparse;
+    engine_config.stats_slots = stats_on ? stats_check : 0;
+    engine_config.batch = batched;
+    engine_config.zero_copy = zero_copy;
+    if (gol_engine_configure(engine, &engine_config) != GOL_ENGINE_OK ||
+        gol_engine_prepare(engine, rows, cols, rule) != GOL_ENGINE_OK) {
+        fprintf(stderr, "%s\n", gol_engine_message(engine));
+        gol_engine_destroy(engine);
+        free_initial_grid(h_grid, &snapshot_map);
         free(h_tmp);
         return 1;
     }
 
-    // Create an OpenCL program object from the kernel source.
-    cl_program program = clCreateProgramWithSource(context, 1, &src, NULL, &err);
-    if (!program || err != CL_SUCCESS) die_cl("clCreateProgramWithSource", err);
+    // The packed kernel maps one work-item to one 64-cell word instead of one cell;
+    // Generations rules pack 2, 4 or 8 bits per cell into 32-bit words, also one word per work-item.
+    const int gens = states > 2;
+    const int state_bits = gens ? gol_gens_bits_per_cell(states) : 0;
+    const size_t words_per_row = gens ? gol_gens_words_per_row(cols, state_bits) : gol_packed_words_per_row(cols);
+    const size_t grid_bytes = packed ? (size_t)rows * words_per_row * sizeof(cl_ulong)
+                            : gens ? (size_t)rows * words_per_row * sizeof(cl_uint) : n * sizeof(cl_uchar);
+
+    // A byte-per-cell random board is generated on the device once. The host still fills its copy
+    // for the packed layouts and for --validate, which then also checks that both generators agree.
+    const int device_init = defer_random && !packed && !gens;
+    if (defer_random && (!device_init || validate)) {
+        const double fill_start_ms = gol_now_ms();
+        gol_random_fill(h_grid, n, seed, density, 0);
+        if (trace) gol_trace_host(trace, "init", fill_start_ms, gol_now_ms());
+    }
 
-    // Build the program and print the compiler log on failure.
-    err = clBuildProgram(program, 1, &device, "", NULL, NULL);
-    if (err != CL_SUCCESS) {
-        size_t log_size = 0;
-        clGetProgramBuildInfo(program, device, CL_PROGRAM_BUILD_LOG, 0, NULL, &log_size);
+    // Measure the copy bandwidth the kernel variants are compared against.
+    double peak_gb_s = 0.0;
+    if (roofline) {
+        peak_gb_s = measure_copy_bandwidth(context, device, queue, kernel_dir, kernel_cache);
+        if (peak_gb_s <= 0.0) fprintf(stderr, "Copy bandwidth probe failed; the roofline columns stay empty.\n");
+    }
 
-        char* log = (char*)malloc(log_size + 1);
-        if (log) {
-            clGetProgramBuildInfo(program, device, CL_PROGRAM_BUILD_LOG, log_size, log, NULL);
-            log[log_size] = 0;
-            fprintf(stderr, "Build failed:\n%s\n", log);
-            free(log);
+    // Zero-copy boards are mapped instead of copied; the copies this saves are timed once
+    // on a plain buffer of the same size.
+    double copy_transfer_ms = 0.0;
+    if (zero_copy) {
+        cl_bool unified = CL_FALSE;
+        clGetDeviceInfo(device, CL_DEVICE_HOST_UNIFIED_MEMORY, sizeof(unified), &unified, NULL);
+        if (!unified) fprintf(stderr, "Note: the device has no unified host memory; map/unmap may still copy.\n");
+        void* staging = malloc(grid_bytes);
+        if (!staging) {
+            fprintf(stderr, "Host allocation failed (transfer probe)\n");
+            exit(1);
         }
-        die_cl("clBuildProgram", err);
+        copy_transfer_ms = measure_transfer_ms(context, queue, grid_bytes, staging);
+        free(staging);
     }
 
-    // Create the kernel object used for one simulation step.
-    cl_kernel kernel = clCreateKernel(program, kernel_name, &err);
-    if (!kernel || err != CL_SUCCESS) die_cl("clCreateKernel", err);
+    uint32_t* h_stats = NULL;
+    GolStatsHistory stats_history;
+    memset(&stats_history, 0, sizeof(stats_history));
+    FILE* gen_stats_file = NULL;
+    if (stats_on) {
+        h_stats = (uint32_t*)malloc((size_t)stats_check * GOL_STATS_WORDS * sizeof(cl_uint));
+        if (!h_stats || gol_stats_history_init(&stats_history, stats_check, stop_on_period) != 0) {
+            fprintf(stderr, "Host allocation failed (generation statistics)\n");
+            exit(1);
+        }
+    }
+    if (gen_stats_path) {
+        gen_stats_file = fopen(gen_stats_path, "w");
+        if (!gen_stats_file) {
+            fprintf(stderr, "Could not open statistics file: %s\n", gen_stats_path);
+            exit(1);
+        }
+        fprintf(gen_stats_file, "generation,population,changed,hash\n");
+    }
+    int gens_run = iters;
+    int stop_generation = -1;
+    const char* stop_reason = NULL;
 
-    // Allocate the current state buffer on the device.
-    cl_mem d_a = clCreateBuffer(context, CL_MEM_READ_WRITE, n * sizeof(cl_uchar), NULL, &err);
-    if (!d_a || err != CL_SUCCESS) die_cl("clCreateBuffer(d_a)", err);
+    // A mapped snapshot is wrapped without a host copy, and a device-generated board stays on the device;
+    // each run starts with a device-side copy from either.
+    cl_int err;
+    cl_mem d_init = NULL;
+    double device_init_ms = 0.0;
+    if (snapshot_map.data && !packed && !gens) {
+        d_init = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_USE_HOST_PTR, grid_bytes, h_grid, &err);
+        if (!d_init || err != CL_SUCCESS) gol_die_cl("clCreateBuffer(d_init)", err);
+    } else if (device_init) {
+        d_init = clCreateBuffer(context, CL_MEM_READ_WRITE, grid_bytes, NULL, &err);
+        if (!d_init || err != CL_SUCCESS) gol_die_cl("clCreateBuffer(d_init)", err);
+        device_init_ms = fill_random_board(context, device, queue, d_init, n, seed, density,
+                                           kernel_dir, kernel_cache, trace);
+    }
 
-    // Allocate the next state buffer on the device.
-    cl_mem d_b = clCreateBuffer(context, CL_MEM_READ_WRITE, n * sizeof(cl_uchar), NULL, &err);
-    if (!d_b || err != CL_SUCCESS) die_cl("clCreateBuffer(d_b)", err);
+    // Checkpoints are read into pinned staging buffers and written to disk by a background thread
+    // during the last measured run; generations are counted from the loaded snapshot, if any.
+    const int checkpointing = checkpoint_every > 0;
+    const uint64_t base_generation = load_header.generation;
+    GolCheckpointWriter checkpoints;
+    if (checkpointing && !gol_checkpoint_start(&checkpoints, context, queue, checkpoint_path, grid_bytes,
+                                               rows, cols, packed, wrap, rule, states, seed)) {
+        exit(1);
+    }
+
+    // Density frames are also taken during the last measured run only.
+    const int framing = frames_every > 0;
+    GolFrameStream frames;
+    if (framing && !gol_frames_start(&frames, context, device, kernel_dir, kernel_cache, rows, cols,
+                                     packed, (int)words_per_row, frame_scale, frames_out)) {
+        fprintf(stderr, "Could not set up the frame stream.\n");
+        exit(1);
+    }
 
     double sum_h2d_ms = 0.0;
     double sum_kernel_ms = 0.0;
     double sum_d2h_ms = 0.0;
     double sum_total_ms = 0.0;
     double sum_wall_total_ms = 0.0;
+    int launches = 0;
+    uint64_t active_tiles = 0;
+    int num_tiles = 0;
+
+    // Per-run samples of the measured runs for the median, p95 and stddev.
+    double* run_kernel_ms = (double*)malloc(2 * (size_t)repeat * sizeof(double));
+    if (!run_kernel_ms) {
+        fprintf(stderr, "Host allocation failed (run samples)\n");
+        exit(1);
+    }
+    double* run_wall_ms = run_kernel_ms + repeat;
+
+    // Kernel time of every launch (every generation in sparse mode) of the current run,
+    // folded into the per-generation histogram after each measured run.
+    const int max_launches = (iters + steps_per_launch - 1) / steps_per_launch;
+    const int launch_slots = sparse ? iters : max_launches;
+    cl_ulong* launch_ns = (cl_ulong*)malloc((size_t)launch_slots * sizeof(cl_ulong));
+    GolHistogram* gen_hist = (GolHistogram*)malloc(sizeof(GolHistogram));
+    if (!launch_ns || !gen_hist) {
+        fprintf(stderr, "Host allocation failed (generation timings)\n");
+        exit(1);
+    }
+    gol_hist_reset(gen_hist);
+    FILE* iter_trace = NULL;
+    if (iter_trace_path) {
+        iter_trace = fopen(iter_trace_path, "w");
+        if (!iter_trace) {
+            fprintf(stderr, "Could not open trace file: %s\n", iter_trace_path);
+            exit(1);
+        }
+        fprintf(iter_trace, "run,launch,first_generation,generations,kernel_ns,ns_per_generation\n");
+    }
 
     // Execute warmup and repeated benchmark runs.
     for (int run = 0; run < warmup + repeat; ++run) {
         cl_ulong h2d_ns = 0, kernel_ns = 0, d2h_ns = 0;
-        double wall_start_ms = now_ms();
-
-        cl_mem cur = d_a;
-        cl_mem next = d_b;
-
-        cl_event ev_h2d;
-        // Copy the initial grid from host memory to the device.
-        err = clEnqueueWriteBuffer(queue, cur, CL_FALSE, 0, n * sizeof(cl_uchar), h_grid, 0, NULL, &ev_h2d);
-        if (err != CL_SUCCESS) die_cl("clEnqueueWriteBuffer", err);
-
-        clWaitForEvents(1, &ev_h2d);
-        {
-            cl_ulong s = 0, e = 0;
-            clGetEventProfilingInfo(ev_h2d, CL_PROFILING_COMMAND_START, sizeof(s), &s, NULL);
-            clGetEventProfilingInfo(ev_h2d, CL_PROFILING_COMMAND_END, sizeof(e), &e, NULL);
-            h2d_ns += (e - s);
-            clReleaseEvent(ev_h2d);
-        }
-
-        // Run the requested number of Game of Life iterations on the GPU.
-        for (int t = 0; t < iters; ++t) {
-            err  = clSetKernelArg(kernel, 0, sizeof(cl_mem), &cur);
-            err |= clSetKernelArg(kernel, 1, sizeof(cl_mem), &next);
-            err |= clSetKernelArg(kernel, 2, sizeof(int), &rows);
-            err |= clSetKernelArg(kernel, 3, sizeof(int), &cols);
-            err |= clSetKernelArg(kernel, 4, sizeof(int), &wrap);
-
-            // Allocate local tile memory for the tiled kernel version.
-            if (tiled) {
-                size_t tile_bytes = (lx + 2) * (ly + 2) * sizeof(unsigned char);
-                err |= clSetKernelArg(kernel, 5, tile_bytes, NULL);
+        double wall_start_ms = gol_now_ms();
+        const int checkpoint_run = checkpointing && run == warmup + repeat - 1;
+        const int frame_run = framing && run == warmup + repeat - 1;
+        GolEngineProfile prof;
+
+        // Upload the initial grid, or copy it from the mapped snapshot or device-generated buffer.
+        int rc = d_init ? gol_load_buffer(engine, d_init, rows, cols, wrap, rule)
+                        : gol_load(engine, h_grid, rows, cols, wrap, rule);
+        die_engine(engine, rc, "gol_load");
+        gol_engine_profile(engine, &prof);
+        h2d_ns += prof.load_ns;
+
+        // Every run accumulates into zeroed statistics slots; the last one streams them to --gen-stats.
+        int stats_read = 0;
+        gens_run = iters;
+        stop_generation = -1;
+        FILE* run_gen_stats = run == warmup + repeat - 1 ? gen_stats_file : NULL;
+        if (stats_on) gol_stats_history_reset(&stats_history);
+
+        // Counters cover the launches up to the final read.
+        if (perf && run >= warmup) gol_perf_start(perf);
+
+        // Run the requested number of Game of Life iterations on the GPU, advancing up to
+        // steps_per_launch generations with each kernel launch. The run is split where statistics
+        // are read or a checkpoint or frame is taken; multi-step launches take those at the first
+        // launch boundary past each multiple.
+        launches = 0;
+        active_tiles = 0;
+        int recorded = 0;
+        for (int done = 0; done < iters; ) {
+            int until = iters;
+            if (stats_on && (done / stats_check + 1) * stats_check < until) until = (done / stats_check + 1) * stats_check;
+            if (checkpoint_run) {
+                const int due = next_launch_boundary(checkpoint_every, base_generation, done, steps_per_launch);
+                if (due < until) until = due;
+            }
+            if (frame_run) {
+                const int due = next_launch_boundary(frames_every, base_generation, done, steps_per_launch);
+                if (due < until) until = due;
             }
 
-            if (err != CL_SUCCESS) die_cl("clSetKernelArg", err);
-
-            cl_event ev_k;
-            // Launch one kernel execution over the padded global grid.
-            err = clEnqueueNDRangeKernel(queue, kernel, 2, NULL, global, local, 0, NULL, &ev_k);
-            if (err != CL_SUCCESS) die_cl("clEnqueueNDRangeKernel", err);
-
-            clWaitForEvents(1, &ev_k);
-            {
-                cl_ulong s = 0, e = 0;
-                clGetEventProfilingInfo(ev_k, CL_PROFILING_COMMAND_START, sizeof(s), &s, NULL);
-                clGetEventProfilingInfo(ev_k, CL_PROFILING_COMMAND_END, sizeof(e), &e, NULL);
-                kernel_ns += (e - s);
-                clReleaseEvent(ev_k);
+            rc = gol_step_n(engine, until - done);
+            die_engine(engine, rc, "gol_step_n");
+            gol_engine_profile(engine, &prof);
+            kernel_ns += prof.step_ns;
+            memcpy(launch_ns + recorded, prof.launch_ns, (size_t)prof.launches * sizeof(cl_ulong));
+            recorded += prof.launches;
+            launches += sparse ? 2 * prof.launches : prof.launches;
+            active_tiles += prof.active_tiles;
+            num_tiles = prof.tiles;
+            const int from = done;
+            done = until;
+
+            // The in-order queue runs the checkpoint read before any later step overwrites the board.
+            if (checkpoint_run && done < iters &&
+                gol_checkpoint_due(checkpoint_every, base_generation + (uint64_t)from, base_generation + (uint64_t)done)) {
+                gol_checkpoint_enqueue(&checkpoints, queue, gol_engine_board(engine), base_generation + (uint64_t)done);
+            }
+            if (frame_run && gol_checkpoint_due(frames_every, base_generation + (uint64_t)from, base_generation + (uint64_t)done)) {
+                gol_frames_enqueue(&frames, queue, gol_engine_board(engine), base_generation + (uint64_t)done);
             }
 
-            // Swap device buffers so the next step reads the new state.
-            cl_mem tmp = cur;
-            cur = next;
-            next = tmp;
+            // Read the chunk of statistics slots once it is complete and stop once the board settled.
+            if (stats_on && (done % stats_check == 0 || done == iters)) {
+                const int chunk = done - stats_read;
+                die_engine(engine, gol_engine_read_stats(engine, h_stats, chunk), "gol_engine_read_stats");
+                stop_generation = gol_stats_history_push(&stats_history, h_stats, chunk, stop_on_stable, stop_on_period,
+                                                         &stop_reason);
+                if (run_gen_stats) {
+                    write_gen_stats(run_gen_stats, stats_history.gens + stats_history.keep, chunk,
+                                    base_generation + (uint64_t)stats_read);
+                }
+                stats_read = done;
+                if (stop_generation >= 0) {
+                    gens_run = done;
+                    break;
+                }
+            }
         }
 
-        cl_event ev_d2h;
-        // Copy the final grid back from the device to the host.
-        err = clEnqueueReadBuffer(queue, cur, CL_TRUE, 0, n * sizeof(cl_uchar), h_tmp, 0, NULL, &ev_d2h);
-        if (err != CL_SUCCESS) die_cl("clEnqueueReadBuffer", err);
-
-        {
-            cl_ulong s = 0, e = 0;
-            clGetEventProfilingInfo(ev_d2h, CL_PROFILING_COMMAND_START, sizeof(s), &s, NULL);
-            clGetEventProfilingInfo(ev_d2h, CL_PROFILING_COMMAND_END, sizeof(e), &e, NULL);
-            d2h_ns += (e - s);
-            clReleaseEvent(ev_d2h);
-        }
+        // Copy the final grid back to the host; zero-copy boards are only mapped for reading.
+        die_engine(engine, gol_read(engine, h_tmp), "gol_read");
+        gol_engine_profile(engine, &prof);
+        d2h_ns += prof.read_ns;
+        if (perf && run >= warmup) gol_perf_stop(perf);
 
-        err = clFinish(queue);
-        if (err != CL_SUCCESS) die_cl("clFinish", err);
+        double wall_total_ms = gol_now_ms() - wall_start_ms;
+        if (trace) gol_trace_host(trace, run < warmup ? "warmup" : "run", wall_start_ms, wall_start_ms + wall_total_ms);
 
-        double wall_total_ms = now_ms() - wall_start_ms;
         double h2d_ms = (double)h2d_ns / 1e6;
         double ker_ms = (double)kernel_ns / 1e6;
         double d2h_ms = (double)d2h_ns / 1e6;
@@ -623,8 +2179,21 @@ int main(int argc, char** argv) {
             sum_d2h_ms += d2h_ms;
             sum_total_ms += total_ms;
             sum_wall_total_ms += wall_total_ms;
+            run_kernel_ms[run - warmup] = ker_ms;
+            run_wall_ms[run - warmup] = wall_total_ms;
+            record_generation_times(gen_hist, iter_trace, run - warmup, launch_ns,
+                                    recorded, gens_run, sparse ? 1 : steps_per_launch);
         }
     }
+    free(launch_ns);
+    if (iter_trace && fclose(iter_trace) != 0) fprintf(stderr, "Could not write trace file: %s\n", iter_trace_path);
+    const RunSpread kernel_spread = run_spread(run_kernel_ms, repeat);
+    const RunSpread wall_spread = run_spread(run_wall_ms, repeat);
+    free(run_kernel_ms);
+
+    // Wait until the writer has flushed the last checkpoints.
+    if (checkpointing) gol_checkpoint_finish(&checkpoints, queue);
+    if (framing) gol_frames_finish(&frames);
 
     // Compute the average timing values over all measured runs.
     double h2d_ms = sum_h2d_ms / (double)repeat;
@@ -633,66 +2202,127 @@ int main(int argc, char** argv) {
     double total_ms = sum_total_ms / (double)repeat;
     double wall_total_ms = sum_wall_total_ms / (double)repeat;
 
+    // Summarize how much of the board the sparse runs actually had to compute.
+    const double avg_active_tiles = sparse ? (double)active_tiles / (double)iters : 0.0;
+    const GolBuildStats build_stats = *gol_engine_build_stats(engine);
     // Validate the GPU output against the CPU reference if requested.
+    int status = 0;
     if (validate) {
-        int validation_ok = validate_against_cpu(h_grid, h_tmp, rows, cols, iters, wrap);
-        if (validation_ok < 0) {
-            fprintf(stderr, "Validation could not be completed due to allocation failure.\n");
-            clReleaseMemObject(d_a);
-            clReleaseMemObject(d_b);
-            clReleaseKernel(kernel);
-            clReleaseProgram(program);
-            clReleaseCommandQueue(queue);
-            clReleaseContext(context);
-            free(h_grid);
-            free(h_tmp);
-            return 2;
-        }
-        if (validation_ok == 0) {
-            clReleaseMemObject(d_a);
-            clReleaseMemObject(d_b);
-            clReleaseKernel(kernel);
-            clReleaseProgram(program);
-            clReleaseCommandQueue(queue);
-            clReleaseContext(context);
-            free(h_grid);
-            free(h_tmp);
-            return 2;
+        const double validation_start_ms = gol_now_ms();
+        int validation_ok = validate_against_cpu(h_grid, h_tmp, rows, cols, gens_run, wrap, rule, states);
+
+        // The device reduction of the last generation has to match the board read back.
+        if (stats_on && validation_ok > 0) {
+            const GolGenStats host = gol_stats_board(h_tmp, n);
+            const GolGenStats* dev = gol_stats_history_last(&stats_history);
+            if (host.population != dev->population || host.hash != dev->hash) {
+                fprintf(stderr, "Validation FAILED: device statistics (population %u, hash %016llx) "
+                                "differ from the result board (population %u, hash %016llx).\n",
+                        (unsigned)dev->population, (unsigned long long)dev->hash,
+                        (unsigned)host.population, (unsigned long long)host.hash);
+                validation_ok = 0;
+            }
         }
-        printf("Validation OK (CPU reference matched GPU result).\n");
+        if (trace) gol_trace_host(trace, "validation", validation_start_ms, gol_now_ms());
+        finish_trace(&trace, trace_path);
+        if (validation_ok < 0) fprintf(stderr, "Validation could not be completed due to allocation failure.\n");
+        if (validation_ok <= 0) status = 2;
+        else printf("Validation OK (CPU reference matched GPU result).\n");
     }
+    finish_trace(&trace, trace_path);
 
-    // Print the result either as CSV or as a readable report.
-    printf("Mode: %s\n", mode_to_csv_name(mode, tiled));
-    printf("Rows x Cols: %d x %d\n", rows, cols);
-    printf("Iterations: %d\n", iters);
-    printf("Wrap: %d\n", wrap);
-    printf("Tiled: %d\n", tiled);
-    printf("Local size: %u x %u\n", (unsigned)lx, (unsigned)ly);
-    printf("Repeat / Warmup: %d / %d\n", repeat, warmup);
-    printf("Host->Device: %.3f ms\n", h2d_ms);
-    printf("Kernel total: %.3f ms\n", ker_ms);
-    printf("Device->Host: %.3f ms\n", d2h_ms);
-    printf("Profiled GPU total: %.3f ms\n", total_ms);
-    printf("Wall total: %.3f ms\n", wall_total_ms);
-    printf("Kernel per iteration: %.6f ms\n", ker_ms / (double)iters);
+    // A failed validation skips the report and the saved board; everything below is released either way.
+    if (status == 0) {
+        // Print the result either as CSV or as a readable report.
+        printf("Mode: %s\n", mode_to_csv_name(mode, tiled, packed, sparse, states));
+        printf("Rows x Cols: %d x %d\n", rows, cols);
+        printf("Iterations: %d\n", iters);
+        printf("Wrap: %d\n", wrap);
+        printf("Rule: %s\n", rule_name);
+        printf("Tiled: %d\n", tiled);
+        printf("Packed: %d\n", packed);
+        if (gens) printf("States: %d (%d bits per cell)\n", states, state_bits);
+        printf("Steps per launch: %d (%d kernel launches per run)\n", steps_per_launch, launches);
+        printf("Pipelined: %d\n", pipeline);
+        if (tuned) printf("Tuning: %s %s\n", autotune ? "autotuned and stored in" : "loaded from", tuning_db);
+        if (sparse) {
+            printf("Active tiles per generation: %.1f of %d (%.1f%%)\n",
+                   avg_active_tiles, num_tiles, 100.0 * avg_active_tiles / (double)num_tiles);
+        }
+        if (checkpointing) {
+            printf("Checkpoints: %d written to %s every %d generations (last at %llu, %.3f ms in the background)\n",
+                   checkpoints.written, checkpoint_path, checkpoint_every,
+                   (unsigned long long)checkpoints.last_generation, checkpoints.write_ms);
+        }
+        if (framing) {
+            const double frame_kb = (double)frames.frame_rows * (double)frames.frame_cols / 1024.0;
+            printf("Frames: %d written to %s every %d generations (%d x %d, scale %d, %.1f KB read back per frame, %.2f%% of the board)\n",
+                   frames.written, !strcmp(frames_out, "-") ? "stdout" : frames_out, frames_every,
+                   frames.frame_cols, frames.frame_rows, frames.scale, frame_kb,
+                   100.0 * frame_kb * 1024.0 / (double)grid_bytes);
+            if (frames.failed) fprintf(stderr, "%d frames could not be written.\n", frames.failed);
+        }
+        printf("Local size: %u x %u\n", (unsigned)lx, (unsigned)ly);
+        printf("Repeat / Warmup: %d / %d\n", repeat, warmup);
+        printf("Program build: %.3f ms (kernel cache %s)\n", build_stats.build_ms, gol_build_label(&build_stats));
+        if (device_init) printf("Board init on device: %.3f ms\n", device_init_ms);
+        printf("Host->Device: %.3f ms\n", h2d_ms);
+        printf("Kernel total: %.3f ms\n", ker_ms);
+        printf("Device->Host: %.3f ms\n", d2h_ms);
+        if (zero_copy) {
+            printf("Zero-copy transfers: %.3f ms instead of %.3f ms for write + read (saved %.3f ms)\n",
+                   h2d_ms + d2h_ms, copy_transfer_ms, copy_transfer_ms - (h2d_ms + d2h_ms));
+        }
+        printf("Profiled GPU total: %.3f ms\n", total_ms);
+        printf("Wall total: %.3f ms\n", wall_total_ms);
+        if (stop_generation >= 0) {
+            printf("Stopped early: %s at generation %llu (%d of %d generations run)\n", stop_reason,
+                   (unsigned long long)(base_generation + (uint64_t)stop_generation + 1), gens_run, iters);
+        }
+        if (stats_on) {
+            printf("Final population: %u (hash %016llx)\n",
+                   (unsigned)gol_stats_history_last(&stats_history)->population,
+                   (unsigned long long)gol_stats_history_last(&stats_history)->hash);
+        }
+        printf("Kernel per iteration: %.6f ms\n", ker_ms / (double)gens_run);
+        if (repeat > 1) {
+            printf("Kernel total median / p95 / stddev: %.3f / %.3f / %.3f ms\n",
+                   kernel_spread.median, kernel_spread.p95, kernel_spread.stddev);
+        }
+        print_generation_times(gen_hist);
+        print_perf_counters(perf, (double)rows * (double)cols * (double)gens_run);
+        const double model_bytes = model_bytes_per_cell(tiled, packed, gens ? state_bits : 0, steps_per_launch,
+                                                        lx, ly, sparse ? avg_active_tiles / (double)num_tiles : 1.0);
+        print_throughput(rows, cols, gens_run, ker_ms, model_bytes, peak_gb_s);
 
-    // Save the measured result row to a CSV file when requested.
-    if (csv && out_path) {
-        append_csv_row(out_path, mode, rows, cols, iters, wrap, lx, ly,
-                       h2d_ms, ker_ms, d2h_ms, total_ms, wall_total_ms, tiled);
+        // Save the measured result row to a CSV file when requested.
+        if (csv && out_path) {
+            const CsvRow row = {
+                .mode = mode, .rows = rows, .cols = cols, .iters = gens_run, .wrap = wrap, .lx = lx, .ly = ly,
+                .h2d_ms = h2d_ms, .kernel_ms = ker_ms, .d2h_ms = d2h_ms, .total_ms = total_ms, .wall_total_ms = wall_total_ms,
+                .tiled = tiled, .packed = packed, .sparse = sparse, .steps_per_launch = steps_per_launch, .pipeline = pipeline,
+                .rule = rule_name, .states = states,
+                .kernel_cache = gol_build_label(&build_stats), .build_ms = build_stats.build_ms,
+                .kernel_spread = kernel_spread, .wall_spread = wall_spread, .gen_hist = gen_hist, .perf = perf,
+                .model_bytes_per_cell = model_bytes, .peak_gb_s = peak_gb_s,
+                .zero_copy = zero_copy, .saved_copy_ms = copy_transfer_ms - (h2d_ms + d2h_ms)
+            };
+            append_csv_row(out_path, &row);
+        }
+        status = save_result(save_path, h_tmp, rows, cols, base_generation + (uint64_t)gens_run, seed, wrap, rule, states);
     }
+    if (gen_stats_file && fclose(gen_stats_file) != 0) fprintf(stderr, "Could not write statistics file: %s\n", gen_stats_path);
+    if (perf) gol_perf_close(perf);
 
     // Release all allocated OpenCL objects.
-    clReleaseMemObject(d_a);
-    clReleaseMemObject(d_b);
-    clReleaseKernel(kernel);
-    clReleaseProgram(program);
-    clReleaseCommandQueue(queue);
-    clReleaseContext(context);
+    if (d_init) clReleaseMemObject(d_init);
+    free(h_stats);
+    gol_stats_history_free(&stats_history);
+    gol_engine_destroy(engine);
 
     // Free the host-side grid buffers.
-    free(h_grid);
+    free_initial_grid(h_grid, &snapshot_map);
     free(h_tmp);
-    return 0;
+    free(gen_hist);
+    return status;
 }
@@ -23,6 +23,10 @@ for %%S in (512 1024 2048 4096) do (
     %EXE% --mode cpu_seq --rows %%S --cols %%S --iters !ITERS! --wrap 0 --seed 12345 --repeat 3 --warmup 1 --csv --out %OUT%
     echo.
 
+    echo [CPU] Parallel, all threads
+    %EXE% --mode cpu_par --rows %%S --cols %%S --iters !ITERS! --wrap 0 --seed 12345 --repeat 3 --warmup 1 --csv --out %OUT%
+    echo.
+
     echo [GPU] Naive 16x16
     %EXE% --mode gpu --rows %%S --cols %%S --iters !ITERS! --wrap 0 --lx 16 --ly 16 --seed 12345 --repeat 5 --warmup 1 --csv --out %OUT%
     echo.
@@ -37,6 +41,10 @@ for %%S in (512 1024 2048 4096) do (
 
     echo [GPU] Tiled 16x16
     %EXE% --mode gpu --rows %%S --cols %%S --iters !ITERS! --wrap 0 --tiled 1 --lx 16 --ly 16 --seed 12345 --repeat 5 --warmup 1 --csv --out %OUT%
+    echo.
+
+    echo [GPU] Packed 16x4
+    %EXE% --mode gpu --rows %%S --cols %%S --iters !ITERS! --wrap 0 --packed 1 --lx 16 --ly 4 --seed 12345 --repeat 5 --warmup 1 --csv --out %OUT%
 
     echo.
 )
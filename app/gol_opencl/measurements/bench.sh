@@ -0,0 +1,26 @@
+#!/bin/sh
+# Linux counterpart of bench.bat: the same sweep, run in-process by "gol_opencl bench".
+set -e
+
+cd "$(dirname "$0")/.."
+EXE=./gol_opencl
+OUT=measurements/results.csv
+SIZES=512:2000,1024:1000,2048:500,4096:250
+
+rm -f "$OUT"
+
+echo "Running OpenCL Game of Life benchmarks..."
+echo "Output file: $OUT"
+echo
+
+echo "[CPU] Sequential baseline, parallel with all threads"
+"$EXE" bench --sizes "$SIZES" --modes cpu_seq,cpu_par --wrap 0 --seed 12345 --repeat 3 --warmup 1 --out "$OUT"
+echo
+
+echo "[GPU] Naive 16x16, tiled 4x4 / 8x8 / 16x16, packed 16x4"
+"$EXE" bench --sizes "$SIZES" --modes naive@16x16,tiled@4x4,tiled@8x8,tiled@16x16,packed@16x4 \
+    --wrap 0 --seed 12345 --repeat 5 --warmup 1 --out "$OUT"
+echo
+
+echo "Benchmark finished."
+echo "Results saved to $OUT"
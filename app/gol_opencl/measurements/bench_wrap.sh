@@ -0,0 +1,20 @@
+#!/bin/sh
+# Linux counterpart of bench_wrap.bat, run in-process by "gol_opencl bench".
+set -e
+
+cd "$(dirname "$0")/.."
+EXE=./gol_opencl
+OUT=measurements/results_wrap.csv
+
+rm -f "$OUT"
+
+echo "Running wrap comparison benchmarks..."
+echo "Output file: $OUT"
+echo
+
+"$EXE" bench --sizes 1024:1000,2048:500 --modes naive,tiled --local 16x16 --wrap 0,1 \
+    --seed 12345 --repeat 5 --warmup 1 --out "$OUT"
+
+echo
+echo "Wrap benchmark finished."
+echo "Results saved to $OUT"
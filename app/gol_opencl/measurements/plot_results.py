@@ -24,12 +24,29 @@ def label_row(row):
     mode = str(row["mode"])
     if mode == "cpu_seq":
         return "cpu seq"
+    if mode == "cpu_par":
+        return f"cpu par {int(row['lx'])}t"
+    if mode == "hashlife":
+        return "hashlife"
+    if mode == "gpu_stream":
+        return f"stream {int(row['lx'])}x{int(row['ly'])} k{int(row['steps_per_launch'])}"
+    if mode == "gpu_multi":
+        return f"multi {int(row['devices'])}dev {int(row['lx'])}x{int(row['ly'])}"
     if mode == "gpu_naive":
         return f"naive {int(row['lx'])}x{int(row['ly'])}"
+    if mode == "gpu_packed":
+        return f"packed {int(row['lx'])}x{int(row['ly'])}"
+    steps = int(row["steps_per_launch"]) if "steps_per_launch" in row and pd.notna(row["steps_per_launch"]) else 1
+    if steps > 1:
+        return f"tiled {int(row['lx'])}x{int(row['ly'])} k{steps}"
     return f"tiled {int(row['lx'])}x{int(row['ly'])}"
 
 # Add helper columns used by the plots.
 df["label"] = df.apply(label_row, axis=1)
+# Runs of other rules than B3/S23 get their own series.
+if "rule" in df.columns:
+    other_rule = df["rule"].notna() & (df["rule"] != "B3/S23")
+    df.loc[other_rule, "label"] = df.loc[other_rule, "label"] + " " + df.loc[other_rule, "rule"]
 df["cells"] = df["rows"] * df["cols"]
 df["size_label"] = df.apply(lambda r: f"{int(r['rows'])}x{int(r['cols'])}", axis=1)
 df["kernel_per_iter_ms"] = df["kernel_ms"] / df["iters"]
@@ -52,6 +69,7 @@ preferred_order = [
     "tiled 4x4",
     "tiled 8x8",
     "tiled 16x16",
+    "packed 16x4",
 ]
 
 
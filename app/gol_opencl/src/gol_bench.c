@@ -0,0 +1,355 @@
+#include "../include/gol_bench.h"
+#include "../include/gol_cl.h"
+#include "../include/gol_cpu_par.h"
+#include "../include/gol_cpu_seq.h"
+#include "../include/gol_random.h"
+#include "../include/gol_rule.h"
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Live-cell fraction of the sweep's random boards, the command line's default --density.
+#define BENCH_DENSITY 0.5
+
+// Split a comma-separated list; each item is handed to parse_item, which returns 0 on error.
+static int bench_parse_list(const char* text, int max, void* ctx, int (*parse_item)(const char* item, int index, void* ctx)) {
+    char buf[512];
+    if (strlen(text) >= sizeof(buf)) return -1;
+    strcpy(buf, text);
+    int n = 0;
+    for (char* item = strtok(buf, ","); item; item = strtok(NULL, ",")) {
+        if (n >= max || !parse_item(item, n, ctx)) return -1;
+        ++n;
+    }
+    return n;
+}
+
+// "LXxLY" local size.
+static int bench_parse_local(const char* text, size_t* lx, size_t* ly) {
+    unsigned a = 0, b = 0;
+    char tail = 0;
+    if (sscanf(text, "%ux%u%c", &a, &b, &tail) != 2 || a == 0 || b == 0) return 0;
+    *lx = a;
+    *ly = b;
+    return 1;
+}
+
+static int bench_parse_size(const char* item, int index, void* ctx) {
+    GolBenchSize* s = &((GolBenchSpec*)ctx)->sizes[index];
+    // "N", "RxC", optionally followed by ":ITERS".
+    char tail = 0;
+    s->iters = 0;
+    if (sscanf(item, "%dx%d:%d%c", &s->rows, &s->cols, &s->iters, &tail) == 3) return s->rows > 0 && s->cols > 0 && s->iters > 0;
+    if (sscanf(item, "%dx%d%c", &s->rows, &s->cols, &tail) == 2) return s->rows > 0 && s->cols > 0;
+    if (sscanf(item, "%d:%d%c", &s->rows, &s->iters, &tail) == 2) {
+        s->cols = s->rows;
+        return s->rows > 0 && s->iters > 0;
+    }
+    if (sscanf(item, "%d%c", &s->rows, &tail) == 1) {
+        s->cols = s->rows;
+        return s->rows > 0;
+    }
+    return 0;
+}
+
+static int bench_parse_mode(const char* item, int index, void* ctx) {
+    GolBenchModeItem* m = &((GolBenchSpec*)ctx)->modes[index];
+    static const char* const names[] = { "cpu_seq", "cpu_par", "naive", "tiled", "packed" };
+    const char* at = strchr(item, '@');
+    const size_t len = at ? (size_t)(at - item) : strlen(item);
+    m->lx = m->ly = 0;
+    if (at && !bench_parse_local(at + 1, &m->lx, &m->ly)) return 0;
+    for (int i = 0; i < (int)(sizeof(names) / sizeof(names[0])); ++i) {
+        if (strlen(names[i]) == len && !strncmp(item, names[i], len)) {
+            m->mode = (GolBenchMode)i;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int bench_parse_local_item(const char* item, int index, void* ctx) {
+    GolBenchSpec* spec = (GolBenchSpec*)ctx;
+    return bench_parse_local(item, &spec->local[index][0], &spec->local[index][1]);
+}
+
+static int bench_parse_wrap(const char* item, int index, void* ctx) {
+    int* wraps = ((GolBenchSpec*)ctx)->wraps;
+    wraps[index] = atoi(item);
+    return !strcmp(item, "0") || !strcmp(item, "1");
+}
+
+static int bench_parse_steps(const char* item, int index, void* ctx) {
+    int* steps = ((GolBenchSpec*)ctx)->steps;
+    steps[index] = atoi(item);
+    return steps[index] > 0;
+}
+
+static void bench_usage(const char* argv0) {
+    printf("Usage: %s bench [--sizes N|RxC[:ITERS],...] [--iters N] [--modes cpu_seq|cpu_par|naive|tiled|packed[@LXxLY],...] "
+           "[--local LXxLY,...] [--wrap 0,1] [--steps K,...] [--repeat N] [--warmup N] [--threads N] [--seed N] [--rule B3/S23] "
+           "[--out FILE] [--kernel-dir DIR] [--kernel-cache 0|1] [--kernel-cache-dir DIR] [--roofline]\n", argv0);
+    printf("Defaults: sizes=512:2000,1024:1000,2048:500,4096:250 iters=500 modes=cpu_seq,cpu_par,naive,tiled,packed "
+           "local=16x16 wrap=0 steps=1 repeat=5 warmup=1 threads=all seed=12345 rule=B3/S23 out=none "
+           "kernel-cache-dir=none\n");
+}
+
+int gol_bench_parse(GolBenchSpec* spec, int argc, char** argv, const char* argv0) {
+    memset(spec, 0, sizeof(*spec));
+    spec->iters = 500;
+    spec->repeat = 5;
+    spec->warmup = 1;
+    spec->seed = 12345u;
+    spec->rule = GOL_RULE_CONWAY;
+    int kernel_cache_on = 1;
+    const char* kernel_cache_dir = NULL;
+    const char* sizes_arg = "512:2000,1024:1000,2048:500,4096:250";
+    const char* modes_arg = "cpu_seq,cpu_par,naive,tiled,packed";
+    const char* local_arg = "16x16";
+    const char* wrap_arg = "0";
+    const char* steps_arg = "1";
+    const char* rule_arg = NULL;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--sizes") && i + 1 < argc) sizes_arg = argv[++i];
+        else if (!strcmp(argv[i], "--iters") && i + 1 < argc) spec->iters = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--modes") && i + 1 < argc) modes_arg = argv[++i];
+        else if (!strcmp(argv[i], "--local") && i + 1 < argc) local_arg = argv[++i];
+        else if (!strcmp(argv[i], "--wrap") && i + 1 < argc) wrap_arg = argv[++i];
+        else if (!strcmp(argv[i], "--steps") && i + 1 < argc) steps_arg = argv[++i];
+        else if (!strcmp(argv[i], "--repeat") && i + 1 < argc) spec->repeat = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--warmup") && i + 1 < argc) spec->warmup = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--threads") && i + 1 < argc) spec->threads = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--seed") && i + 1 < argc) spec->seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+        else if (!strcmp(argv[i], "--rule") && i + 1 < argc) rule_arg = argv[++i];
+        else if (!strcmp(argv[i], "--out") && i + 1 < argc) spec->out_path = argv[++i];
+        else if (!strcmp(argv[i], "--kernel-dir") && i + 1 < argc) spec->kernel_dir = argv[++i];
+        else if (!strcmp(argv[i], "--kernel-cache") && i + 1 < argc) kernel_cache_on = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--kernel-cache-dir") && i + 1 < argc) kernel_cache_dir = argv[++i];
+        else if (!strcmp(argv[i], "--roofline")) spec->roofline = 1;
+        else if (!strcmp(argv[i], "-h") || !strcmp(argv[i], "--help")) { bench_usage(argv0); return 1; }
+        else {
+            printf("Unknown bench arg: %s\n", argv[i]);
+            bench_usage(argv0);
+            return -1;
+        }
+    }
+    spec->kernel_cache = kernel_cache_on ? kernel_cache_dir : NULL;
+
+    spec->n_sizes = bench_parse_list(sizes_arg, GOL_BENCH_MAX_ITEMS, spec, bench_parse_size);
+    spec->n_modes = bench_parse_list(modes_arg, GOL_BENCH_MAX_ITEMS, spec, bench_parse_mode);
+    spec->n_local = bench_parse_list(local_arg, GOL_BENCH_MAX_ITEMS, spec, bench_parse_local_item);
+    spec->n_wraps = bench_parse_list(wrap_arg, GOL_BENCH_MAX_ITEMS, spec, bench_parse_wrap);
+    spec->n_steps = bench_parse_list(steps_arg, GOL_BENCH_MAX_ITEMS, spec, bench_parse_steps);
+    if (spec->n_sizes <= 0 || spec->n_modes <= 0 || spec->n_local <= 0 || spec->n_wraps <= 0 || spec->n_steps <= 0) {
+        fprintf(stderr, "Malformed sweep specification.\n");
+        bench_usage(argv0);
+        return -1;
+    }
+    if (spec->iters <= 0 || spec->repeat <= 0 || spec->warmup < 0) {
+        fprintf(stderr, "iters and repeat must be > 0 and warmup must be >= 0\n");
+        return -1;
+    }
+    // The step kernels index cells with int; a GPU sweep rejects larger boards up front
+    // instead of skipping each of their points.
+    for (int i = 0; i < spec->n_sizes && gol_bench_needs_gpu(spec); ++i) {
+        if ((uint64_t)spec->sizes[i].rows * (uint64_t)spec->sizes[i].cols > (uint64_t)INT_MAX) {
+            fprintf(stderr, "Board %dx%d exceeds the OpenCL kernels' %d-cell index range.\n",
+                    spec->sizes[i].rows, spec->sizes[i].cols, INT_MAX);
+            return -1;
+        }
+    }
+    int states = 2;
+    if (rule_arg) {
+        int rc = gol_rule_parse(rule_arg, &spec->rule, &states);
+        if (rc != 0) {
+            fprintf(stderr, "%s rule: %s\n", rc == -2 ? "Unsupported (B0)" : "Malformed", rule_arg);
+            return -1;
+        }
+    }
+    if (states > 2) {
+        fprintf(stderr, "The bench sweep runs Life-like rules only.\n");
+        return -1;
+    }
+    return 0;
+}
+
+int gol_bench_needs_gpu(const GolBenchSpec* spec) {
+    for (int m = 0; m < spec->n_modes; ++m) {
+        if (spec->modes[m].mode >= GOL_BENCH_NAIVE) return 1;
+    }
+    return 0;
+}
+
+// Run one CPU point, one engine call per run so each run gets its own sample. The thread pool
+// is created once, so warmup and measured runs reuse the same threads. Returns 0 on failure.
+static int bench_cpu_point(const GolBenchSpec* spec, GolBenchPoint* point, const unsigned char* initial) {
+    const size_t n = (size_t)point->rows * (size_t)point->cols;
+    unsigned char* cpu_a = (unsigned char*)malloc(n);
+    unsigned char* cpu_b = (unsigned char*)malloc(n);
+    GolCpuPool* pool = point->mode == GOL_BENCH_CPU_PAR ? gol_cpu_pool_create(spec->threads) : NULL;
+    int ok = cpu_a && cpu_b && (pool || point->mode == GOL_BENCH_CPU_SEQ);
+    if (!ok) fprintf(stderr, "CPU benchmark setup failed.\n");
+
+    for (int run = 0; ok && run < spec->warmup + spec->repeat; ++run) {
+        memcpy(cpu_a, initial, n);
+        const double start_ms = gol_now_ms();
+        if (pool) {
+            ok = gol_cpu_par_run(pool, cpu_a, cpu_b, point->rows, point->cols, point->iters, point->wrap, spec->rule) != NULL;
+            if (!ok) fprintf(stderr, "CPU parallel engine allocation failed.\n");
+        } else {
+            for (int t = 0; t < point->iters; ++t) {
+                gol_cpu_step(cpu_a, cpu_b, point->rows, point->cols, point->wrap, spec->rule, 2);
+                unsigned char* tmp = cpu_a;
+                cpu_a = cpu_b;
+                cpu_b = tmp;
+            }
+        }
+        const double ms = gol_now_ms() - start_ms;
+        if (run >= spec->warmup) point->kernel_ms[run - spec->warmup] = point->wall_ms[run - spec->warmup] = ms;
+    }
+    point->lx = pool ? (size_t)gol_cpu_pool_threads(pool) : 1u;
+    point->ly = 1u;
+
+    gol_cpu_pool_destroy(pool);
+    free(cpu_a);
+    free(cpu_b);
+    return ok;
+}
+
+/*
+ * Run one GPU point the way the non-pipelined gpu mode does: upload, one waited
+ * launch per steps generations, download. Fills the per-run times of the measured
+ * runs and the per-generation histogram. Returns 1 when the point ran, 0 when the
+ * local size does not fit the device or kernel, and -1 when the engine failed.
+ */
+static int bench_gpu_point(const GolBenchSpec* spec, GolEngine* engine, GolBenchPoint* point,
+                           const unsigned char* initial, unsigned char* result, GolHistogram* hist)
+{
+    GolEngineConfig config;
+    memset(&config, 0, sizeof(config));
+    config.tiled = point->mode == GOL_BENCH_TILED;
+    config.packed = point->mode == GOL_BENCH_PACKED;
+    config.lx = (int)point->lx;
+    config.ly = (int)point->ly;
+    config.steps_per_launch = point->steps_per_launch;
+    int rc = gol_engine_configure(engine, &config);
+    if (rc == GOL_ENGINE_OK) rc = gol_engine_prepare(engine, point->rows, point->cols, spec->rule);
+    if (rc == GOL_ENGINE_EARG) return 0;
+
+    const int steps = point->steps_per_launch;
+    gol_hist_reset(hist);
+    for (int run = 0; rc == GOL_ENGINE_OK && run < spec->warmup + spec->repeat; ++run) {
+        const double wall_start_ms = gol_now_ms();
+        rc = gol_load(engine, initial, point->rows, point->cols, point->wrap, spec->rule);
+        if (rc == GOL_ENGINE_OK) rc = gol_step_n(engine, point->iters);
+        if (rc == GOL_ENGINE_OK) rc = gol_read(engine, result);
+        if (rc != GOL_ENGINE_OK || run < spec->warmup) continue;
+
+        GolEngineProfile profile;
+        gol_engine_profile(engine, &profile);
+        for (int k = 0; k < profile.launches; ++k) {
+            const int first = k * steps;
+            const int launch_steps = (point->iters - first < steps) ? (point->iters - first) : steps;
+            gol_hist_record(hist, profile.launch_ns[k] / (uint64_t)launch_steps, (uint64_t)launch_steps);
+        }
+        const int i = run - spec->warmup;
+        point->h2d_ms[i] = (double)profile.load_ns / 1e6;
+        point->kernel_ms[i] = (double)profile.step_ns / 1e6;
+        point->d2h_ms[i] = (double)profile.read_ns / 1e6;
+        point->wall_ms[i] = gol_now_ms() - wall_start_ms;
+    }
+    if (rc != GOL_ENGINE_OK) {
+        fprintf(stderr, "Bench point failed: %s\n", gol_engine_message(engine));
+        return -1;
+    }
+    return 1;
+}
+
+int gol_bench_run(const GolBenchSpec* spec, GolEngine* engine, GolBenchReport report, void* ctx, int* skipped) {
+    double* samples = (double*)malloc(4 * (size_t)spec->repeat * sizeof(double));
+    GolHistogram* hist = (GolHistogram*)malloc(sizeof(GolHistogram));
+    if (!samples || !hist) {
+        fprintf(stderr, "Host allocation failed (bench samples)\n");
+        free(samples);
+        free(hist);
+        return -1;
+    }
+    int points = 0;
+    *skipped = 0;
+
+    for (int s = 0; points >= 0 && s < spec->n_sizes; ++s) {
+        const int rows = spec->sizes[s].rows;
+        const int cols = spec->sizes[s].cols;
+        const size_t n = (size_t)rows * (size_t)cols;
+        unsigned char* initial = (unsigned char*)malloc(n);
+        unsigned char* result = (unsigned char*)malloc(n);
+        if (!initial || !result) {
+            fprintf(stderr, "Host allocation failed (%d x %d board)\n", rows, cols);
+            free(initial);
+            free(result);
+            points = -1;
+            break;
+        }
+        gol_random_fill(initial, n, spec->seed, BENCH_DENSITY, 0);
+
+        for (int w = 0; points >= 0 && w < spec->n_wraps; ++w) {
+            for (int m = 0; points >= 0 && m < spec->n_modes; ++m) {
+                const GolBenchModeItem* item = &spec->modes[m];
+                GolBenchPoint point;
+                memset(&point, 0, sizeof(point));
+                point.mode = item->mode;
+                point.rows = rows;
+                point.cols = cols;
+                point.iters = spec->sizes[s].iters > 0 ? spec->sizes[s].iters : spec->iters;
+                point.wrap = spec->wraps[w];
+                point.steps_per_launch = 1;
+                point.kernel_ms = samples + spec->repeat;
+                point.wall_ms = samples + 3 * spec->repeat;
+
+                if (item->mode == GOL_BENCH_CPU_SEQ || item->mode == GOL_BENCH_CPU_PAR) {
+                    points = bench_cpu_point(spec, &point, initial) && report(&point, ctx) ? points + 1 : -1;
+                    continue;
+                }
+
+                // GPU kernels: every local size, and every steps value for the tiled kernel.
+                point.h2d_ms = samples;
+                point.d2h_ms = samples + 2 * spec->repeat;
+                point.gen_hist = hist;
+                const int n_local = item->lx ? 1 : spec->n_local;
+                const int n_steps = item->mode == GOL_BENCH_TILED ? spec->n_steps : 1;
+                for (int l = 0; points >= 0 && l < n_local; ++l) {
+                    point.lx = item->lx ? item->lx : spec->local[l][0];
+                    point.ly = item->lx ? item->ly : spec->local[l][1];
+                    for (int k = 0; points >= 0 && k < n_steps; ++k) {
+                        point.steps_per_launch = item->mode == GOL_BENCH_TILED ? spec->steps[k] : 1;
+                        const GolBuildStats before = *gol_engine_build_stats(engine);
+                        const int ran = bench_gpu_point(spec, engine, &point, initial, result, hist);
+                        if (ran == 0) {
+                            printf("Skipped %s %ux%u k=%d: local size not supported by the device\n",
+                                   item->mode == GOL_BENCH_PACKED ? "packed" : item->mode == GOL_BENCH_TILED ? "tiled" : "naive",
+                                   (unsigned)point.lx, (unsigned)point.ly, point.steps_per_launch);
+                            ++*skipped;
+                            continue;
+                        }
+                        // Only the first point that needs a program pays for its build.
+                        const GolBuildStats* after = gol_engine_build_stats(engine);
+                        point.build.hits = after->hits - before.hits;
+                        point.build.misses = after->misses - before.misses;
+                        point.build.build_ms = after->build_ms - before.build_ms;
+                        point.build.reused = after->build_ms == before.build_ms;
+                        points = ran > 0 && report(&point, ctx) ? points + 1 : -1;
+                    }
+                }
+            }
+        }
+        free(initial);
+        free(result);
+    }
+
+    free(samples);
+    free(hist);
+    return points;
+}
@@ -0,0 +1,38 @@
+#include "../include/gol_bitpack.h"
+
+#include <string.h>
+
+// Round the column count up to whole 64-bit words.
+size_t gol_packed_words_per_row(int cols) {
+    return ((size_t)cols + 63u) / 64u;
+}
+
+// Pack one byte per cell into one bit per cell, row by row.
+void gol_pack_grid(const unsigned char* grid, uint64_t* packed, int rows, int cols) {
+    const size_t wpr = gol_packed_words_per_row(cols);
+
+    for (int x = 0; x < rows; ++x) {
+        const unsigned char* src = grid + (size_t)x * (size_t)cols;
+        uint64_t* dst = packed + (size_t)x * wpr;
+
+        // Clear the row first so the padding bits of the last word stay zero.
+        memset(dst, 0, wpr * sizeof(uint64_t));
+        for (int y = 0; y < cols; ++y) {
+            if (src[y]) dst[y >> 6] |= (uint64_t)1 << (y & 63);
+        }
+    }
+}
+
+// Expand every packed bit back into a 0/1 byte.
+void gol_unpack_grid(const uint64_t* packed, unsigned char* grid, int rows, int cols) {
+    const size_t wpr = gol_packed_words_per_row(cols);
+
+    for (int x = 0; x < rows; ++x) {
+        const uint64_t* src = packed + (size_t)x * wpr;
+        unsigned char* dst = grid + (size_t)x * (size_t)cols;
+
+        for (int y = 0; y < cols; ++y) {
+            dst[y] = (unsigned char)((src[y >> 6] >> (y & 63)) & 1u);
+        }
+    }
+}
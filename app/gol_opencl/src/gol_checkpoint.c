@@ -0,0 +1,165 @@
+#include "../include/gol_checkpoint.h"
+#include "../include/gol_bitpack.h"
+#include "../include/gol_generations.h"
+#include "../include/gol_pattern.h"
+#include "../include/gol_rule.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+// Replace path with the finished temporary file so a crash mid-write never leaves a torn checkpoint.
+static int replace_file(const char* from, const char* to) {
+#ifdef _WIN32
+    return MoveFileExA(from, to, MOVEFILE_REPLACE_EXISTING) ? 0 : -1;
+#else
+    return rename(from, to);
+#endif
+}
+
+static void* checkpoint_writer_main(void* arg) {
+    GolCheckpointWriter* w = (GolCheckpointWriter*)arg;
+    for (;;) {
+        GolCheckpointSlot* slot = &w->slots[w->drain];
+        pthread_mutex_lock(&w->lock);
+        while (!slot->pending && !w->quit) pthread_cond_wait(&w->cond, &w->lock);
+        if (!slot->pending) {
+            pthread_mutex_unlock(&w->lock);
+            break;
+        }
+        pthread_mutex_unlock(&w->lock);
+
+        // Waiting for the read here keeps the simulation thread free to enqueue more generations.
+        const double start_ms = gol_now_ms();
+        cl_int err = clWaitForEvents(1, &slot->ready);
+        clReleaseEvent(slot->ready);
+        slot->ready = NULL;
+
+        int rc = -1;
+        if (err == CL_SUCCESS) {
+            const unsigned char* cells = (const unsigned char*)slot->host;
+            if (w->packed) {
+                gol_unpack_grid((const uint64_t*)slot->host, w->unpacked, w->rows, w->cols);
+                cells = w->unpacked;
+            } else if (w->state_bits > 0) {
+                gol_gens_unpack((const uint32_t*)slot->host, w->unpacked, w->rows, w->cols, w->state_bits);
+                cells = w->unpacked;
+            }
+
+            GolSnapshotHeader meta;
+            memset(&meta, 0, sizeof(meta));
+            meta.generation = slot->generation;
+            meta.seed = w->seed;
+            meta.wrap = (uint32_t)w->wrap;
+            gol_rule_format(w->rule, w->states, meta.rule, sizeof(meta.rule));
+            rc = gol_pattern_save(w->tmp_path, GOL_FORMAT_SNAPSHOT, cells, w->rows, w->cols, &meta);
+            if (rc == 0 && replace_file(w->tmp_path, w->path) != 0) rc = -1;
+        }
+        if (rc == 0) {
+            ++w->written;
+            w->last_generation = slot->generation;
+        } else {
+            fprintf(stderr, "Checkpoint at generation %llu could not be written to %s\n",
+                    (unsigned long long)slot->generation, w->path);
+            ++w->failed;
+        }
+        w->write_ms += gol_now_ms() - start_ms;
+
+        pthread_mutex_lock(&w->lock);
+        slot->pending = 0;
+        w->drain = (w->drain + 1) % GOL_CHECKPOINT_SLOTS;
+        pthread_cond_broadcast(&w->cond);
+        pthread_mutex_unlock(&w->lock);
+    }
+    return NULL;
+}
+
+int gol_checkpoint_start(GolCheckpointWriter* w, cl_context context, cl_command_queue queue,
+                         const char* path, size_t bytes, int rows, int cols,
+                         int packed, int wrap, uint32_t rule, int states, unsigned int seed)
+{
+    memset(w, 0, sizeof(*w));
+    w->path = path;
+    w->bytes = bytes;
+    w->rows = rows;
+    w->cols = cols;
+    w->packed = packed;
+    w->wrap = wrap;
+    w->rule = rule;
+    w->states = states;
+    w->state_bits = states > 2 ? gol_gens_bits_per_cell(states) : 0;
+    w->seed = seed;
+    if (snprintf(w->tmp_path, sizeof(w->tmp_path), "%s.tmp", path) >= (int)sizeof(w->tmp_path)) {
+        fprintf(stderr, "Checkpoint path is too long: %s\n", path);
+        return 0;
+    }
+    if (packed || w->state_bits > 0) {
+        w->unpacked = (unsigned char*)malloc((size_t)rows * (size_t)cols);
+        if (!w->unpacked) {
+            fprintf(stderr, "Host allocation failed (checkpoint board)\n");
+            return 0;
+        }
+    }
+
+    // Pinned memory lets the non-blocking read run as a plain DMA transfer.
+    cl_int err;
+    for (int s = 0; s < GOL_CHECKPOINT_SLOTS; ++s) {
+        GolCheckpointSlot* slot = &w->slots[s];
+        slot->staging = clCreateBuffer(context, CL_MEM_READ_WRITE | CL_MEM_ALLOC_HOST_PTR, bytes, NULL, &err);
+        if (!slot->staging || err != CL_SUCCESS) gol_die_cl("clCreateBuffer(checkpoint staging)", err);
+        slot->host = clEnqueueMapBuffer(queue, slot->staging, CL_TRUE, CL_MAP_READ | CL_MAP_WRITE,
+                                        0, bytes, 0, NULL, NULL, &err);
+        if (!slot->host || err != CL_SUCCESS) gol_die_cl("clEnqueueMapBuffer(checkpoint staging)", err);
+    }
+
+    pthread_mutex_init(&w->lock, NULL);
+    pthread_cond_init(&w->cond, NULL);
+    if (pthread_create(&w->thread, NULL, checkpoint_writer_main, w) != 0) {
+        fprintf(stderr, "Could not start the checkpoint writer thread.\n");
+        exit(1);
+    }
+    return 1;
+}
+
+void gol_checkpoint_enqueue(GolCheckpointWriter* w, cl_command_queue queue, cl_mem board, uint64_t generation) {
+    GolCheckpointSlot* slot = &w->slots[w->fill];
+    pthread_mutex_lock(&w->lock);
+    while (slot->pending) pthread_cond_wait(&w->cond, &w->lock);
+    pthread_mutex_unlock(&w->lock);
+
+    cl_int err = clEnqueueReadBuffer(queue, board, CL_FALSE, 0, w->bytes, slot->host, 0, NULL, &slot->ready);
+    if (err != CL_SUCCESS) gol_die_cl("clEnqueueReadBuffer(checkpoint)", err);
+    clFlush(queue);
+
+    pthread_mutex_lock(&w->lock);
+    slot->generation = generation;
+    slot->pending = 1;
+    pthread_cond_broadcast(&w->cond);
+    pthread_mutex_unlock(&w->lock);
+    w->fill = (w->fill + 1) % GOL_CHECKPOINT_SLOTS;
+}
+
+void gol_checkpoint_finish(GolCheckpointWriter* w, cl_command_queue queue) {
+    pthread_mutex_lock(&w->lock);
+    w->quit = 1;
+    pthread_cond_broadcast(&w->cond);
+    pthread_mutex_unlock(&w->lock);
+    pthread_join(w->thread, NULL);
+    pthread_cond_destroy(&w->cond);
+    pthread_mutex_destroy(&w->lock);
+
+    for (int s = 0; s < GOL_CHECKPOINT_SLOTS; ++s) {
+        clEnqueueUnmapMemObject(queue, w->slots[s].staging, w->slots[s].host, 0, NULL, NULL);
+    }
+    clFinish(queue);
+    for (int s = 0; s < GOL_CHECKPOINT_SLOTS; ++s) clReleaseMemObject(w->slots[s].staging);
+    free(w->unpacked);
+}
+
+int gol_checkpoint_due(int every, uint64_t before, uint64_t after) {
+    return every > 0 && after / (uint64_t)every > before / (uint64_t)every;
+}
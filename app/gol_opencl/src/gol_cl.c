@@ -0,0 +1,181 @@
+#include "../include/gol_cl.h"
+#include "../include/gol_program_cache.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+double gol_now_ms(void) {
+#ifdef _WIN32
+    static LARGE_INTEGER freq;
+    static int initialized = 0;
+    LARGE_INTEGER counter;
+    if (!initialized) {
+        QueryPerformanceFrequency(&freq);
+        initialized = 1;
+    }
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart * 1000.0 / (double)freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1e6;
+#endif
+}
+
+void gol_die_cl(const char* where, cl_int err) {
+    fprintf(stderr, "[OpenCL ERROR] %s failed, code=%d\n", where, err);
+    exit(1);
+}
+
+cl_ulong gol_event_ns(cl_event ev) {
+    cl_ulong s = 0, e = 0;
+    clGetEventProfilingInfo(ev, CL_PROFILING_COMMAND_START, sizeof(s), &s, NULL);
+    clGetEventProfilingInfo(ev, CL_PROFILING_COMMAND_END, sizeof(e), &e, NULL);
+    return e - s;
+}
+
+size_t gol_round_up(size_t value, size_t multiple) {
+    if (multiple == 0) return value;
+    size_t rem = value % multiple;
+    return rem == 0 ? value : value + (multiple - rem);
+}
+
+void gol_print_device_info(cl_device_id dev) {
+    char name[256];
+    char vendor[256];
+    cl_uint cu = 0;
+    cl_ulong gmem = 0;
+
+    clGetDeviceInfo(dev, CL_DEVICE_NAME, sizeof(name), name, NULL);
+    clGetDeviceInfo(dev, CL_DEVICE_VENDOR, sizeof(vendor), vendor, NULL);
+    clGetDeviceInfo(dev, CL_DEVICE_MAX_COMPUTE_UNITS, sizeof(cu), &cu, NULL);
+    clGetDeviceInfo(dev, CL_DEVICE_GLOBAL_MEM_SIZE, sizeof(gmem), &gmem, NULL);
+
+    printf("Device: %s (%s), CU=%u, GlobalMem=%.2f MB\n",
+           name, vendor, cu, (double)gmem / (1024.0 * 1024.0));
+}
+
+void gol_print_kernel_load_error(const char* name, const char* kernel_dir, int code) {
+    if (code == -6) fprintf(stderr, "Kernel %s is not embedded in this build.\n", name);
+    else if (kernel_dir) fprintf(stderr, "Kernel source load failed: %s/%s (code %d)\n", kernel_dir, name, code);
+    else fprintf(stderr, "Kernel source load failed: %s (code %d)\n", name, code);
+}
+
+int gol_local_size_fits(cl_device_id device, cl_kernel kernel, size_t lx, size_t ly, int tiled, int steps,
+                        char* why, size_t why_size)
+{
+    size_t max_wg = 0;
+    size_t max_wi[3] = {0, 0, 0};
+    clGetDeviceInfo(device, CL_DEVICE_MAX_WORK_GROUP_SIZE, sizeof(max_wg), &max_wg, NULL);
+    clGetDeviceInfo(device, CL_DEVICE_MAX_WORK_ITEM_SIZES, sizeof(max_wi), max_wi, NULL);
+    if (lx == 0 || ly == 0 || lx > max_wi[0] || ly > max_wi[1] || lx * ly > max_wg) {
+        snprintf(why, why_size, "invalid local size %ux%u for this device (max_wi=%ux%u, max_wg=%u)",
+                 (unsigned)lx, (unsigned)ly, (unsigned)max_wi[0], (unsigned)max_wi[1], (unsigned)max_wg);
+        return 0;
+    }
+
+    // Local memory kernels may allow fewer work-items per group than the device maximum.
+    size_t kernel_wg = 0;
+    if (kernel && clGetKernelWorkGroupInfo(kernel, device, CL_KERNEL_WORK_GROUP_SIZE, sizeof(kernel_wg),
+                                           &kernel_wg, NULL) == CL_SUCCESS && lx * ly > kernel_wg) {
+        snprintf(why, why_size, "local size %ux%u exceeds the kernel's work-group limit of %u",
+                 (unsigned)lx, (unsigned)ly, (unsigned)kernel_wg);
+        return 0;
+    }
+
+    // The tile of a K-step launch is (lx + 2K) x (ly + 2K); multi-step launches keep two of them.
+    if (tiled) {
+        cl_ulong local_mem = 0;
+        clGetDeviceInfo(device, CL_DEVICE_LOCAL_MEM_SIZE, sizeof(local_mem), &local_mem, NULL);
+        const size_t halo = 2u * (size_t)steps;
+        const size_t need = (steps > 1 ? 2u : 1u) * (lx + halo) * (ly + halo);
+        if (need > (size_t)local_mem) {
+            snprintf(why, why_size, "steps-per-launch=%d with local size %ux%u needs %u bytes of local memory, device has %u",
+                     steps, (unsigned)lx, (unsigned)ly, (unsigned)need, (unsigned)local_mem);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+cl_int gol_set_step_args(cl_kernel kernel, cl_mem cur, cl_mem next, int rows, int cols, int wrap,
+                         int tiled, int multi_step, int launch_steps, size_t lx, size_t ly)
+{
+    cl_int err;
+    err  = clSetKernelArg(kernel, 0, sizeof(cl_mem), &cur);
+    err |= clSetKernelArg(kernel, 1, sizeof(cl_mem), &next);
+    err |= clSetKernelArg(kernel, 2, sizeof(int), &rows);
+    err |= clSetKernelArg(kernel, 3, sizeof(int), &cols);
+    err |= clSetKernelArg(kernel, 4, sizeof(int), &wrap);
+
+    // Allocate local tile memory for the tiled kernel version.
+    if (multi_step) {
+        size_t tile_bytes = 2 * (lx + 2 * (size_t)launch_steps) * (ly + 2 * (size_t)launch_steps) * sizeof(unsigned char);
+        err |= clSetKernelArg(kernel, 5, tile_bytes, NULL);
+        err |= clSetKernelArg(kernel, 6, sizeof(int), &launch_steps);
+    } else if (tiled) {
+        size_t tile_bytes = (lx + 2) * (ly + 2) * sizeof(unsigned char);
+        err |= clSetKernelArg(kernel, 5, tile_bytes, NULL);
+    }
+    return err;
+}
+
+// Build for one device; print the compiler log on failure.
+static cl_int build_program(cl_program program, cl_device_id device, const char* options) {
+    cl_int err = clBuildProgram(program, 1, &device, options, NULL, NULL);
+    if (err != CL_SUCCESS) {
+        size_t log_size = 0;
+        clGetProgramBuildInfo(program, device, CL_PROGRAM_BUILD_LOG, 0, NULL, &log_size);
+
+        char* log = (char*)malloc(log_size + 1);
+        if (log) {
+            clGetProgramBuildInfo(program, device, CL_PROGRAM_BUILD_LOG, log_size, log, NULL);
+            log[log_size] = 0;
+            fprintf(stderr, "Build failed:\n%s\n", log);
+            free(log);
+        }
+    }
+    return err;
+}
+
+cl_program gol_build_program(cl_context context, cl_device_id device, const char* source, const char* options,
+                             const char* cache_dir, GolBuildStats* stats, cl_int* err)
+{
+    const double t0 = gol_now_ms();
+    const uint64_t key = cache_dir ? gol_program_cache_key(device, source, options) : 0;
+    cl_program program = cache_dir ? gol_program_cache_load(cache_dir, key, context, device, options) : NULL;
+    *err = CL_SUCCESS;
+    if (program) {
+        ++stats->hits;
+    } else {
+        program = clCreateProgramWithSource(context, 1, &source, NULL, err);
+        if (!program || *err != CL_SUCCESS) return NULL;
+        *err = build_program(program, device, options);
+        if (*err != CL_SUCCESS) {
+            clReleaseProgram(program);
+            return NULL;
+        }
+        if (cache_dir) {
+            ++stats->misses;
+            if (gol_program_cache_store(cache_dir, key, program) != 0) {
+                fprintf(stderr, "Could not store the program binary in %s\n", cache_dir);
+            }
+        }
+    }
+    stats->build_ms += gol_now_ms() - t0;
+    return program;
+}
+
+const char* gol_build_label(const GolBuildStats* stats) {
+    if (stats->reused) return "reused";
+    if (stats->hits && stats->misses) return "mixed";
+    if (stats->hits) return "hit";
+    if (stats->misses) return "miss";
+    return "off";
+}
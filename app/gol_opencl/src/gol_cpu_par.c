@@ -0,0 +1,356 @@
+#include "../include/gol_cpu_par.h"
+#include "../include/gol_rule.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Computes columns [1, cols - 1) of one output row from the rows above, at and below it.
+typedef void (*InteriorRowFn)(const unsigned char* restrict up,
+                              const unsigned char* restrict mid,
+                              const unsigned char* restrict down,
+                              unsigned char* restrict out,
+                              int cols,
+                              uint32_t rule);
+
+struct GolCpuPool {
+    pthread_t* threads;
+    int n_threads;
+    pthread_barrier_t start;
+    pthread_barrier_t step;
+    pthread_barrier_t done;
+    pthread_mutex_t ready_lock;
+    pthread_cond_t ready_cond;
+    int ready;
+    int quit;
+
+    // Description of the job currently being executed.
+    unsigned char* grid_a;
+    unsigned char* grid_b;
+    const unsigned char* zero_row;
+    int rows;
+    int cols;
+    int iters;
+    int wrap;
+    uint32_t rule;
+    InteriorRowFn interior_row;
+};
+
+typedef struct WorkerArg {
+    GolCpuPool* pool;
+    int index;
+} WorkerArg;
+
+// Ask the operating system how many logical processors are online.
+int gol_cpu_count(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (int)info.dwNumberOfProcessors : 1;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+#endif
+}
+
+// Apply the rule to one cell whose west/east neighbor columns are given explicitly.
+// A negative column index stands for a dead cell outside the board.
+static unsigned char edge_cell(const unsigned char* up,
+                               const unsigned char* mid,
+                               const unsigned char* down,
+                               int y, int yl, int yr, uint32_t rule)
+{
+    int sum = up[y] + down[y];
+    if (yl >= 0) sum += up[yl] + mid[yl] + down[yl];
+    if (yr >= 0) sum += up[yr] + mid[yr] + down[yr];
+    return gol_rule_next(rule, mid[y], sum);
+}
+
+#if defined(_MSC_VER)
+#define GOL_FORCE_INLINE static __forceinline
+#else
+#define GOL_FORCE_INLINE static inline __attribute__((always_inline))
+#endif
+
+// Compute columns [1, cols - 1) of one row with no branches in the inner loop.
+// Always inlined into the per-rule instances below, where rule is a constant.
+GOL_FORCE_INLINE void interior_row_rule(const unsigned char* restrict up,
+                                        const unsigned char* restrict mid,
+                                        const unsigned char* restrict down,
+                                        unsigned char* restrict out,
+                                        int cols,
+                                        const uint32_t rule)
+{
+    int y = 1;
+
+#if defined(__SSE2__)
+    // Sixteen cells per iteration: add the eight neighbor vectors, form the table index
+    // (count, plus 9 for live cells) and compare it against every set bit of the rule.
+    const __m128i one = _mm_set1_epi8(1);
+    const __m128i nine = _mm_set1_epi8(9);
+    for (; y + 16 <= cols - 1; y += 16) {
+        __m128i sum = _mm_loadu_si128((const __m128i*)(up + y - 1));
+        sum = _mm_add_epi8(sum, _mm_loadu_si128((const __m128i*)(up + y)));
+        sum = _mm_add_epi8(sum, _mm_loadu_si128((const __m128i*)(up + y + 1)));
+        sum = _mm_add_epi8(sum, _mm_loadu_si128((const __m128i*)(mid + y - 1)));
+        sum = _mm_add_epi8(sum, _mm_loadu_si128((const __m128i*)(mid + y + 1)));
+        sum = _mm_add_epi8(sum, _mm_loadu_si128((const __m128i*)(down + y - 1)));
+        sum = _mm_add_epi8(sum, _mm_loadu_si128((const __m128i*)(down + y)));
+        sum = _mm_add_epi8(sum, _mm_loadu_si128((const __m128i*)(down + y + 1)));
+
+        const __m128i alive = _mm_loadu_si128((const __m128i*)(mid + y));
+        const __m128i index = _mm_add_epi8(sum, _mm_and_si128(_mm_cmpeq_epi8(alive, one), nine));
+        __m128i hit = _mm_setzero_si128();
+#define GOL_RULE_TERM(k) \
+        if ((rule >> (k)) & 1u) hit = _mm_or_si128(hit, _mm_cmpeq_epi8(index, _mm_set1_epi8((char)(k))));
+        GOL_RULE_TERM(0)  GOL_RULE_TERM(1)  GOL_RULE_TERM(2)  GOL_RULE_TERM(3)  GOL_RULE_TERM(4)
+        GOL_RULE_TERM(5)  GOL_RULE_TERM(6)  GOL_RULE_TERM(7)  GOL_RULE_TERM(8)  GOL_RULE_TERM(9)
+        GOL_RULE_TERM(10) GOL_RULE_TERM(11) GOL_RULE_TERM(12) GOL_RULE_TERM(13) GOL_RULE_TERM(14)
+        GOL_RULE_TERM(15) GOL_RULE_TERM(16) GOL_RULE_TERM(17)
+#undef GOL_RULE_TERM
+        _mm_storeu_si128((__m128i*)(out + y), _mm_and_si128(hit, one));
+    }
+#endif
+
+    // Scalar tail (or the whole row without SSE2), written so compilers can vectorize it.
+    for (; y < cols - 1; ++y) {
+        const int sum = up[y - 1] + up[y] + up[y + 1]
+                      + mid[y - 1] + mid[y + 1]
+                      + down[y - 1] + down[y] + down[y + 1];
+        out[y] = gol_rule_next(rule, mid[y], sum);
+    }
+}
+
+// Rules that get their own instance of the interior loop, with the table folded in at compile time.
+#define GOL_CPU_RULE_INSTANCES(X) \
+    X(b3_s23, 0x01808u)           \
+    X(b36_s23, 0x01848u)          \
+    X(b3678_s34678, 0x3b1c8u)     \
+    X(b2_s, 0x00004u)
+
+#define GOL_DEFINE_INTERIOR_ROW(name, table)                                        \
+    static void interior_row_##name(const unsigned char* restrict up,             \
+                                    const unsigned char* restrict mid,            \
+                                    const unsigned char* restrict down,           \
+                                    unsigned char* restrict out,                  \
+                                    int cols, uint32_t rule)                      \
+    {                                                                             \
+        (void)rule;                                                               \
+        interior_row_rule(up, mid, down, out, cols, (table));                     \
+    }
+GOL_CPU_RULE_INSTANCES(GOL_DEFINE_INTERIOR_ROW)
+#undef GOL_DEFINE_INTERIOR_ROW
+
+// Any other rule reads the table at run time.
+static void interior_row_generic(const unsigned char* restrict up,
+                                 const unsigned char* restrict mid,
+                                 const unsigned char* restrict down,
+                                 unsigned char* restrict out,
+                                 int cols, uint32_t rule)
+{
+    interior_row_rule(up, mid, down, out, cols, rule);
+}
+
+// Pick the specialized interior loop for a rule, falling back to the generic one.
+static InteriorRowFn pick_interior_row(uint32_t rule) {
+#define GOL_PICK_INTERIOR_ROW(name, table) if (rule == (table)) return interior_row_##name;
+    GOL_CPU_RULE_INSTANCES(GOL_PICK_INTERIOR_ROW)
+#undef GOL_PICK_INTERIOR_ROW
+    return interior_row_generic;
+}
+
+// Compute rows [r0, r1) of one generation.
+static void band_step(const unsigned char* in,
+                      unsigned char* out,
+                      const unsigned char* zero_row,
+                      int rows, int cols, int wrap,
+                      uint32_t rule, InteriorRowFn interior_row,
+                      int r0, int r1)
+{
+    const size_t pitch = (size_t)cols;
+
+    for (int x = r0; x < r1; ++x) {
+        // Resolve the neighbor rows once per row instead of once per cell.
+        const unsigned char* up;
+        const unsigned char* down;
+        if (wrap) {
+            up = in + (size_t)(x == 0 ? rows - 1 : x - 1) * pitch;
+            down = in + (size_t)(x == rows - 1 ? 0 : x + 1) * pitch;
+        } else {
+            up = (x == 0) ? zero_row : in + (size_t)(x - 1) * pitch;
+            down = (x == rows - 1) ? zero_row : in + (size_t)(x + 1) * pitch;
+        }
+        const unsigned char* mid = in + (size_t)x * pitch;
+        unsigned char* dst = out + (size_t)x * pitch;
+
+        interior_row(up, mid, down, dst, cols, rule);
+
+        // The first and last columns take their outer neighbors from the opposite edge or from outside.
+        const int last = cols - 1;
+        dst[0] = edge_cell(up, mid, down, 0,
+                           wrap ? last : -1,
+                           cols > 1 ? 1 : (wrap ? 0 : -1), rule);
+        if (last > 0) {
+            dst[last] = edge_cell(up, mid, down, last,
+                                  last - 1,
+                                  wrap ? 0 : -1, rule);
+        }
+    }
+}
+
+// Split rows into nearly equal bands and return the band of one thread.
+static void band_range(int rows, int n_threads, int index, int* r0, int* r1) {
+    const int base = rows / n_threads;
+    const int extra = rows % n_threads;
+    *r0 = index * base + (index < extra ? index : extra);
+    *r1 = *r0 + base + (index < extra ? 1 : 0);
+}
+
+// Run every generation of the current job on one band, synchronizing after each step.
+static void run_band(GolCpuPool* pool, int index) {
+    int r0 = 0, r1 = 0;
+    band_range(pool->rows, pool->n_threads, index, &r0, &r1);
+
+    unsigned char* in = pool->grid_a;
+    unsigned char* out = pool->grid_b;
+    for (int t = 0; t < pool->iters; ++t) {
+        band_step(in, out, pool->zero_row, pool->rows, pool->cols, pool->wrap,
+                  pool->rule, pool->interior_row, r0, r1);
+
+        // Every band must finish before any thread reads the new generation.
+        pthread_barrier_wait(&pool->step);
+        unsigned char* tmp = in;
+        in = out;
+        out = tmp;
+    }
+}
+
+// Worker loop: wait for a job, run its band, report completion.
+static void* worker_main(void* arg) {
+    WorkerArg* wa = (WorkerArg*)arg;
+    GolCpuPool* pool = wa->pool;
+    const int index = wa->index;
+    free(wa);
+
+    // Wait until the creator has sized the barriers for the threads that actually started.
+    pthread_mutex_lock(&pool->ready_lock);
+    while (!pool->ready) pthread_cond_wait(&pool->ready_cond, &pool->ready_lock);
+    pthread_mutex_unlock(&pool->ready_lock);
+
+    for (;;) {
+        pthread_barrier_wait(&pool->start);
+        if (pool->quit) break;
+        run_band(pool, index);
+        pthread_barrier_wait(&pool->done);
+    }
+    return NULL;
+}
+
+// Create the barriers and the helper threads; thread 0 is always the caller.
+GolCpuPool* gol_cpu_pool_create(int threads) {
+    if (threads <= 0) threads = 1;
+
+    GolCpuPool* pool = (GolCpuPool*)calloc(1, sizeof(GolCpuPool));
+    if (!pool) return NULL;
+
+    pool->n_threads = threads;
+    pool->threads = (pthread_t*)calloc((size_t)threads, sizeof(pthread_t));
+    if (!pool->threads) {
+        free(pool);
+        return NULL;
+    }
+
+    pthread_mutex_init(&pool->ready_lock, NULL);
+    pthread_cond_init(&pool->ready_cond, NULL);
+
+    // Start the helpers; if the system refuses more threads, continue with the ones that started.
+    int started = 1;
+    for (int i = 1; i < threads; ++i) {
+        WorkerArg* wa = (WorkerArg*)malloc(sizeof(WorkerArg));
+        if (!wa) break;
+        wa->pool = pool;
+        wa->index = i;
+        if (pthread_create(&pool->threads[i], NULL, worker_main, wa) != 0) {
+            free(wa);
+            break;
+        }
+        ++started;
+    }
+    pool->n_threads = started;
+
+    pthread_barrier_init(&pool->start, NULL, (unsigned)started);
+    pthread_barrier_init(&pool->step, NULL, (unsigned)started);
+    pthread_barrier_init(&pool->done, NULL, (unsigned)started);
+
+    // Release the helpers into their job loop.
+    pthread_mutex_lock(&pool->ready_lock);
+    pool->ready = 1;
+    pthread_cond_broadcast(&pool->ready_cond);
+    pthread_mutex_unlock(&pool->ready_lock);
+
+    return pool;
+}
+
+// Release the workers blocked on the start barrier and join them.
+void gol_cpu_pool_destroy(GolCpuPool* pool) {
+    if (!pool) return;
+
+    if (pool->n_threads > 1) {
+        pool->quit = 1;
+        pthread_barrier_wait(&pool->start);
+        for (int i = 1; i < pool->n_threads; ++i) pthread_join(pool->threads[i], NULL);
+    }
+
+    pthread_barrier_destroy(&pool->start);
+    pthread_barrier_destroy(&pool->step);
+    pthread_barrier_destroy(&pool->done);
+    pthread_cond_destroy(&pool->ready_cond);
+    pthread_mutex_destroy(&pool->ready_lock);
+    free(pool->threads);
+    free(pool);
+}
+
+// Report how many threads share each generation.
+int gol_cpu_pool_threads(const GolCpuPool* pool) {
+    return pool ? pool->n_threads : 0;
+}
+
+// Publish the job, work on band 0 from the calling thread, then wait for the rest.
+unsigned char* gol_cpu_par_run(GolCpuPool* pool,
+                               unsigned char* grid_a,
+                               unsigned char* grid_b,
+                               int rows,
+                               int cols,
+                               int iters,
+                               int wrap,
+                               uint32_t rule)
+{
+    unsigned char* zero_row = (unsigned char*)calloc((size_t)cols, 1);
+    if (!zero_row) return NULL;
+
+    pool->grid_a = grid_a;
+    pool->grid_b = grid_b;
+    pool->zero_row = zero_row;
+    pool->rows = rows;
+    pool->cols = cols;
+    pool->iters = iters;
+    pool->wrap = wrap;
+    pool->rule = rule;
+    pool->interior_row = pick_interior_row(rule);
+
+    if (pool->n_threads > 1) pthread_barrier_wait(&pool->start);
+    run_band(pool, 0);
+    if (pool->n_threads > 1) pthread_barrier_wait(&pool->done);
+
+    free(zero_row);
+    return (iters % 2 == 0) ? grid_a : grid_b;
+}
@@ -0,0 +1,54 @@
+#include "../include/gol_cpu_seq.h"
+#include "../include/gol_rule.h"
+
+#include <stddef.h>
+
+// Wrap a coordinate into the valid grid range.
+static int wrap_coord_cpu(int v, int maxv) {
+    int r = v % maxv;
+    return (r < 0) ? (r + maxv) : r;
+}
+
+// Read one cell from the CPU grid with optional wrap-around.
+static unsigned char read_cell_cpu(const unsigned char* grid,
+                                   int x,
+                                   int y,
+                                   int rows,
+                                   int cols,
+                                   int wrap)
+{
+    if (wrap) {
+        x = wrap_coord_cpu(x, rows);
+        y = wrap_coord_cpu(y, cols);
+        return grid[(size_t)x * (size_t)cols + (size_t)y];
+    }
+    if (x < 0 || x >= rows || y < 0 || y >= cols) return 0;
+    return grid[(size_t)x * (size_t)cols + (size_t)y];
+}
+
+// Compute one CPU reference step of the Game of Life (or of a Generations rule when states > 2).
+void gol_cpu_step(const unsigned char* in,
+                  unsigned char* out,
+                  int rows,
+                  int cols,
+                  int wrap,
+                  uint32_t rule,
+                  int states)
+{
+    for (int x = 0; x < rows; ++x) {
+        for (int y = 0; y < cols; ++y) {
+            int sum = 0;
+            // Count the live (state 1) cells among the eight neighbors.
+            for (int dx = -1; dx <= 1; ++dx) {
+                for (int dy = -1; dy <= 1; ++dy) {
+                    if (dx == 0 && dy == 0) continue;
+                    sum += read_cell_cpu(in, x + dx, y + dy, rows, cols, wrap) == 1;
+                }
+            }
+
+            const size_t idx = (size_t)x * (size_t)cols + (size_t)y;
+            // Look up the birth or survival bit of the rule table; dying states just age.
+            out[idx] = gol_rule_next_state(rule, states, in[idx], sum);
+        }
+    }
+}
@@ -0,0 +1,34 @@
+#include "../include/gol_device.h"
+
+#include <stdlib.h>
+
+// First device of the given type on any of the platforms.
+static cl_device_id first_device(const cl_platform_id* plats, cl_uint n_platforms, cl_device_type type,
+                                 cl_platform_id* out_platform) {
+    for (cl_uint p = 0; p < n_platforms; ++p) {
+        cl_uint n_dev = 0;
+        cl_device_id device = NULL;
+        if (clGetDeviceIDs(plats[p], type, 0, NULL, &n_dev) == CL_SUCCESS && n_dev > 0
+            && clGetDeviceIDs(plats[p], type, 1, &device, NULL) == CL_SUCCESS) {
+            *out_platform = plats[p];
+            return device;
+        }
+    }
+    return NULL;
+}
+
+cl_device_id gol_pick_device(cl_platform_id* out_platform) {
+    cl_uint n_platforms = 0;
+    if (clGetPlatformIDs(0, NULL, &n_platforms) != CL_SUCCESS || n_platforms == 0) return NULL;
+
+    cl_platform_id* plats = (cl_platform_id*)calloc(n_platforms, sizeof(cl_platform_id));
+    if (!plats) return NULL;
+    cl_device_id chosen = NULL;
+    if (clGetPlatformIDs(n_platforms, plats, NULL) == CL_SUCCESS) {
+        // Try to find a GPU device first, then fall back to a CPU device.
+        chosen = first_device(plats, n_platforms, CL_DEVICE_TYPE_GPU, out_platform);
+        if (!chosen) chosen = first_device(plats, n_platforms, CL_DEVICE_TYPE_CPU, out_platform);
+    }
+    free(plats);
+    return chosen;
+}
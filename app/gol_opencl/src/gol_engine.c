@@ -0,0 +1,843 @@
+#include "../include/gol_engine.h"
+#include "../include/gol_bitpack.h"
+#include "../include/gol_device.h"
+#include "../include/gol_generations.h"
+#include "../include/gol_rule.h"
+#include "../include/gol_stats.h"
+#include "../include/kernel_loader.h"
+
+#include <limits.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+// Alignment of host memory handed to CL_MEM_USE_HOST_PTR buffers; CPU runtimes use
+// page-aligned memory in place instead of shadowing it with a copy.
+#define HOST_PAGE_BYTES 4096
+
+// Built step program of one rule and kernel source, with the kernel objects of the last variant that used it.
+typedef struct GolEngineProgram {
+    const char* file;         // source file and options identify the program
+    char options[128];        // rule table, states and the statistics switch
+    const char* kernel_name;  // step kernel the objects below were created for
+    cl_program program;
+    cl_kernel kernel;
+    cl_kernel odd_kernel;     // batched launches: a second kernel object, bound to the other buffer parity
+    cl_kernel list_kernel;    // gol_sparse_build_list of sparse programs
+} GolEngineProgram;
+
+struct GolEngine {
+    cl_device_id device;
+    cl_context context;
+    cl_command_queue queue;
+    char device_name[256];
+    char* kernel_dir;
+    char* cache_dir;
+    int profile;
+    GolEngineConfig config;   // launch settings; kernel_dir and cache_dir live above
+    GolBuildStats build;
+    char message[256];
+
+    // Most recently used last; the oldest is released when a new variant or rule needs a slot.
+    GolEngineProgram programs[GOL_ENGINE_PROGRAMS];
+    int n_programs;
+
+    cl_mem buf[2];
+    void* pages[2];           // zero-copy host memory behind buf
+    size_t capacity;          // bytes of each board buffer
+    int zero_copy_buffers;    // buf wraps pages
+    void* host;               // packed words of a load or read
+    size_t host_capacity;
+    cl_mem stats;
+    size_t stats_capacity;
+    cl_mem flags[2];          // sparse: changed flag per tile, ping-pong by generation
+    size_t flags_capacity;    // bytes of each flag buffer, one per tile
+    cl_mem tile_list;
+    size_t tile_capacity;
+    cl_mem counts;            // sparse: active tiles per generation of one gol_step_n
+    size_t counts_capacity;
+
+    // Profile of the last calls.
+    uint64_t load_ns;
+    uint64_t step_ns;
+    uint64_t read_ns;
+    uint64_t* launch_ns;
+    cl_event* events;
+    int launch_capacity;
+    int launches;
+    uint64_t active_tiles;
+
+    // Prepared size and kernel, and the loaded simulation.
+    int prepared;
+    int loaded;
+    int rows;
+    int cols;
+    int wrap;
+    size_t bytes;             // device size of the board in the configured layout
+    cl_kernel kernel;         // step kernel of the prepared rule
+    cl_kernel parity_kernels[2]; // batched launches: kernel reading buf[0] and kernel reading buf[1]
+    cl_kernel list_kernel;
+    const char* kernel_name;
+    size_t global[2];
+    size_t local[2];
+    int tiles_x;
+    int tiles_y;
+    size_t sparse_global[2];
+    size_t list_global;
+    int cur;                  // buffer holding the current generation
+    uint64_t generation;
+};
+
+// Record the detail of a failure for gol_engine_message and return its code.
+static int fail(GolEngine* e, int code, const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(e->message, sizeof(e->message), fmt, args);
+    va_end(args);
+    return code;
+}
+
+static void release_program(GolEngineProgram* p) {
+    if (p->list_kernel) clReleaseKernel(p->list_kernel);
+    if (p->odd_kernel) clReleaseKernel(p->odd_kernel);
+    if (p->kernel) clReleaseKernel(p->kernel);
+    if (p->program) clReleaseProgram(p->program);
+}
+
+static char* copy_string(const char* s) {
+    char* copy = (char*)malloc(strlen(s) + 1);
+    if (copy) strcpy(copy, s);
+    return copy;
+}
+
+// Allocate page-aligned host memory, rounded up to whole pages.
+static void* alloc_pages(size_t bytes) {
+    bytes = gol_round_up(bytes, HOST_PAGE_BYTES);
+#ifdef _WIN32
+    return _aligned_malloc(bytes, HOST_PAGE_BYTES);
+#else
+    void* p = NULL;
+    return posix_memalign(&p, HOST_PAGE_BYTES, bytes) == 0 ? p : NULL;
+#endif
+}
+
+// Free memory from alloc_pages.
+static void free_pages(void* p) {
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
+
+static void release_mem(cl_mem* m) {
+    if (*m) clReleaseMemObject(*m);
+    *m = NULL;
+}
+
+GolEngine* gol_engine_create(const GolEngineConfig* config, int* error) {
+    const GolEngineConfig defaults = { 0 };
+    if (!config) config = &defaults;
+    int rc = GOL_ENGINE_OK;
+    GolEngine* e = (GolEngine*)calloc(1, sizeof(GolEngine));
+    if (!e) {
+        if (error) *error = GOL_ENGINE_ENOMEM;
+        return NULL;
+    }
+    e->profile = config->profile != 0;
+
+    cl_platform_id platform;
+    cl_int err = CL_SUCCESS;
+    e->device = gol_pick_device(&platform);
+    if (!e->device) rc = GOL_ENGINE_ENODEV;
+    if (rc == GOL_ENGINE_OK) {
+        clGetDeviceInfo(e->device, CL_DEVICE_NAME, sizeof(e->device_name) - 1, e->device_name, NULL);
+        e->context = clCreateContext(NULL, 1, &e->device, NULL, NULL, &err);
+        const cl_queue_properties props[] = { CL_QUEUE_PROPERTIES, (cl_queue_properties)CL_QUEUE_PROFILING_ENABLE, 0 };
+        if (e->context && err == CL_SUCCESS) {
+            e->queue = clCreateCommandQueueWithProperties(e->context, e->device, e->profile ? props : NULL, &err);
+        }
+        if (!e->context || !e->queue || err != CL_SUCCESS) rc = GOL_ENGINE_ECL;
+    }
+    if (rc == GOL_ENGINE_OK && config->kernel_dir) {
+        e->kernel_dir = copy_string(config->kernel_dir);
+        if (!e->kernel_dir) rc = GOL_ENGINE_ENOMEM;
+    }
+    if (rc == GOL_ENGINE_OK && config->cache_dir) {
+        e->cache_dir = copy_string(config->cache_dir);
+        if (!e->cache_dir) rc = GOL_ENGINE_ENOMEM;
+    }
+    if (rc == GOL_ENGINE_OK) rc = gol_engine_configure(e, config);
+
+    if (rc != GOL_ENGINE_OK) {
+        gol_engine_destroy(e);
+        e = NULL;
+    }
+    if (error) *error = rc;
+    return e;
+}
+
+void gol_engine_destroy(GolEngine* e) {
+    if (!e) return;
+    for (int i = 0; i < e->n_programs; ++i) release_program(&e->programs[i]);
+    for (int b = 0; b < 2; ++b) {
+        release_mem(&e->buf[b]);
+        free_pages(e->pages[b]);
+        release_mem(&e->flags[b]);
+    }
+    release_mem(&e->stats);
+    release_mem(&e->tile_list);
+    release_mem(&e->counts);
+    if (e->queue) clReleaseCommandQueue(e->queue);
+    if (e->context) clReleaseContext(e->context);
+    free(e->host);
+    free(e->launch_ns);
+    free(e->events);
+    free(e->kernel_dir);
+    free(e->cache_dir);
+    free(e);
+}
+
+const char* gol_engine_device_name(const GolEngine* e) {
+    return e->device_name;
+}
+
+int gol_engine_configure(GolEngine* e, const GolEngineConfig* config) {
+    if (!e || !config) return GOL_ENGINE_EARG;
+    e->message[0] = 0;
+    e->prepared = 0;
+    e->loaded = 0;
+
+    GolEngineConfig c = *config;
+    c.kernel_dir = NULL;
+    c.cache_dir = NULL;
+    c.profile = e->profile;
+    if (c.lx <= 0) c.lx = 16;
+    if (c.ly <= 0) c.ly = 16;
+    if (c.steps_per_launch <= 0) c.steps_per_launch = 1;
+    if (c.states <= 0) c.states = 2;
+    c.tiled = c.tiled != 0;
+    c.packed = c.packed != 0;
+    c.sparse = c.sparse != 0;
+
+    // The packed layouts, the tile list and the statistics reduction each exist for some kernels only.
+    const int gens = c.states > 2;
+    if (c.packed && c.tiled) return fail(e, GOL_ENGINE_EARG, "the packed kernel is not tiled");
+    if (c.steps_per_launch > 1 && !c.tiled) return fail(e, GOL_ENGINE_EARG, "only the tiled kernel runs several steps per launch");
+    if (c.sparse && (c.tiled || c.packed)) return fail(e, GOL_ENGINE_EARG, "the sparse kernel uses the naive layout");
+    if (gens && (c.tiled || c.packed || c.sparse)) return fail(e, GOL_ENGINE_EARG, "Generations rules have their own kernel");
+    if (c.stats_slots > 0 && (c.packed || c.sparse || gens || c.steps_per_launch > 1)) {
+        return fail(e, GOL_ENGINE_EARG, "statistics need the single-step naive or tiled kernel");
+    }
+    if (c.stats_slots < 0) c.stats_slots = 0;
+    // Sparse generations never wait on the host, so their events are always collected at the end.
+    if (c.sparse) c.batch = 1;
+    e->config = c;
+    return GOL_ENGINE_OK;
+}
+
+// Source file and step kernel of the configured variant.
+static void variant_of(const GolEngineConfig* c, const char** file, const char** kernel) {
+    if (c->states > 2) {
+        *file = "gol_generations.cl";
+        *kernel = "gol_step_generations";
+    } else if (c->packed) {
+        *file = "gol_packed.cl";
+        *kernel = "gol_step_packed";
+    } else if (c->sparse) {
+        *file = "gol_sparse.cl";
+        *kernel = "gol_step_sparse";
+    } else if (c->tiled) {
+        *file = "gol_tiled.cl";
+        *kernel = c->steps_per_launch > 1 ? "gol_step_tiled_multi" : "gol_step_tiled";
+    } else {
+        *file = "gol_naive.cl";
+        *kernel = "gol_step";
+    }
+}
+
+// Load a kernel source; the statistics helpers are prepended when the variant reduces them.
+static char* load_source(GolEngine* e, const char* file, int* rc) {
+    int loader_err = 0;
+    char* src = load_kernel(file, e->kernel_dir, &loader_err);
+    if (loader_err != 0 || !src) {
+        *rc = fail(e, GOL_ENGINE_EBUILD, "kernel source %s could not be loaded (code %d)", file, loader_err);
+        return NULL;
+    }
+    if (e->config.stats_slots == 0) return src;
+
+    char* stats_src = load_kernel("gol_stats.cl", e->kernel_dir, &loader_err);
+    if (loader_err != 0 || !stats_src) {
+        free(src);
+        *rc = fail(e, GOL_ENGINE_EBUILD, "kernel source gol_stats.cl could not be loaded (code %d)", loader_err);
+        return NULL;
+    }
+    char* joined = (char*)malloc(strlen(stats_src) + strlen(src) + 2);
+    if (joined) sprintf(joined, "%s\n%s", stats_src, src);
+    else *rc = GOL_ENGINE_ENOMEM;
+    free(stats_src);
+    free(src);
+    return joined;
+}
+
+// Create the kernel objects a variant needs from its program. The tiled program serves both
+// the single- and the multi-step kernel, so switching between them only replaces the objects.
+// Batched launches also get a second step kernel, bound to the other buffer parity once per load.
+static int create_kernels(GolEngine* e, GolEngineProgram* p, const char* kernel_name) {
+    cl_int err = CL_SUCCESS;
+    if (p->kernel_name != kernel_name) {
+        if (p->kernel) clReleaseKernel(p->kernel);
+        if (p->odd_kernel) clReleaseKernel(p->odd_kernel);
+        p->odd_kernel = NULL;
+        p->kernel_name = kernel_name;
+        p->kernel = clCreateKernel(p->program, kernel_name, &err);
+        if (!p->kernel || err != CL_SUCCESS) p->kernel = NULL;
+    }
+    if (p->kernel && !p->list_kernel && e->config.sparse) {
+        p->list_kernel = clCreateKernel(p->program, "gol_sparse_build_list", &err);
+        if (!p->list_kernel || err != CL_SUCCESS) p->list_kernel = NULL;
+    }
+    if (p->kernel && !p->odd_kernel && e->config.batch && !e->config.sparse) {
+        p->odd_kernel = clCreateKernel(p->program, kernel_name, &err);
+        if (!p->odd_kernel || err != CL_SUCCESS) p->odd_kernel = NULL;
+    }
+    if (err != CL_SUCCESS || !p->kernel) {
+        return fail(e, GOL_ENGINE_EBUILD, "kernel %s could not be created (code %d)", kernel_name, err);
+    }
+    return GOL_ENGINE_OK;
+}
+
+// Step program of a rule for the configured variant: from the programs built earlier,
+// the binary cache, or a fresh build.
+static int use_program(GolEngine* e, uint32_t rule, GolEngineProgram** out) {
+    const char* file;
+    const char* kernel_name;
+    variant_of(&e->config, &file, &kernel_name);
+    char options[128];
+    gol_rule_build_options(rule, e->config.states, options, sizeof(options));
+    if (e->config.stats_slots > 0) strcat(options, " -DGOL_STATS");
+
+    for (int i = 0; i < e->n_programs; ++i) {
+        const GolEngineProgram* p = &e->programs[i];
+        if (p->file != file || strcmp(p->options, options) != 0) continue;
+        // Move it to the most recently used end.
+        const GolEngineProgram hit = *p;
+        memmove(&e->programs[i], &e->programs[i + 1], (size_t)(e->n_programs - i - 1) * sizeof(GolEngineProgram));
+        e->programs[e->n_programs - 1] = hit;
+        *out = &e->programs[e->n_programs - 1];
+        return create_kernels(e, *out, kernel_name);
+    }
+
+    int rc = GOL_ENGINE_OK;
+    char* src = load_source(e, file, &rc);
+    if (!src) return rc;
+    cl_int err = CL_SUCCESS;
+    const double start_ms = gol_now_ms();
+    GolEngineProgram p;
+    memset(&p, 0, sizeof(p));
+    p.file = file;
+    strcpy(p.options, options);
+    p.program = gol_build_program(e->context, e->device, src, options, e->cache_dir, &e->build, &err);
+    free(src);
+    if (!p.program) return fail(e, GOL_ENGINE_EBUILD, "%s could not be built (code %d)", file, err);
+    if (e->config.trace) gol_trace_host(e->config.trace, "build", start_ms, gol_now_ms());
+    rc = create_kernels(e, &p, kernel_name);
+    if (rc != GOL_ENGINE_OK) {
+        release_program(&p);
+        return rc;
+    }
+
+    if (e->n_programs == GOL_ENGINE_PROGRAMS) {
+        release_program(&e->programs[0]);
+        memmove(&e->programs[0], &e->programs[1], (size_t)(GOL_ENGINE_PROGRAMS - 1) * sizeof(GolEngineProgram));
+        --e->n_programs;
+    }
+    e->programs[e->n_programs] = p;
+    *out = &e->programs[e->n_programs];
+    ++e->n_programs;
+    return GOL_ENGINE_OK;
+}
+
+// Make the board buffers hold bytes; they only grow, so a smaller board reuses them as they are.
+static int reserve_boards(GolEngine* e, size_t bytes) {
+    const int zero_copy = e->config.zero_copy != 0;
+    if (bytes <= e->capacity && zero_copy == e->zero_copy_buffers) return GOL_ENGINE_OK;
+    for (int b = 0; b < 2; ++b) {
+        release_mem(&e->buf[b]);
+        free_pages(e->pages[b]);
+        e->pages[b] = NULL;
+    }
+    e->capacity = 0;
+
+    // Zero-copy buffers wrap page-aligned host memory, which devices sharing the host's DRAM
+    // compute on in place: transfers become map/unmap calls.
+    cl_int err = CL_SUCCESS;
+    for (int b = 0; b < 2; ++b) {
+        if (zero_copy) {
+            e->pages[b] = alloc_pages(bytes);
+            if (!e->pages[b]) return fail(e, GOL_ENGINE_ENOMEM, "zero-copy board of %zu bytes", bytes);
+        }
+        const cl_mem_flags flags = zero_copy ? CL_MEM_READ_WRITE | CL_MEM_USE_HOST_PTR : CL_MEM_READ_WRITE;
+        e->buf[b] = clCreateBuffer(e->context, flags, bytes, e->pages[b], &err);
+        if (!e->buf[b] || err != CL_SUCCESS) return fail(e, GOL_ENGINE_ECL, "board buffer of %zu bytes (code %d)", bytes, err);
+    }
+    e->capacity = bytes;
+    e->zero_copy_buffers = zero_copy;
+    return GOL_ENGINE_OK;
+}
+
+// Grow a device buffer to at least bytes.
+static int reserve_mem(GolEngine* e, cl_mem* m, size_t* capacity, size_t bytes) {
+    if (*m && bytes <= *capacity) return GOL_ENGINE_OK;
+    release_mem(m);
+    *capacity = 0;
+    cl_int err = CL_SUCCESS;
+    *m = clCreateBuffer(e->context, CL_MEM_READ_WRITE, bytes, NULL, &err);
+    if (!*m || err != CL_SUCCESS) return fail(e, GOL_ENGINE_ECL, "buffer of %zu bytes (code %d)", bytes, err);
+    *capacity = bytes;
+    return GOL_ENGINE_OK;
+}
+
+// Room for the launch timings and events of one gol_step_n.
+static int reserve_launches(GolEngine* e, int n) {
+    if (n <= e->launch_capacity) return GOL_ENGINE_OK;
+    uint64_t* ns = (uint64_t*)realloc(e->launch_ns, (size_t)n * sizeof(uint64_t));
+    if (ns) e->launch_ns = ns;
+    cl_event* events = (cl_event*)realloc(e->events, 2 * (size_t)n * sizeof(cl_event));
+    if (events) e->events = events;
+    if (!ns || !events) return fail(e, GOL_ENGINE_ENOMEM, "launch records");
+    e->launch_capacity = n;
+    return GOL_ENGINE_OK;
+}
+
+int gol_engine_prepare(GolEngine* e, int rows, int cols, uint32_t rule) {
+    if (!e) return GOL_ENGINE_EARG;
+    e->message[0] = 0;
+    e->prepared = 0;
+    e->loaded = 0;
+    if (rows <= 0 || cols <= 0) return fail(e, GOL_ENGINE_EARG, "invalid board size %dx%d", rows, cols);
+    // The step kernels index cells with int.
+    if ((uint64_t)rows * (uint64_t)cols > (uint64_t)INT_MAX) {
+        return fail(e, GOL_ENGINE_EARG, "board of %dx%d cells exceeds the kernels' %d-cell index range", rows, cols, INT_MAX);
+    }
+    const GolEngineConfig* c = &e->config;
+    GolEngineProgram* p = NULL;
+    int rc = use_program(e, rule, &p);
+    if (rc != GOL_ENGINE_OK) return rc;
+
+    const size_t lx = (size_t)c->lx;
+    const size_t ly = (size_t)c->ly;
+    char why[160];
+    if (!gol_local_size_fits(e->device, p->kernel, lx, ly, c->tiled, c->steps_per_launch, why, sizeof(why))) {
+        return fail(e, GOL_ENGINE_EARG, "%s", why);
+    }
+
+    // The packed kernels map one work-item to one word: 64 cells, or 32 / bits cells of a Generations rule.
+    const int gens = c->states > 2;
+    const int bits = gens ? gol_gens_bits_per_cell(c->states) : 0;
+    const size_t words_per_row = gens ? gol_gens_words_per_row(cols, bits) : gol_packed_words_per_row(cols);
+    const size_t bytes = c->packed ? (size_t)rows * words_per_row * sizeof(uint64_t)
+                       : gens ? (size_t)rows * words_per_row * sizeof(uint32_t) : (size_t)rows * (size_t)cols;
+    rc = reserve_boards(e, bytes);
+    if (rc != GOL_ENGINE_OK) return rc;
+    if ((c->packed || gens) && bytes > e->host_capacity) {
+        free(e->host);
+        e->host_capacity = 0;
+        e->host = malloc(bytes);
+        if (!e->host) return fail(e, GOL_ENGINE_ENOMEM, "packed board of %zu bytes", bytes);
+        e->host_capacity = bytes;
+    }
+    if (c->stats_slots > 0) {
+        rc = reserve_mem(e, &e->stats, &e->stats_capacity, (size_t)c->stats_slots * GOL_STATS_WORDS * sizeof(cl_uint));
+        if (rc != GOL_ENGINE_OK) return rc;
+    }
+
+    e->global[0] = gol_round_up((size_t)rows, lx);
+    e->global[1] = gol_round_up((c->packed || gens) ? words_per_row : (size_t)cols, ly);
+    e->local[0] = lx;
+    e->local[1] = ly;
+
+    // Sparse mode keeps one changed flag per tile (ping-pong) and the compacted tile list.
+    if (c->sparse) {
+        e->tiles_x = (int)(e->global[0] / lx);
+        e->tiles_y = (int)(e->global[1] / ly);
+        const size_t tiles = (size_t)e->tiles_x * (size_t)e->tiles_y;
+        // Both flag buffers grow together, so each reserve starts from the shared capacity.
+        size_t flag_capacity = e->flags_capacity;
+        rc = reserve_mem(e, &e->flags[0], &flag_capacity, tiles);
+        if (rc == GOL_ENGINE_OK) {
+            flag_capacity = e->flags_capacity;
+            rc = reserve_mem(e, &e->flags[1], &flag_capacity, tiles);
+        }
+        if (rc == GOL_ENGINE_OK) e->flags_capacity = flag_capacity;
+        if (rc == GOL_ENGINE_OK) rc = reserve_mem(e, &e->tile_list, &e->tile_capacity, tiles * sizeof(cl_int));
+        if (rc != GOL_ENGINE_OK) return rc;
+
+        // A few persistent work-groups per compute unit stride over however many tiles are active.
+        cl_uint cu = 0;
+        clGetDeviceInfo(e->device, CL_DEVICE_MAX_COMPUTE_UNITS, sizeof(cu), &cu, NULL);
+        size_t groups = (size_t)(cu > 0 ? cu : 1) * 8u;
+        if (groups > tiles) groups = tiles;
+        e->sparse_global[0] = groups * lx;
+        e->sparse_global[1] = ly;
+        e->list_global = gol_round_up(tiles, 64);
+    }
+
+    e->rows = rows;
+    e->cols = cols;
+    e->bytes = bytes;
+    e->kernel = p->kernel;
+    e->parity_kernels[0] = p->kernel;
+    e->parity_kernels[1] = p->odd_kernel;
+    e->list_kernel = p->list_kernel;
+    e->kernel_name = p->kernel_name;
+    e->prepared = 1;
+    return GOL_ENGINE_OK;
+}
+
+// Profiled time of a finished command; 0 without profiling.
+static uint64_t command_ns(GolEngine* e, cl_event ev, const char* name, const char* category) {
+    if (!e->profile) return 0;
+    if (e->config.trace) gol_trace_command(e->config.trace, name, category, ev);
+    return (uint64_t)gol_event_ns(ev);
+}
+
+// Even launches read buf[0] and write buf[1], odd launches the opposite.
+static cl_int bind_parity_kernels(GolEngine* e, int launch_steps) {
+    const GolEngineConfig* c = &e->config;
+    const int multi_step = c->tiled && c->steps_per_launch > 1;
+    cl_int err;
+    err  = gol_set_step_args(e->parity_kernels[0], e->buf[0], e->buf[1], e->rows, e->cols, e->wrap,
+                             c->tiled, multi_step, launch_steps, e->local[0], e->local[1]);
+    err |= gol_set_step_args(e->parity_kernels[1], e->buf[1], e->buf[0], e->rows, e->cols, e->wrap,
+                             c->tiled, multi_step, launch_steps, e->local[0], e->local[1]);
+    return err;
+}
+
+// Make the board in buf[0] generation 0; ev is its finished upload or copy.
+static int start_simulation(GolEngine* e, cl_event ev, const char* name, int wrap) {
+    e->load_ns += command_ns(e, ev, name, "transfer");
+    clReleaseEvent(ev);
+
+    cl_int err = CL_SUCCESS;
+    // Sparse mode starts with identical buffers and every tile marked changed.
+    if (e->config.sparse) {
+        const cl_uchar all_changed = 1;
+        cl_event ev_copy;
+        err = clEnqueueCopyBuffer(e->queue, e->buf[0], e->buf[1], 0, 0, e->bytes, 0, NULL, &ev_copy);
+        if (err == CL_SUCCESS) {
+            err = clWaitForEvents(1, &ev_copy);
+            e->load_ns += command_ns(e, ev_copy, "copy", "transfer");
+            clReleaseEvent(ev_copy);
+        }
+        if (err == CL_SUCCESS) {
+            const size_t tiles = (size_t)e->tiles_x * (size_t)e->tiles_y;
+            err = clEnqueueFillBuffer(e->queue, e->flags[0], &all_changed, sizeof(all_changed), 0, tiles, 0, NULL, NULL);
+        }
+    }
+    // Every load accumulates into zeroed statistics slots.
+    if (err == CL_SUCCESS && e->config.stats_slots > 0) {
+        const cl_uint zero = 0;
+        err = clEnqueueFillBuffer(e->queue, e->stats, &zero, sizeof(zero), 0,
+                                  (size_t)e->config.stats_slots * GOL_STATS_WORDS * sizeof(cl_uint), 0, NULL, NULL);
+    }
+    e->wrap = wrap != 0;
+    if (err == CL_SUCCESS && e->parity_kernels[1]) err = bind_parity_kernels(e, e->config.steps_per_launch);
+    if (err != CL_SUCCESS) return fail(e, GOL_ENGINE_ECL, "board setup (code %d)", err);
+
+    e->cur = 0;
+    e->generation = 0;
+    e->loaded = 1;
+    return GOL_ENGINE_OK;
+}
+
+int gol_load(GolEngine* e, const unsigned char* grid, int rows, int cols, int wrap, uint32_t rule) {
+    if (!e || !grid) return GOL_ENGINE_EARG;
+    int rc = gol_engine_prepare(e, rows, cols, rule);
+    if (rc != GOL_ENGINE_OK) return rc;
+    e->load_ns = 0;
+
+    const void* src = grid;
+    if (e->config.packed) {
+        gol_pack_grid(grid, (uint64_t*)e->host, rows, cols);
+        src = e->host;
+    } else if (e->config.states > 2) {
+        gol_gens_pack(grid, (uint32_t*)e->host, rows, cols, gol_gens_bits_per_cell(e->config.states));
+        src = e->host;
+    }
+
+    cl_int err = CL_SUCCESS;
+    cl_event ev;
+    if (e->config.zero_copy) {
+        // The host copy into the mapping counts as part of the upload.
+        cl_event ev_map;
+        void* view = clEnqueueMapBuffer(e->queue, e->buf[0], CL_TRUE, CL_MAP_WRITE_INVALIDATE_REGION, 0, e->bytes,
+                                        0, NULL, &ev_map, &err);
+        if (err != CL_SUCCESS) return fail(e, GOL_ENGINE_ECL, "board mapping (code %d)", err);
+        if (e->profile) e->load_ns += (uint64_t)gol_event_ns(ev_map);
+        clReleaseEvent(ev_map);
+        const double copy_start_ms = gol_now_ms();
+        memcpy(view, src, e->bytes);
+        if (e->profile) e->load_ns += (uint64_t)((gol_now_ms() - copy_start_ms) * 1e6);
+        err = clEnqueueUnmapMemObject(e->queue, e->buf[0], view, 0, NULL, &ev);
+        if (err == CL_SUCCESS) err = clWaitForEvents(1, &ev);
+    } else {
+        err = clEnqueueWriteBuffer(e->queue, e->buf[0], CL_TRUE, 0, e->bytes, src, 0, NULL, &ev);
+    }
+    if (err != CL_SUCCESS) return fail(e, GOL_ENGINE_ECL, "board upload (code %d)", err);
+    return start_simulation(e, ev, e->config.zero_copy ? "unmap" : "write", wrap);
+}
+
+int gol_load_buffer(GolEngine* e, cl_mem board, int rows, int cols, int wrap, uint32_t rule) {
+    if (!e || !board) return GOL_ENGINE_EARG;
+    int rc = gol_engine_prepare(e, rows, cols, rule);
+    if (rc != GOL_ENGINE_OK) return rc;
+    e->load_ns = 0;
+
+    cl_event ev;
+    cl_int err = clEnqueueCopyBuffer(e->queue, board, e->buf[0], 0, 0, e->bytes, 0, NULL, &ev);
+    if (err == CL_SUCCESS) err = clWaitForEvents(1, &ev);
+    if (err != CL_SUCCESS) return fail(e, GOL_ENGINE_ECL, "board copy (code %d)", err);
+    return start_simulation(e, ev, "copy_initial", wrap);
+}
+
+// Bind the arguments a -D GOL_STATS step kernel takes after its step arguments.
+static cl_int set_stats_args(cl_kernel kernel, cl_uint first, cl_mem stats, int slot) {
+    cl_int err;
+    err  = clSetKernelArg(kernel, first, sizeof(cl_mem), &stats);
+    err |= clSetKernelArg(kernel, first + 1, GOL_STATS_WORDS * sizeof(cl_uint), NULL);
+    err |= clSetKernelArg(kernel, first + 2, sizeof(int), &slot);
+    return err;
+}
+
+// Wait for the launches of one gol_step_n and record their kernel times; sparse generations
+// are a list build and a step launch, whose times are added up.
+static void collect_launches(GolEngine* e, int n_events) {
+    const int per_launch = e->config.sparse ? 2 : 1;
+    for (int k = 0; k < n_events; ++k) {
+        const char* name = (per_launch == 2 && !(k & 1)) ? "gol_sparse_build_list" : e->kernel_name;
+        const uint64_t ns = command_ns(e, e->events[k], name, "kernel");
+        if (k % per_launch == 0) e->launch_ns[k / per_launch] = 0;
+        e->launch_ns[k / per_launch] += ns;
+        e->step_ns += ns;
+        clReleaseEvent(e->events[k]);
+    }
+    e->launches = n_events / per_launch;
+}
+
+// Step only the tiles next to last generation's changes; the list length stays on the device.
+static int step_sparse(GolEngine* e, int n) {
+    int rc = reserve_mem(e, &e->counts, &e->counts_capacity, (size_t)n * sizeof(cl_int));
+    if (rc != GOL_ENGINE_OK) return rc;
+    const cl_int zero = 0;
+    cl_int err = clEnqueueFillBuffer(e->queue, e->counts, &zero, sizeof(zero), 0, (size_t)n * sizeof(cl_int), 0, NULL, NULL);
+    int n_events = 0;
+    for (int t = 0; t < n && err == CL_SUCCESS; ++t) {
+        cl_mem changed = e->flags[e->generation & 1];
+        cl_mem changed_next = e->flags[(e->generation + 1) & 1];
+
+        // First compact the tiles touched by last generation's changes into the list.
+        err  = clSetKernelArg(e->list_kernel, 0, sizeof(cl_mem), &changed);
+        err |= clSetKernelArg(e->list_kernel, 1, sizeof(cl_mem), &changed_next);
+        err |= clSetKernelArg(e->list_kernel, 2, sizeof(cl_mem), &e->tile_list);
+        err |= clSetKernelArg(e->list_kernel, 3, sizeof(cl_mem), &e->counts);
+        err |= clSetKernelArg(e->list_kernel, 4, sizeof(int), &e->tiles_x);
+        err |= clSetKernelArg(e->list_kernel, 5, sizeof(int), &e->tiles_y);
+        err |= clSetKernelArg(e->list_kernel, 6, sizeof(int), &e->wrap);
+        err |= clSetKernelArg(e->list_kernel, 7, sizeof(int), &t);
+        if (err == CL_SUCCESS) {
+            err = clEnqueueNDRangeKernel(e->queue, e->list_kernel, 1, NULL, &e->list_global, NULL, 0, NULL, &e->events[n_events]);
+        }
+        if (err != CL_SUCCESS) break;
+        ++n_events;
+
+        // Then step only the listed tiles.
+        err  = clSetKernelArg(e->kernel, 0, sizeof(cl_mem), &e->buf[e->cur]);
+        err |= clSetKernelArg(e->kernel, 1, sizeof(cl_mem), &e->buf[1 - e->cur]);
+        err |= clSetKernelArg(e->kernel, 2, sizeof(int), &e->rows);
+        err |= clSetKernelArg(e->kernel, 3, sizeof(int), &e->cols);
+        err |= clSetKernelArg(e->kernel, 4, sizeof(int), &e->wrap);
+        err |= clSetKernelArg(e->kernel, 5, sizeof(cl_mem), &e->tile_list);
+        err |= clSetKernelArg(e->kernel, 6, sizeof(cl_mem), &e->counts);
+        err |= clSetKernelArg(e->kernel, 7, sizeof(cl_mem), &changed_next);
+        err |= clSetKernelArg(e->kernel, 8, sizeof(int), &e->tiles_y);
+        err |= clSetKernelArg(e->kernel, 9, sizeof(int), &t);
+        if (err == CL_SUCCESS) {
+            err = clEnqueueNDRangeKernel(e->queue, e->kernel, 2, NULL, e->sparse_global, e->local, 0, NULL, &e->events[n_events]);
+        }
+        if (err != CL_SUCCESS) break;
+        ++n_events;
+        e->cur = 1 - e->cur;
+        ++e->generation;
+    }
+
+    // Generations already queued still complete; the board stays consistent with the count.
+    const cl_int finish_err = clFinish(e->queue);
+    collect_launches(e, n_events & ~1);
+    if (n_events & 1) clReleaseEvent(e->events[n_events - 1]);
+    if (err == CL_SUCCESS) err = finish_err;
+    if (err != CL_SUCCESS) return fail(e, GOL_ENGINE_ECL, "sparse launch (code %d)", err);
+
+    cl_int* counts = (cl_int*)malloc((size_t)n * sizeof(cl_int));
+    if (!counts) return fail(e, GOL_ENGINE_ENOMEM, "tile counts");
+    err = clEnqueueReadBuffer(e->queue, e->counts, CL_TRUE, 0, (size_t)n * sizeof(cl_int), counts, 0, NULL, NULL);
+    for (int t = 0; t < n && err == CL_SUCCESS; ++t) e->active_tiles += (uint64_t)counts[t];
+    free(counts);
+    return err == CL_SUCCESS ? GOL_ENGINE_OK : fail(e, GOL_ENGINE_ECL, "tile count read (code %d)", err);
+}
+
+int gol_step_n(GolEngine* e, int n) {
+    if (!e || !e->loaded || n < 0) return GOL_ENGINE_EARG;
+    const GolEngineConfig* c = &e->config;
+    e->message[0] = 0;
+    e->step_ns = 0;
+    e->launches = 0;
+    e->active_tiles = 0;
+    if (n == 0) return GOL_ENGINE_OK;
+
+    const int steps = c->steps_per_launch;
+    const int max_launches = (n + steps - 1) / steps;
+    int rc = reserve_launches(e, c->sparse ? n : max_launches);
+    if (rc != GOL_ENGINE_OK) return rc;
+    if (c->sparse) return step_sparse(e, n);
+
+    // Batched launches go into the in-order queue back to back and are only inspected at the end;
+    // otherwise each launch is waited for, as a host loop between generations would.
+    const int multi_step = c->tiled && steps > 1;
+    cl_int err = CL_SUCCESS;
+    int n_events = 0;
+    for (int t = 0; t < n; t += steps) {
+        const int launch_steps = (n - t < steps) ? (n - t) : steps;
+        cl_kernel kernel = e->kernel;
+        if (c->batch) {
+            // Pre-bound kernels only need new arguments for a shorter final multi-step launch.
+            kernel = e->parity_kernels[e->cur];
+            if (launch_steps != steps) err = bind_parity_kernels(e, launch_steps);
+        } else {
+            err = gol_set_step_args(kernel, e->buf[e->cur], e->buf[1 - e->cur], e->rows, e->cols, e->wrap,
+                                    c->tiled, multi_step, launch_steps, e->local[0], e->local[1]);
+        }
+        if (c->stats_slots > 0) {
+            err |= set_stats_args(kernel, c->tiled ? 6u : 5u, e->stats, (int)(e->generation % (uint64_t)c->stats_slots));
+        }
+        cl_event ev;
+        if (err == CL_SUCCESS) err = clEnqueueNDRangeKernel(e->queue, kernel, 2, NULL, e->global, e->local, 0, NULL, &ev);
+        // Restore the full-length binding for later calls; the enqueued launch keeps its own copy.
+        if (err == CL_SUCCESS && c->batch && launch_steps != steps) err = bind_parity_kernels(e, steps);
+        if (err != CL_SUCCESS) break;
+        e->cur = 1 - e->cur;
+        e->generation += (uint64_t)launch_steps;
+
+        if (c->batch) {
+            e->events[n_events++] = ev;
+        } else {
+            err = clWaitForEvents(1, &ev);
+            e->launch_ns[e->launches] = command_ns(e, ev, e->kernel_name, "kernel");
+            e->step_ns += e->launch_ns[e->launches++];
+            clReleaseEvent(ev);
+            if (err != CL_SUCCESS) break;
+        }
+    }
+
+    const cl_int finish_err = clFinish(e->queue);
+    if (c->batch) collect_launches(e, n_events);
+    if (err == CL_SUCCESS) err = finish_err;
+    return err == CL_SUCCESS ? GOL_ENGINE_OK : fail(e, GOL_ENGINE_ECL, "step launch (code %d)", err);
+}
+
+int gol_read(GolEngine* e, unsigned char* grid) {
+    if (!e || !e->loaded || !grid) return GOL_ENGINE_EARG;
+    const GolEngineConfig* c = &e->config;
+    e->message[0] = 0;
+    e->read_ns = 0;
+
+    // A zero-copy board already is host memory and is only mapped for reading.
+    cl_int err = CL_SUCCESS;
+    cl_event ev;
+    const void* words = e->config.packed || c->states > 2 ? e->host : grid;
+    void* view = NULL;
+    if (c->zero_copy) {
+        view = clEnqueueMapBuffer(e->queue, e->buf[e->cur], CL_TRUE, CL_MAP_READ, 0, e->bytes, 0, NULL, &ev, &err);
+        words = view;
+    } else {
+        err = clEnqueueReadBuffer(e->queue, e->buf[e->cur], CL_TRUE, 0, e->bytes, (void*)words, 0, NULL, &ev);
+    }
+    if (err != CL_SUCCESS) return fail(e, GOL_ENGINE_ECL, "board download (code %d)", err);
+    e->read_ns = command_ns(e, ev, c->zero_copy ? "map" : "read", "transfer");
+    clReleaseEvent(ev);
+
+    if (c->packed) gol_unpack_grid((const uint64_t*)words, grid, e->rows, e->cols);
+    else if (c->states > 2) gol_gens_unpack((const uint32_t*)words, grid, e->rows, e->cols, gol_gens_bits_per_cell(c->states));
+    else if (view) memcpy(grid, view, e->bytes);
+    if (view) {
+        err = clEnqueueUnmapMemObject(e->queue, e->buf[e->cur], view, 0, NULL, NULL);
+        if (err == CL_SUCCESS) err = clFinish(e->queue);
+        if (err != CL_SUCCESS) return fail(e, GOL_ENGINE_ECL, "board unmap (code %d)", err);
+    }
+    return GOL_ENGINE_OK;
+}
+
+uint64_t gol_generation(const GolEngine* e) {
+    return e ? e->generation : 0;
+}
+
+int gol_engine_read_stats(GolEngine* e, uint32_t* words, int n) {
+    if (!e || !e->loaded || !words || n < 0 || n > e->config.stats_slots) return GOL_ENGINE_EARG;
+    if (n == 0) return GOL_ENGINE_OK;
+    const size_t bytes = (size_t)n * GOL_STATS_WORDS * sizeof(cl_uint);
+    const cl_uint zero = 0;
+    cl_int err = clEnqueueReadBuffer(e->queue, e->stats, CL_TRUE, 0, bytes, words, 0, NULL, NULL);
+    if (err == CL_SUCCESS) err = clEnqueueFillBuffer(e->queue, e->stats, &zero, sizeof(zero), 0, bytes, 0, NULL, NULL);
+    return err == CL_SUCCESS ? GOL_ENGINE_OK : fail(e, GOL_ENGINE_ECL, "statistics read (code %d)", err);
+}
+
+void gol_engine_profile(const GolEngine* e, GolEngineProfile* p) {
+    p->load_ns = e->load_ns;
+    p->step_ns = e->step_ns;
+    p->read_ns = e->read_ns;
+    p->launch_ns = e->launch_ns;
+    p->launches = e->launches;
+    p->active_tiles = e->active_tiles;
+    p->tiles = e->config.sparse ? e->tiles_x * e->tiles_y : 0;
+}
+
+const GolBuildStats* gol_engine_build_stats(const GolEngine* e) {
+    return &e->build;
+}
+
+const char* gol_engine_message(const GolEngine* e) {
+    return e ? e->message : "";
+}
+
+cl_device_id gol_engine_device(const GolEngine* e) {
+    return e->device;
+}
+
+cl_context gol_engine_context(const GolEngine* e) {
+    return e->context;
+}
+
+cl_command_queue gol_engine_queue(const GolEngine* e) {
+    return e->queue;
+}
+
+cl_mem gol_engine_board(const GolEngine* e) {
+    return e->buf[e->cur];
+}
+
+const char* gol_engine_error_string(int code) {
+    switch (code) {
+        case GOL_ENGINE_OK: return "success";
+        case GOL_ENGINE_ENODEV: return "no OpenCL GPU/CPU device found";
+        case GOL_ENGINE_ECL: return "an OpenCL call failed";
+        case GOL_ENGINE_EBUILD: return "kernel source load or program build failed";
+        case GOL_ENGINE_EARG: return "invalid argument or no board loaded";
+        case GOL_ENGINE_ENOMEM: return "host allocation failed";
+        default: return "unknown error";
+    }
+}
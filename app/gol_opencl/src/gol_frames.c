@@ -0,0 +1,146 @@
+#include "../include/gol_frames.h"
+#include "../include/kernel_loader.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+// Smallest downsampling factor that keeps both frame sides within GOL_FRAME_MAX_SIDE pixels.
+static int auto_frame_scale(int rows, int cols) {
+    const int side = rows > cols ? rows : cols;
+    return (side + GOL_FRAME_MAX_SIDE - 1) / GOL_FRAME_MAX_SIDE;
+}
+
+int gol_frames_start(GolFrameStream* fs, cl_context context, cl_device_id device,
+                     const char* kernel_dir, const char* kernel_cache,
+                     int rows, int cols, int packed, int words_per_row, int scale, const char* out) {
+    memset(fs, 0, sizeof(*fs));
+    fs->rows = rows;
+    fs->cols = cols;
+    fs->scale = scale > 0 ? scale : auto_frame_scale(rows, cols);
+    fs->frame_rows = (rows + fs->scale - 1) / fs->scale;
+    fs->frame_cols = (cols + fs->scale - 1) / fs->scale;
+    fs->global[0] = gol_round_up((size_t)fs->frame_rows, 16);
+    fs->global[1] = gol_round_up((size_t)fs->frame_cols, 16);
+
+    if (!strcmp(out, "-")) {
+        fflush(stdout);
+#ifdef _WIN32
+        const int fd = _dup(_fileno(stdout));
+        if (fd < 0 || _dup2(_fileno(stderr), _fileno(stdout)) != 0) return 0;
+        _setmode(fd, _O_BINARY);
+        fs->pipe = _fdopen(fd, "wb");
+#else
+        const int fd = dup(STDOUT_FILENO);
+        if (fd < 0 || dup2(STDERR_FILENO, STDOUT_FILENO) < 0) return 0;
+        fs->pipe = fdopen(fd, "wb");
+#endif
+        if (!fs->pipe) return 0;
+    } else {
+        fs->prefix = out;
+    }
+
+    cl_int err;
+    int loader_err = 0;
+    char* src = load_kernel("gol_frame.cl", kernel_dir, &loader_err);
+    if (loader_err != 0 || !src) {
+        gol_print_kernel_load_error("gol_frame.cl", kernel_dir, loader_err);
+        return 0;
+    }
+    // Like the bandwidth probe, this build is not part of the run's program build statistics.
+    GolBuildStats build = {0, 0, 0.0, 0};
+    fs->program = gol_build_program(context, device, src, "", kernel_cache, &build, &err);
+    if (!fs->program) gol_die_cl("clBuildProgram", err);
+    free(src);
+    fs->kernel = clCreateKernel(fs->program, packed ? "gol_frame_packed" : "gol_frame", &err);
+    if (!fs->kernel || err != CL_SUCCESS) gol_die_cl("clCreateKernel(gol_frame)", err);
+    err  = clSetKernelArg(fs->kernel, 2, sizeof(int), &fs->rows);
+    err |= clSetKernelArg(fs->kernel, 3, sizeof(int), &fs->cols);
+    err |= clSetKernelArg(fs->kernel, 4, sizeof(int), &fs->scale);
+    err |= clSetKernelArg(fs->kernel, 5, sizeof(int), &fs->frame_rows);
+    err |= clSetKernelArg(fs->kernel, 6, sizeof(int), &fs->frame_cols);
+    if (packed) err |= clSetKernelArg(fs->kernel, 7, sizeof(int), &words_per_row);
+    if (err != CL_SUCCESS) gol_die_cl("clSetKernelArg(gol_frame)", err);
+
+    const size_t bytes = (size_t)fs->frame_rows * (size_t)fs->frame_cols;
+    for (int s = 0; s < GOL_FRAME_SLOTS; ++s) {
+        fs->slots[s].image = clCreateBuffer(context, CL_MEM_WRITE_ONLY, bytes, NULL, &err);
+        if (!fs->slots[s].image || err != CL_SUCCESS) gol_die_cl("clCreateBuffer(frame)", err);
+        fs->slots[s].host = (unsigned char*)malloc(bytes);
+        if (!fs->slots[s].host) {
+            fprintf(stderr, "Host allocation failed (frames)\n");
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Wait for the frame of a slot and write it as a binary PGM.
+static void frame_write(GolFrameStream* fs, GolFrameSlot* slot) {
+    cl_int err = clWaitForEvents(1, &slot->ready);
+    clReleaseEvent(slot->ready);
+    slot->ready = NULL;
+    slot->pending = 0;
+    if (err != CL_SUCCESS) {
+        ++fs->failed;
+        return;
+    }
+
+    char path[1024];
+    FILE* f = fs->pipe;
+    if (!f) {
+        snprintf(path, sizeof(path), "%s_%012llu.pgm", fs->prefix, (unsigned long long)slot->generation);
+        f = fopen(path, "wb");
+        if (!f) {
+            if (!fs->failed++) fprintf(stderr, "Could not open frame file: %s\n", path);
+            return;
+        }
+    }
+    const size_t bytes = (size_t)fs->frame_rows * (size_t)fs->frame_cols;
+    int ok = fprintf(f, "P5\n%d %d\n255\n", fs->frame_cols, fs->frame_rows) > 0
+          && fwrite(slot->host, 1, bytes, f) == bytes;
+    if (fs->pipe) ok = ok && fflush(f) == 0;
+    else if (fclose(f) != 0) ok = 0;
+    if (ok) ++fs->written;
+    else if (!fs->failed++) fprintf(stderr, "Could not write frame of generation %llu\n", (unsigned long long)slot->generation);
+}
+
+void gol_frames_enqueue(GolFrameStream* fs, cl_command_queue queue, cl_mem board, uint64_t generation) {
+    GolFrameSlot* slot = &fs->slots[fs->fill];
+    if (slot->pending) frame_write(fs, slot);
+
+    cl_int err;
+    err  = clSetKernelArg(fs->kernel, 0, sizeof(cl_mem), &board);
+    err |= clSetKernelArg(fs->kernel, 1, sizeof(cl_mem), &slot->image);
+    if (err != CL_SUCCESS) gol_die_cl("clSetKernelArg(gol_frame)", err);
+    err = clEnqueueNDRangeKernel(queue, fs->kernel, 2, NULL, fs->global, NULL, 0, NULL, NULL);
+    if (err != CL_SUCCESS) gol_die_cl("clEnqueueNDRangeKernel(gol_frame)", err);
+    err = clEnqueueReadBuffer(queue, slot->image, CL_FALSE, 0, (size_t)fs->frame_rows * (size_t)fs->frame_cols,
+                              slot->host, 0, NULL, &slot->ready);
+    if (err != CL_SUCCESS) gol_die_cl("clEnqueueReadBuffer(frame)", err);
+    clFlush(queue);
+    slot->generation = generation;
+    slot->pending = 1;
+    fs->fill = (fs->fill + 1) % GOL_FRAME_SLOTS;
+}
+
+void gol_frames_finish(GolFrameStream* fs) {
+    for (int k = 0; k < GOL_FRAME_SLOTS; ++k) {
+        GolFrameSlot* slot = &fs->slots[(fs->fill + k) % GOL_FRAME_SLOTS];
+        if (slot->pending) frame_write(fs, slot);
+    }
+    for (int s = 0; s < GOL_FRAME_SLOTS; ++s) {
+        if (fs->slots[s].image) clReleaseMemObject(fs->slots[s].image);
+        free(fs->slots[s].host);
+    }
+    if (fs->kernel) clReleaseKernel(fs->kernel);
+    if (fs->program) clReleaseProgram(fs->program);
+    if (fs->pipe && fclose(fs->pipe) != 0) ++fs->failed;
+    fs->pipe = NULL;
+}
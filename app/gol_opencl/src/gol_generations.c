@@ -0,0 +1,122 @@
+#include "../include/gol_generations.h"
+#include "../include/gol_rule.h"
+
+#include <string.h>
+
+int gol_gens_bits_per_cell(int states) {
+    if (states <= 4) return 2;
+    if (states <= 16) return 4;
+    return 8;
+}
+
+// Round the column count up to whole 32-bit words.
+size_t gol_gens_words_per_row(int cols, int bits) {
+    const size_t cpw = 32u / (size_t)bits;
+    return ((size_t)cols + cpw - 1u) / cpw;
+}
+
+void gol_gens_pack(const unsigned char* grid, uint32_t* packed, int rows, int cols, int bits) {
+    const int cpw = 32 / bits;
+    const size_t wpr = gol_gens_words_per_row(cols, bits);
+    const uint32_t mask = (1u << bits) - 1u;
+
+    for (int x = 0; x < rows; ++x) {
+        const unsigned char* src = grid + (size_t)x * (size_t)cols;
+        uint32_t* dst = packed + (size_t)x * wpr;
+
+        // Clear the row first so the padding cells of the last word stay dead.
+        memset(dst, 0, wpr * sizeof(uint32_t));
+        for (int y = 0; y < cols; ++y) {
+            dst[y / cpw] |= ((uint32_t)src[y] & mask) << ((y % cpw) * bits);
+        }
+    }
+}
+
+void gol_gens_unpack(const uint32_t* packed, unsigned char* grid, int rows, int cols, int bits) {
+    const int cpw = 32 / bits;
+    const size_t wpr = gol_gens_words_per_row(cols, bits);
+    const uint32_t mask = (1u << bits) - 1u;
+
+    for (int x = 0; x < rows; ++x) {
+        const uint32_t* src = packed + (size_t)x * wpr;
+        unsigned char* dst = grid + (size_t)x * (size_t)cols;
+        for (int y = 0; y < cols; ++y) {
+            dst[y] = (unsigned char)((src[y / cpw] >> ((y % cpw) * bits)) & mask);
+        }
+    }
+}
+
+// Gather one flag per cell of a word, bit i set when cell i is alive (state 1).
+static uint32_t alive_bits(uint32_t word, int bits) {
+    uint32_t x;
+    switch (bits) {
+    case 2:
+        // 01 fields keep their low bit, then the even bits are compressed into the low half.
+        x = word & ~(word >> 1) & 0x55555555u;
+        x = (x | (x >> 1)) & 0x33333333u;
+        x = (x | (x >> 2)) & 0x0F0F0F0Fu;
+        x = (x | (x >> 4)) & 0x00FF00FFu;
+        return (x | (x >> 8)) & 0x0000FFFFu;
+    case 4:
+        x = word & ~(word >> 1) & ~(word >> 2) & ~(word >> 3) & 0x11111111u;
+        x = (x | (x >> 3)) & 0x03030303u;
+        x = (x | (x >> 6)) & 0x000F000Fu;
+        return (x | (x >> 12)) & 0x000000FFu;
+    default:
+        x = 0;
+        for (int i = 0; i < 4; ++i) x |= (uint32_t)(((word >> (8 * i)) & 0xFFu) == 1u) << i;
+        return x;
+    }
+}
+
+// Alive flags of word w of row x plus one neighbor column on each side: bit 0 is the
+// column left of the word, bit i + 1 is cell i, and the bit after the last real cell
+// is the column right of it. Rows outside the board are dead or wrapped.
+static uint32_t row_window(const uint32_t* grid, int x, int w, int rows, int cols, int wpr, int wrap, int bits) {
+    if (x < 0 || x >= rows) {
+        if (!wrap) return 0;
+        x = (x < 0) ? x + rows : x - rows;
+    }
+    const uint32_t* row = grid + (size_t)x * (size_t)wpr;
+    const int cpw = 32 / bits;
+
+    uint32_t win = alive_bits(row[w], bits) << 1;
+    if (w > 0) {
+        win |= (alive_bits(row[w - 1], bits) >> (cpw - 1)) & 1u;
+    } else if (wrap) {
+        const int c = cols - 1;
+        win |= (alive_bits(row[c / cpw], bits) >> (c % cpw)) & 1u;
+    }
+    if (w < wpr - 1) win |= (alive_bits(row[w + 1], bits) & 1u) << (cpw + 1);
+    else if (wrap) win |= (alive_bits(row[0], bits) & 1u) << (cols - w * cpw + 1);
+    return win;
+}
+
+void gol_gens_step(const uint32_t* in, uint32_t* out, int rows, int cols, int wrap,
+                   uint32_t rule, int states)
+{
+    static const unsigned char pop3[8] = { 0, 1, 1, 2, 1, 2, 2, 3 };
+    const int bits = gol_gens_bits_per_cell(states);
+    const int cpw = 32 / bits;
+    const int wpr = (int)gol_gens_words_per_row(cols, bits);
+    const uint32_t mask = (1u << bits) - 1u;
+
+    for (int x = 0; x < rows; ++x) {
+        for (int w = 0; w < wpr; ++w) {
+            const uint32_t up = row_window(in, x - 1, w, rows, cols, wpr, wrap, bits);
+            const uint32_t mid = row_window(in, x, w, rows, cols, wpr, wrap, bits);
+            const uint32_t down = row_window(in, x + 1, w, rows, cols, wpr, wrap, bits);
+            const uint32_t word = in[(size_t)x * (size_t)wpr + (size_t)w];
+
+            // Padding cells of the last word are never written, so they stay dead.
+            const int n = (cols - w * cpw < cpw) ? cols - w * cpw : cpw;
+            uint32_t result = 0;
+            for (int i = 0; i < n; ++i) {
+                const int sum = pop3[(up >> i) & 7u] + pop3[(mid >> i) & 5u] + pop3[(down >> i) & 7u];
+                const int state = (int)((word >> (i * bits)) & mask);
+                result |= (uint32_t)gol_rule_next_state(rule, states, state, sum) << (i * bits);
+            }
+            out[(size_t)x * (size_t)wpr + (size_t)w] = result;
+        }
+    }
+}
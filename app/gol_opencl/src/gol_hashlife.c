@@ -0,0 +1,428 @@
+#include "../include/gol_hashlife.h"
+#include "../include/gol_rule.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define HL_NONE 0xFFFFFFFFu
+#define HL_DEAD 0u
+#define HL_ALIVE 1u
+#define HL_MAX_LEVEL 62
+
+// Drop the whole arena between jumps once it grows past this many nodes.
+#define HL_RESET_NODES ((size_t)1 << 23)
+
+// One canonical quadtree node. Level 0 nodes are the two leaves (dead, alive).
+typedef struct HlNode {
+    uint32_t child[4];    // nw, ne, sw, se
+    uint32_t result;      // memoized successor, or HL_NONE
+    uint32_t next;        // next node in the same hash bucket
+    int32_t result_step;  // log2 of the generations advanced by result
+    uint32_t level;
+} HlNode;
+
+// Memo entry of the periodic builder: the node of one level at one position modulo the board.
+typedef struct HlBuildEntry {
+    uint32_t level;
+    uint32_t node;
+    int64_t x;
+    int64_t y;
+} HlBuildEntry;
+
+struct GolHashlife {
+    HlNode* nodes;
+    size_t count;
+    size_t capacity;
+
+    uint32_t* buckets;
+    size_t bucket_mask;
+
+    HlBuildEntry* build;
+    size_t build_mask;
+    size_t build_count;
+
+    uint32_t empty[HL_MAX_LEVEL + 1];
+    int oom;
+
+    // Board that the periodic builder currently reads from.
+    const unsigned char* grid;
+    int rows;
+    int cols;
+
+    // Center 2x2 of a 4x4 block after one generation, indexed by the 16 cell bits.
+    uint8_t life4[1 << 16];
+};
+
+// Mix four child indices into one bucket hash.
+static size_t hl_hash(uint32_t a, uint32_t b, uint32_t c, uint32_t d) {
+    uint64_t h = (uint64_t)a * 0x9E3779B97F4A7C15ull;
+    h ^= (uint64_t)b * 0xC2B2AE3D27D4EB4Full + (h >> 29);
+    h ^= (uint64_t)c * 0x165667B19E3779F9ull + (h >> 31);
+    h ^= (uint64_t)d * 0xD6E8FEB86659FD93ull + (h >> 27);
+    return (size_t)(h ^ (h >> 32));
+}
+
+// Double the bucket table and re-link every node.
+static int hl_rehash(GolHashlife* hl) {
+    const size_t n_buckets = (hl->bucket_mask + 1) * 2;
+    uint32_t* buckets = (uint32_t*)malloc(n_buckets * sizeof(uint32_t));
+    if (!buckets) return -1;
+    memset(buckets, 0xFF, n_buckets * sizeof(uint32_t));
+
+    for (size_t i = 2; i < hl->count; ++i) {
+        HlNode* nd = &hl->nodes[i];
+        const size_t b = hl_hash(nd->child[0], nd->child[1], nd->child[2], nd->child[3]) & (n_buckets - 1);
+        nd->next = buckets[b];
+        buckets[b] = (uint32_t)i;
+    }
+
+    free(hl->buckets);
+    hl->buckets = buckets;
+    hl->bucket_mask = n_buckets - 1;
+    return 0;
+}
+
+// Return the canonical node with the given four children, creating it if needed.
+static uint32_t hl_join(GolHashlife* hl, uint32_t nw, uint32_t ne, uint32_t sw, uint32_t se) {
+    if (hl->oom) return HL_DEAD;
+
+    const size_t b = hl_hash(nw, ne, sw, se) & hl->bucket_mask;
+    for (uint32_t i = hl->buckets[b]; i != HL_NONE; i = hl->nodes[i].next) {
+        const HlNode* nd = &hl->nodes[i];
+        if (nd->child[0] == nw && nd->child[1] == ne && nd->child[2] == sw && nd->child[3] == se) return i;
+    }
+
+    // Grow the arena geometrically; indices stay valid, pointers do not.
+    if (hl->count == hl->capacity) {
+        const size_t capacity = hl->capacity * 2;
+        if (capacity >= (size_t)HL_NONE) {
+            hl->oom = 1;
+            return HL_DEAD;
+        }
+        HlNode* nodes = (HlNode*)realloc(hl->nodes, capacity * sizeof(HlNode));
+        if (!nodes) {
+            hl->oom = 1;
+            return HL_DEAD;
+        }
+        hl->nodes = nodes;
+        hl->capacity = capacity;
+    }
+
+    const uint32_t idx = (uint32_t)hl->count++;
+    HlNode* nd = &hl->nodes[idx];
+    nd->child[0] = nw;
+    nd->child[1] = ne;
+    nd->child[2] = sw;
+    nd->child[3] = se;
+    nd->result = HL_NONE;
+    nd->result_step = -1;
+    nd->level = hl->nodes[nw].level + 1;
+    nd->next = hl->buckets[b];
+    hl->buckets[b] = idx;
+
+    // Keep the load factor at or below one node per bucket.
+    if (hl->count > hl->bucket_mask + 1 && hl_rehash(hl) != 0) hl->oom = 1;
+    return idx;
+}
+
+// Return the all-dead node of one level.
+static uint32_t hl_empty(GolHashlife* hl, uint32_t level) {
+    if (hl->empty[level] == HL_NONE) {
+        const uint32_t e = hl_empty(hl, level - 1);
+        hl->empty[level] = hl_join(hl, e, e, e, e);
+    }
+    return hl->empty[level];
+}
+
+// Forget every node except the two leaves.
+static void hl_reset(GolHashlife* hl) {
+    hl->count = 2;
+    hl->oom = 0;
+    memset(hl->buckets, 0xFF, (hl->bucket_mask + 1) * sizeof(uint32_t));
+    for (int l = 1; l <= HL_MAX_LEVEL; ++l) hl->empty[l] = HL_NONE;
+    hl->nodes[HL_DEAD].result = HL_NONE;
+    hl->nodes[HL_ALIVE].result = HL_NONE;
+}
+
+// Precompute one generation of the rule for the center of every 4x4 block (bit r * 4 + c is row r, column c).
+static void hl_init_life4(GolHashlife* hl, uint32_t rule) {
+    for (uint32_t p = 0; p < (1u << 16); ++p) {
+        uint8_t out = 0;
+        for (int r = 1; r <= 2; ++r) {
+            for (int c = 1; c <= 2; ++c) {
+                int sum = 0;
+                for (int dr = -1; dr <= 1; ++dr) {
+                    for (int dc = -1; dc <= 1; ++dc) {
+                        if (dr == 0 && dc == 0) continue;
+                        sum += (int)((p >> ((r + dr) * 4 + (c + dc))) & 1u);
+                    }
+                }
+                const int alive = (int)((p >> (r * 4 + c)) & 1u);
+                const int next = gol_rule_next(rule, alive, sum);
+                out |= (uint8_t)(next << ((r - 1) * 2 + (c - 1)));
+            }
+        }
+        hl->life4[p] = out;
+    }
+}
+
+// Advance a level-2 node (4x4 cells) by one generation and return its center 2x2.
+static uint32_t hl_life_4x4(GolHashlife* hl, uint32_t m) {
+    uint32_t q[4];
+    memcpy(q, hl->nodes[m].child, sizeof(q));
+
+    // Leaf indices are the cell values, so the 16 bits can be read off the level-1 children.
+    uint32_t p = 0;
+    for (int i = 0; i < 4; ++i) {
+        const uint32_t* leaf = hl->nodes[q[i]].child;
+        const int r0 = (i >> 1) * 2;
+        const int c0 = (i & 1) * 2;
+        p |= leaf[0] << (r0 * 4 + c0);
+        p |= leaf[1] << (r0 * 4 + c0 + 1);
+        p |= leaf[2] << ((r0 + 1) * 4 + c0);
+        p |= leaf[3] << ((r0 + 1) * 4 + c0 + 1);
+    }
+
+    const uint8_t out = hl->life4[p];
+    return hl_join(hl, out & 1u, (out >> 1) & 1u, (out >> 2) & 1u, (out >> 3) & 1u);
+}
+
+/*
+ * RESULT: the center half of a level-k node advanced by 2^j generations (j <= k - 2).
+ * Nine overlapping sub-results are computed first; with j == k - 2 they are
+ * advanced once more (two half-steps), otherwise only their centers are joined.
+ */
+static uint32_t hl_successor(GolHashlife* hl, uint32_t m, int j) {
+    const uint32_t k = hl->nodes[m].level;
+    const int step = (j > (int)k - 2) ? (int)k - 2 : j;
+
+    if (hl->oom) return HL_DEAD;
+    if (hl->nodes[m].result != HL_NONE && hl->nodes[m].result_step == step) return hl->nodes[m].result;
+
+    uint32_t s;
+    if (m == hl_empty(hl, k)) {
+        // Empty space stays empty.
+        s = hl_empty(hl, k - 1);
+    } else if (k == 2) {
+        s = hl_life_4x4(hl, m);
+    } else {
+        // Copy the grandchildren first: hl_join may move the node array.
+        uint32_t q[4], g[4][4];
+        memcpy(q, hl->nodes[m].child, sizeof(q));
+        for (int i = 0; i < 4; ++i) memcpy(g[i], hl->nodes[q[i]].child, sizeof(g[i]));
+        enum { NW = 0, NE = 1, SW = 2, SE = 3 };
+
+        // Nine overlapping level-(k-1) squares, each reduced to its advanced center.
+        uint32_t c[9];
+        c[0] = hl_successor(hl, q[NW], step);
+        c[1] = hl_successor(hl, hl_join(hl, g[NW][NE], g[NE][NW], g[NW][SE], g[NE][SW]), step);
+        c[2] = hl_successor(hl, q[NE], step);
+        c[3] = hl_successor(hl, hl_join(hl, g[NW][SW], g[NW][SE], g[SW][NW], g[SW][NE]), step);
+        c[4] = hl_successor(hl, hl_join(hl, g[NW][SE], g[NE][SW], g[SW][NE], g[SE][NW]), step);
+        c[5] = hl_successor(hl, hl_join(hl, g[NE][SW], g[NE][SE], g[SE][NW], g[SE][NE]), step);
+        c[6] = hl_successor(hl, q[SW], step);
+        c[7] = hl_successor(hl, hl_join(hl, g[SW][NE], g[SE][NW], g[SW][SE], g[SE][SW]), step);
+        c[8] = hl_successor(hl, q[SE], step);
+
+        if (step < (int)k - 2) {
+            // The sub-results already advanced 2^step generations: join their inner quarters.
+            uint32_t h[9][4];
+            for (int i = 0; i < 9; ++i) memcpy(h[i], hl->nodes[c[i]].child, sizeof(h[i]));
+            s = hl_join(hl,
+                        hl_join(hl, h[0][SE], h[1][SW], h[3][NE], h[4][NW]),
+                        hl_join(hl, h[1][SE], h[2][SW], h[4][NE], h[5][NW]),
+                        hl_join(hl, h[3][SE], h[4][SW], h[6][NE], h[7][NW]),
+                        hl_join(hl, h[4][SE], h[5][SW], h[7][NE], h[8][NW]));
+        } else {
+            // Full speed: advance the four recombined squares by the second half-step.
+            const uint32_t r0 = hl_successor(hl, hl_join(hl, c[0], c[1], c[3], c[4]), step);
+            const uint32_t r1 = hl_successor(hl, hl_join(hl, c[1], c[2], c[4], c[5]), step);
+            const uint32_t r2 = hl_successor(hl, hl_join(hl, c[3], c[4], c[6], c[7]), step);
+            const uint32_t r3 = hl_successor(hl, hl_join(hl, c[4], c[5], c[7], c[8]), step);
+            s = hl_join(hl, r0, r1, r2, r3);
+        }
+    }
+
+    if (hl->oom) return HL_DEAD;
+    hl->nodes[m].result = s;
+    hl->nodes[m].result_step = step;
+    return s;
+}
+
+// Clear the periodic builder memo before a new universe is assembled.
+static int hl_build_reset(GolHashlife* hl) {
+    if (!hl->build) {
+        hl->build_mask = 4095;
+        hl->build = (HlBuildEntry*)malloc((hl->build_mask + 1) * sizeof(HlBuildEntry));
+        if (!hl->build) return -1;
+    }
+    for (size_t i = 0; i <= hl->build_mask; ++i) hl->build[i].node = HL_NONE;
+    hl->build_count = 0;
+    return 0;
+}
+
+// Insert one builder memo entry, doubling the open-addressing table when it gets half full.
+static void hl_build_insert(GolHashlife* hl, uint32_t level, int64_t x, int64_t y, uint32_t node) {
+    if ((hl->build_count + 1) * 2 > hl->build_mask + 1) {
+        const size_t old_size = hl->build_mask + 1;
+        HlBuildEntry* old = hl->build;
+        HlBuildEntry* grown = (HlBuildEntry*)malloc(old_size * 2 * sizeof(HlBuildEntry));
+        if (!grown) {
+            hl->oom = 1;
+            return;
+        }
+        hl->build = grown;
+        hl->build_mask = old_size * 2 - 1;
+        for (size_t i = 0; i <= hl->build_mask; ++i) hl->build[i].node = HL_NONE;
+        hl->build_count = 0;
+        for (size_t i = 0; i < old_size; ++i) {
+            if (old[i].node != HL_NONE) hl_build_insert(hl, old[i].level, old[i].x, old[i].y, old[i].node);
+        }
+        free(old);
+    }
+
+    size_t b = hl_hash(level, (uint32_t)x, (uint32_t)y, (uint32_t)(x >> 32)) & hl->build_mask;
+    while (hl->build[b].node != HL_NONE) b = (b + 1) & hl->build_mask;
+    hl->build[b].level = level;
+    hl->build[b].x = x;
+    hl->build[b].y = y;
+    hl->build[b].node = node;
+    hl->build_count++;
+}
+
+/*
+ * Build the level-l node whose top-left cell sits at board position (x, y)
+ * of the infinite periodic tiling. Positions are kept modulo the board size,
+ * so every distinct (level, x, y) is built once; on power-of-two boards all
+ * levels above the board size collapse to a single node.
+ */
+static uint32_t hl_build_periodic(GolHashlife* hl, uint32_t level, int64_t x, int64_t y) {
+    if (hl->oom) return HL_DEAD;
+    if (level == 0) return hl->grid[(size_t)x * (size_t)hl->cols + (size_t)y] ? HL_ALIVE : HL_DEAD;
+
+    size_t b = hl_hash(level, (uint32_t)x, (uint32_t)y, (uint32_t)(x >> 32)) & hl->build_mask;
+    for (; hl->build[b].node != HL_NONE; b = (b + 1) & hl->build_mask) {
+        const HlBuildEntry* e = &hl->build[b];
+        if (e->level == level && e->x == x && e->y == y) return e->node;
+    }
+
+    const uint64_t half = (uint64_t)1 << (level - 1);
+    const int64_t x2 = (int64_t)(((uint64_t)x + half % (uint64_t)hl->rows) % (uint64_t)hl->rows);
+    const int64_t y2 = (int64_t)(((uint64_t)y + half % (uint64_t)hl->cols) % (uint64_t)hl->cols);
+    const uint32_t nw = hl_build_periodic(hl, level - 1, x, y);
+    const uint32_t ne = hl_build_periodic(hl, level - 1, x, y2);
+    const uint32_t sw = hl_build_periodic(hl, level - 1, x2, y);
+    const uint32_t se = hl_build_periodic(hl, level - 1, x2, y2);
+    const uint32_t node = hl_join(hl, nw, ne, sw, se);
+
+    hl_build_insert(hl, level, x, y, node);
+    return node;
+}
+
+// Copy the part of a node inside [0, rows) x [0, cols) back to the board, shifted by (off_x, off_y).
+static void hl_blit(GolHashlife* hl, uint32_t node, uint32_t level, uint64_t x0, uint64_t y0,
+                    uint64_t off_x, uint64_t off_y, unsigned char* grid)
+{
+    const uint64_t rows = (uint64_t)hl->rows;
+    const uint64_t cols = (uint64_t)hl->cols;
+    if (x0 >= rows || y0 >= cols) return;
+    if (node == hl->empty[level]) return;
+
+    if (level == 0) {
+        grid[((x0 + off_x) % rows) * cols + (y0 + off_y) % cols] = (unsigned char)node;
+        return;
+    }
+
+    uint32_t q[4];
+    memcpy(q, hl->nodes[node].child, sizeof(q));
+    const uint64_t half = (uint64_t)1 << (level - 1);
+    hl_blit(hl, q[0], level - 1, x0, y0, off_x, off_y, grid);
+    hl_blit(hl, q[1], level - 1, x0, y0 + half, off_x, off_y, grid);
+    hl_blit(hl, q[2], level - 1, x0 + half, y0, off_x, off_y, grid);
+    hl_blit(hl, q[3], level - 1, x0 + half, y0 + half, off_x, off_y, grid);
+}
+
+// Allocate the arena, the bucket table and the two leaves.
+GolHashlife* gol_hashlife_create(uint32_t rule) {
+    GolHashlife* hl = (GolHashlife*)calloc(1, sizeof(GolHashlife));
+    if (!hl) return NULL;
+
+    hl->capacity = 1 << 16;
+    hl->nodes = (HlNode*)malloc(hl->capacity * sizeof(HlNode));
+    hl->bucket_mask = (1 << 16) - 1;
+    hl->buckets = (uint32_t*)malloc((hl->bucket_mask + 1) * sizeof(uint32_t));
+    if (!hl->nodes || !hl->buckets) {
+        gol_hashlife_destroy(hl);
+        return NULL;
+    }
+
+    // Leaves are their own children so level-1 nodes can be read uniformly.
+    for (uint32_t v = 0; v < 2; ++v) {
+        HlNode* leaf = &hl->nodes[v];
+        leaf->child[0] = leaf->child[1] = leaf->child[2] = leaf->child[3] = v;
+        leaf->level = 0;
+        leaf->next = HL_NONE;
+    }
+    hl->empty[0] = HL_DEAD;
+    hl_reset(hl);
+    hl_init_life4(hl, rule);
+    return hl;
+}
+
+void gol_hashlife_destroy(GolHashlife* hl) {
+    if (!hl) return;
+    free(hl->nodes);
+    free(hl->buckets);
+    free(hl->build);
+    free(hl);
+}
+
+size_t gol_hashlife_node_count(const GolHashlife* hl) {
+    return hl ? hl->count : 0;
+}
+
+// Advance the torus by a sequence of power-of-two jumps.
+int gol_hashlife_run(GolHashlife* hl, unsigned char* grid, int rows, int cols, uint64_t generations) {
+    if (!hl || !grid || rows <= 0 || cols <= 0) return -1;
+
+    // The smallest universe whose center half covers one full period of the board.
+    const uint64_t extent = (uint64_t)(rows > cols ? rows : cols);
+    uint32_t min_level = 2;
+    while (((uint64_t)1 << (min_level - 1)) < extent) ++min_level;
+
+    // Power-of-two boards make every large universe a handful of shared nodes, so any jump is cheap.
+    // Other sizes build O(board) nodes per extra level, so their jumps are kept near the board size.
+    const int pow2 = (rows & (rows - 1)) == 0 && (cols & (cols - 1)) == 0;
+    const int max_step = pow2 ? HL_MAX_LEVEL - 2 : (int)min_level;
+
+    hl->grid = grid;
+    hl->rows = rows;
+    hl->cols = cols;
+
+    uint64_t remaining = generations;
+    while (remaining > 0) {
+        int j = 63;
+        while (((remaining >> j) & 1u) == 0) --j;
+        if (j > max_step) j = max_step;
+        const uint32_t level = ((uint32_t)j + 2 > min_level) ? (uint32_t)j + 2 : min_level;
+
+        // Start from a clean arena when the previous jumps left too many nodes behind.
+        if (hl->count > HL_RESET_NODES) hl_reset(hl);
+        if (hl_build_reset(hl) != 0) return -1;
+
+        const uint32_t universe = hl_build_periodic(hl, level, 0, 0);
+        const uint32_t result = hl_successor(hl, universe, j);
+        if (hl->oom) return -1;
+
+        // The result starts 2^(level-2) cells into the universe; map it back onto the torus.
+        const uint64_t quarter = (uint64_t)1 << (level - 2);
+        hl_empty(hl, level - 1);
+        memset(grid, 0, (size_t)rows * (size_t)cols);
+        hl_blit(hl, result, level - 1, 0, 0, quarter % (uint64_t)rows, quarter % (uint64_t)cols, grid);
+        if (hl->oom) return -1;
+
+        remaining -= (uint64_t)1 << j;
+    }
+
+    return 0;
+}
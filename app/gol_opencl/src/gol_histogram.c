@@ -0,0 +1,69 @@
+#include "../include/gol_histogram.h"
+
+#include <string.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Index of the highest set bit of a non-zero value.
+static unsigned highest_bit(uint64_t v) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse64(&index, v);
+    return (unsigned)index;
+#else
+    return 63u - (unsigned)__builtin_clzll(v);
+#endif
+}
+
+// Values below GOL_HIST_SUB_COUNT map to themselves; larger ones to their
+// power of two times GOL_HIST_SUB_COUNT plus the next GOL_HIST_SUB_BITS bits.
+static unsigned bucket_of(uint64_t v) {
+    if (v < GOL_HIST_SUB_COUNT) return (unsigned)v;
+    const unsigned shift = highest_bit(v) - GOL_HIST_SUB_BITS;
+    return GOL_HIST_SUB_COUNT * (shift + 1u) + (unsigned)(v >> shift) - GOL_HIST_SUB_COUNT;
+}
+
+// Largest value that falls into a bucket.
+static uint64_t bucket_upper(unsigned b) {
+    if (b < GOL_HIST_SUB_COUNT) return b;
+    const unsigned shift = b / GOL_HIST_SUB_COUNT - 1u;
+    const uint64_t mantissa = GOL_HIST_SUB_COUNT + b % GOL_HIST_SUB_COUNT;
+    return ((mantissa + 1u) << shift) - 1u;
+}
+
+void gol_hist_reset(GolHistogram* h) {
+    memset(h, 0, sizeof(*h));
+    h->min = UINT64_MAX;
+}
+
+void gol_hist_record(GolHistogram* h, uint64_t value, uint64_t count) {
+    h->counts[bucket_of(value)] += count;
+    h->total += count;
+    if (value < h->min) h->min = value;
+    if (value > h->max) h->max = value;
+}
+
+uint64_t gol_hist_quantile(const GolHistogram* h, double q) {
+    if (h->total == 0) return 0;
+    if (q <= 0.0) return h->min;
+    if (q >= 1.0) return h->max;
+
+    // Nearest rank: the smallest value with at least q * total values at or below it.
+    uint64_t rank = (uint64_t)(q * (double)h->total);
+    if ((double)rank < q * (double)h->total) ++rank;
+    if (rank == 0) rank = 1;
+
+    uint64_t seen = 0;
+    for (unsigned b = 0; b < GOL_HIST_BUCKETS; ++b) {
+        seen += h->counts[b];
+        if (seen >= rank) {
+            uint64_t v = bucket_upper(b);
+            if (v > h->max) v = h->max;
+            if (v < h->min) v = h->min;
+            return v;
+        }
+    }
+    return h->max;
+}
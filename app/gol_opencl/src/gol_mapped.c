@@ -0,0 +1,181 @@
+#include "../include/gol_mapped.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+int gol_map_file(GolMappedFile* m, const char* path, size_t size) {
+    memset(m, 0, sizeof(*m));
+    if (size == 0) return -1;
+
+    // Temporary boards live next to the other temp files and vanish with the handle.
+    char tmp_path[MAX_PATH];
+    DWORD flags = FILE_ATTRIBUTE_NORMAL;
+    if (!path) {
+        char tmp_dir[MAX_PATH];
+        if (!GetTempPathA(MAX_PATH, tmp_dir) || !GetTempFileNameA(tmp_dir, "gol", 0, tmp_path)) return -1;
+        path = tmp_path;
+        flags = FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE;
+    }
+
+    HANDLE file = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, 0, NULL, OPEN_ALWAYS, flags, NULL);
+    if (file == INVALID_HANDLE_VALUE) return -1;
+
+    LARGE_INTEGER li;
+    li.QuadPart = (LONGLONG)size;
+    if (!SetFilePointerEx(file, li, NULL, FILE_BEGIN) || !SetEndOfFile(file)) {
+        CloseHandle(file);
+        return -1;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READWRITE, (DWORD)((unsigned long long)size >> 32), (DWORD)size, NULL);
+    if (!mapping) {
+        CloseHandle(file);
+        return -1;
+    }
+
+    void* data = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (!data) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return -1;
+    }
+
+    m->data = (unsigned char*)data;
+    m->size = size;
+    m->file = file;
+    m->mapping = mapping;
+    return 0;
+}
+
+int gol_map_file_private(GolMappedFile* m, const char* path) {
+    memset(m, 0, sizeof(*m));
+
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return -1;
+
+    LARGE_INTEGER li;
+    if (!GetFileSizeEx(file, &li) || li.QuadPart == 0) {
+        CloseHandle(file);
+        return -1;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+    if (!mapping) {
+        CloseHandle(file);
+        return -1;
+    }
+
+    void* data = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+    if (!data) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return -1;
+    }
+
+    m->data = (unsigned char*)data;
+    m->size = (size_t)li.QuadPart;
+    m->file = file;
+    m->mapping = mapping;
+    return 0;
+}
+
+void gol_map_advise_sequential(GolMappedFile* m) {
+    (void)m;
+}
+
+void gol_unmap_file(GolMappedFile* m) {
+    if (m->data) {
+        FlushViewOfFile(m->data, 0);
+        UnmapViewOfFile(m->data);
+    }
+    if (m->mapping) CloseHandle((HANDLE)m->mapping);
+    if (m->file) CloseHandle((HANDLE)m->file);
+    memset(m, 0, sizeof(*m));
+}
+
+#else
+
+int gol_map_file(GolMappedFile* m, const char* path, size_t size) {
+    memset(m, 0, sizeof(*m));
+    m->fd = -1;
+    if (size == 0) return -1;
+
+    int fd;
+    if (path) {
+        fd = open(path, O_RDWR | O_CREAT, 0644);
+    } else {
+        // Unlink the temporary file right away; the mapping keeps it alive until close.
+        const char* dir = getenv("TMPDIR");
+        char tmp_path[4096];
+        snprintf(tmp_path, sizeof(tmp_path), "%s/gol_board_XXXXXX", (dir && *dir) ? dir : "/tmp");
+        fd = mkstemp(tmp_path);
+        if (fd >= 0) unlink(tmp_path);
+    }
+    if (fd < 0) return -1;
+
+    if (ftruncate(fd, (off_t)size) != 0) {
+        close(fd);
+        return -1;
+    }
+
+    void* data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED) {
+        close(fd);
+        return -1;
+    }
+
+    m->data = (unsigned char*)data;
+    m->size = size;
+    m->fd = fd;
+    return 0;
+}
+
+int gol_map_file_private(GolMappedFile* m, const char* path) {
+    memset(m, 0, sizeof(*m));
+    m->fd = -1;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return -1;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return -1;
+    }
+
+    void* data = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+        close(fd);
+        return -1;
+    }
+
+    m->data = (unsigned char*)data;
+    m->size = (size_t)st.st_size;
+    m->fd = fd;
+    return 0;
+}
+
+void gol_map_advise_sequential(GolMappedFile* m) {
+    if (m->data) madvise(m->data, m->size, MADV_SEQUENTIAL);
+}
+
+void gol_unmap_file(GolMappedFile* m) {
+    if (m->data) munmap(m->data, m->size);
+    if (m->fd >= 0) close(m->fd);
+    memset(m, 0, sizeof(*m));
+    m->fd = -1;
+}
+
+#endif
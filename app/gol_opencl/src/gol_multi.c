@@ -0,0 +1,438 @@
+#include "../include/gol_multi.h"
+#include "../include/gol_rule.h"
+#include "../include/kernel_loader.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// One device of the multi-device mode together with the horizontal strip it owns.
+typedef struct StripDevice {
+    cl_device_id device;
+    int is_sub;
+    char name[256];
+    cl_context context;
+    cl_command_queue compute_q;
+    cl_command_queue copy_q;
+    cl_program program;
+    cl_kernel edge_kernels[2];     // rows 1 and strip_rows, per buffer parity
+    cl_kernel interior_kernels[2]; // rows 2 .. strip_rows - 1, per buffer parity
+    cl_mem buf[2];
+    int row0;                      // first board row owned by the strip
+    int strip_rows;                // number of owned rows
+    unsigned char* edge_rows[2];   // first and last owned row of the newest generation, per parity
+    cl_event halo_ready[2];        // halo writes the next edge kernel has to wait for
+    cl_uint n_halo_ready;
+    cl_event pending_kernel;       // interior kernel of the previous generation, not yet profiled
+    cl_event pending_copies[2];    // halo writes of the previous generation, not yet profiled
+    cl_uint n_pending_copies;
+    cl_ulong kernel_ns;
+    cl_ulong halo_ns;
+} StripDevice;
+
+
+/*
+ * Choose the devices for the strips: the first `wanted` root devices (GPUs first),
+ * or, when there are not enough of them or split is requested, `wanted` equal
+ * sub-devices of the first device that can be partitioned that way.
+ */
+static int pick_strip_devices(StripDevice* devs, int wanted, int split) {
+    cl_int err;
+    cl_uint n_platforms = 0;
+    err = clGetPlatformIDs(0, NULL, &n_platforms);
+    if (err != CL_SUCCESS || n_platforms == 0) gol_die_cl("clGetPlatformIDs(count)", err);
+
+    cl_platform_id* plats = (cl_platform_id*)calloc(n_platforms, sizeof(cl_platform_id));
+    if (!plats) {
+        fprintf(stderr, "Platform allocation failed.\n");
+        exit(1);
+    }
+    err = clGetPlatformIDs(n_platforms, plats, NULL);
+    if (err != CL_SUCCESS) gol_die_cl("clGetPlatformIDs(list)", err);
+
+    // Collect GPU devices of every platform first, then CPU devices, like gol_pick_device.
+    cl_device_id found[GOL_MULTI_MAX_DEVICES];
+    int n_found = 0;
+    const cl_device_type types[2] = { CL_DEVICE_TYPE_GPU, CL_DEVICE_TYPE_CPU };
+    for (int ti = 0; ti < 2; ++ti) {
+        for (cl_uint p = 0; p < n_platforms && n_found < GOL_MULTI_MAX_DEVICES; ++p) {
+            cl_uint n_dev = 0;
+            err = clGetDeviceIDs(plats[p], types[ti], 0, NULL, &n_dev);
+            if (err != CL_SUCCESS || n_dev == 0) continue;
+            if (n_dev > (cl_uint)(GOL_MULTI_MAX_DEVICES - n_found)) n_dev = (cl_uint)(GOL_MULTI_MAX_DEVICES - n_found);
+            err = clGetDeviceIDs(plats[p], types[ti], n_dev, found + n_found, NULL);
+            if (err == CL_SUCCESS) n_found += (int)n_dev;
+        }
+    }
+    free(plats);
+
+    int n = 0;
+    if (!split && n_found >= wanted) {
+        for (; n < wanted; ++n) {
+            devs[n].device = found[n];
+            devs[n].is_sub = 0;
+        }
+    } else {
+        // Partition the first device that offers enough compute units for `wanted` equal parts.
+        for (int i = 0; i < n_found && n == 0; ++i) {
+            cl_uint max_sub = 0;
+            cl_uint cu = 0;
+            clGetDeviceInfo(found[i], CL_DEVICE_PARTITION_MAX_SUB_DEVICES, sizeof(max_sub), &max_sub, NULL);
+            clGetDeviceInfo(found[i], CL_DEVICE_MAX_COMPUTE_UNITS, sizeof(cu), &cu, NULL);
+            if (max_sub < (cl_uint)wanted || cu < (cl_uint)wanted) continue;
+
+            const cl_device_partition_property props[] = {
+                CL_DEVICE_PARTITION_EQUALLY, (cl_device_partition_property)(cu / (cl_uint)wanted), 0
+            };
+            cl_uint n_sub = 0;
+            err = clCreateSubDevices(found[i], props, 0, NULL, &n_sub);
+            if (err != CL_SUCCESS || n_sub < (cl_uint)wanted) continue;
+
+            cl_device_id* subs = (cl_device_id*)calloc(n_sub, sizeof(cl_device_id));
+            if (!subs) {
+                fprintf(stderr, "Sub-device allocation failed.\n");
+                exit(1);
+            }
+            err = clCreateSubDevices(found[i], props, n_sub, subs, NULL);
+            if (err != CL_SUCCESS) gol_die_cl("clCreateSubDevices", err);
+
+            // Integer division can leave a few spare compute units as extra sub-devices.
+            for (cl_uint s = 0; s < n_sub; ++s) {
+                if ((int)s < wanted) {
+                    devs[n].device = subs[s];
+                    devs[n].is_sub = 1;
+                    ++n;
+                } else {
+                    clReleaseDevice(subs[s]);
+                }
+            }
+            free(subs);
+        }
+    }
+
+    if (n < wanted) {
+        fprintf(stderr, "Found %d OpenCL device(s); none could be split into %d sub-devices.\n", n_found, wanted);
+        exit(1);
+    }
+
+    for (int d = 0; d < n; ++d) {
+        clGetDeviceInfo(devs[d].device, CL_DEVICE_NAME, sizeof(devs[d].name), devs[d].name, NULL);
+    }
+    return n;
+}
+
+// Bind the arguments of one strip kernel: rows row_begin + i * row_stride for i < row_count.
+static cl_int set_strip_args(cl_kernel kernel, cl_mem cur, cl_mem next, int cols, int wrap,
+                             int row_begin, int row_stride, int row_count)
+{
+    cl_int err;
+    err  = clSetKernelArg(kernel, 0, sizeof(cl_mem), &cur);
+    err |= clSetKernelArg(kernel, 1, sizeof(cl_mem), &next);
+    err |= clSetKernelArg(kernel, 2, sizeof(int), &cols);
+    err |= clSetKernelArg(kernel, 3, sizeof(int), &wrap);
+    err |= clSetKernelArg(kernel, 4, sizeof(int), &row_begin);
+    err |= clSetKernelArg(kernel, 5, sizeof(int), &row_stride);
+    err |= clSetKernelArg(kernel, 6, sizeof(int), &row_count);
+    return err;
+}
+
+// Add the profiled times of finished strip commands to the device totals and release them.
+static void collect_strip_events(StripDevice* dev, const cl_event* kernels, cl_uint n_kernels,
+                                 const cl_event* copies, cl_uint n_copies)
+{
+    for (cl_uint k = 0; k < n_kernels; ++k) {
+        dev->kernel_ns += gol_event_ns(kernels[k]);
+        clReleaseEvent(kernels[k]);
+    }
+    for (cl_uint k = 0; k < n_copies; ++k) {
+        dev->halo_ns += gol_event_ns(copies[k]);
+        clReleaseEvent(copies[k]);
+    }
+}
+
+/*
+ * Split the board into horizontal strips, one per device, and run all generations.
+ * Every generation first computes the two edge rows of each strip, reads them back
+ * on a separate copy queue while the interior rows are computed, and then writes
+ * them into the halo rows of the neighboring strips. Devices may live on different
+ * platforms, so each has its own context and the halos travel through host memory.
+ */
+void gol_multi_run(const unsigned char* initial,
+                   unsigned char* result,
+                   int rows,
+                   int cols,
+                   int iters,
+                   int wrap,
+                   uint32_t rule,
+                   int wanted,
+                   int split,
+                   size_t lx,
+                   size_t ly,
+                   int repeat,
+                   int warmup,
+                   const char* kernel_dir,
+                   const char* kernel_cache,
+                   GolMultiStats* stats)
+{
+    cl_int err;
+    GolBuildStats build = {0, 0, 0.0, 0};
+    StripDevice devs[GOL_MULTI_MAX_DEVICES];
+    memset(devs, 0, sizeof(devs));
+    const int n_dev = pick_strip_devices(devs, wanted, split);
+    const size_t pitch = (size_t)cols;
+
+    int loader_err = 0;
+    char* src = load_kernel("gol_strip.cl", kernel_dir, &loader_err);
+    if (loader_err != 0 || !src) {
+        gol_print_kernel_load_error("gol_strip.cl", kernel_dir, loader_err);
+        exit(1);
+    }
+    char build_options[64];
+    gol_rule_build_options(rule, 2, build_options, sizeof(build_options));
+
+    // Near-equal strips; the first rows % n_dev strips get one extra row.
+    for (int d = 0; d < n_dev; ++d) {
+        StripDevice* dev = &devs[d];
+        const int base = rows / n_dev;
+        const int extra = rows % n_dev;
+        dev->row0 = d * base + (d < extra ? d : extra);
+        dev->strip_rows = base + (d < extra ? 1 : 0);
+        printf("Strip %d: rows [%d, %d) on ", d, dev->row0, dev->row0 + dev->strip_rows);
+        gol_print_device_info(dev->device);
+
+        char why[160];
+        if (!gol_local_size_fits(dev->device, NULL, lx, ly, 0, 1, why, sizeof(why))) {
+            fprintf(stderr, "Device %s: %s\n", dev->name, why);
+            exit(1);
+        }
+
+        dev->context = clCreateContext(NULL, 1, &dev->device, NULL, NULL, &err);
+        if (!dev->context || err != CL_SUCCESS) gol_die_cl("clCreateContext", err);
+
+        // Kernels and halo copies go to separate in-order queues so they can overlap.
+        const cl_queue_properties props[] = { CL_QUEUE_PROPERTIES, (cl_queue_properties)CL_QUEUE_PROFILING_ENABLE, 0 };
+        dev->compute_q = clCreateCommandQueueWithProperties(dev->context, dev->device, props, &err);
+        if (!dev->compute_q || err != CL_SUCCESS) gol_die_cl("clCreateCommandQueueWithProperties(compute)", err);
+        dev->copy_q = clCreateCommandQueueWithProperties(dev->context, dev->device, props, &err);
+        if (!dev->copy_q || err != CL_SUCCESS) gol_die_cl("clCreateCommandQueueWithProperties(copy)", err);
+
+        dev->program = gol_build_program(dev->context, dev->device, src, build_options,
+                                             kernel_cache, &build, &err);
+        if (!dev->program) gol_die_cl("clBuildProgram", err);
+
+        // Each strip buffer holds the owned rows between one halo row above and one below.
+        const size_t strip_bytes = ((size_t)dev->strip_rows + 2) * pitch;
+        for (int b = 0; b < 2; ++b) {
+            dev->buf[b] = clCreateBuffer(dev->context, CL_MEM_READ_WRITE, strip_bytes, NULL, &err);
+            if (!dev->buf[b] || err != CL_SUCCESS) gol_die_cl("clCreateBuffer(strip)", err);
+            dev->edge_rows[b] = (unsigned char*)malloc(2 * pitch);
+            if (!dev->edge_rows[b]) {
+                fprintf(stderr, "Host allocation failed (edge rows)\n");
+                exit(1);
+            }
+        }
+
+        // A one-row strip has a single edge row and no interior.
+        const int L = dev->strip_rows;
+        for (int b = 0; b < 2; ++b) {
+            dev->edge_kernels[b] = clCreateKernel(dev->program, "gol_step_strip", &err);
+            if (!dev->edge_kernels[b] || err != CL_SUCCESS) gol_die_cl("clCreateKernel(edge)", err);
+            err = set_strip_args(dev->edge_kernels[b], dev->buf[b], dev->buf[b ^ 1], cols, wrap,
+                                 1, L > 1 ? L - 1 : 1, L > 1 ? 2 : 1);
+            if (err != CL_SUCCESS) gol_die_cl("clSetKernelArg(edge)", err);
+
+            if (L > 2) {
+                dev->interior_kernels[b] = clCreateKernel(dev->program, "gol_step_strip", &err);
+                if (!dev->interior_kernels[b] || err != CL_SUCCESS) gol_die_cl("clCreateKernel(interior)", err);
+                err = set_strip_args(dev->interior_kernels[b], dev->buf[b], dev->buf[b ^ 1], cols, wrap, 2, 1, L - 2);
+                if (err != CL_SUCCESS) gol_die_cl("clSetKernelArg(interior)", err);
+            }
+        }
+    }
+    free(src);
+
+    memset(stats, 0, sizeof(*stats));
+    stats->n_devices = n_dev;
+    stats->build = build;
+
+    for (int run = 0; run < warmup + repeat; ++run) {
+        cl_ulong h2d_ns = 0, d2h_ns = 0;
+        double wall_start_ms = gol_now_ms();
+
+        // Upload every strip with its initial halos; halos outside a bounded board stay zero.
+        cl_event ev_up[GOL_MULTI_MAX_DEVICES][3];
+        cl_uint n_up[GOL_MULTI_MAX_DEVICES];
+        for (int d = 0; d < n_dev; ++d) {
+            StripDevice* dev = &devs[d];
+            const cl_uchar zero = 0;
+            const size_t strip_bytes = ((size_t)dev->strip_rows + 2) * pitch;
+            cl_event* ev = ev_up[d];
+            cl_uint n_ev = 0;
+            err  = clEnqueueFillBuffer(dev->copy_q, dev->buf[0], &zero, 1, 0, strip_bytes, 0, NULL, NULL);
+            err |= clEnqueueFillBuffer(dev->copy_q, dev->buf[1], &zero, 1, 0, strip_bytes, 0, NULL, NULL);
+            err |= clEnqueueWriteBuffer(dev->copy_q, dev->buf[0], CL_FALSE, pitch, (size_t)dev->strip_rows * pitch,
+                                        initial + (size_t)dev->row0 * pitch, 0, NULL, &ev[n_ev++]);
+            if (wrap || dev->row0 > 0) {
+                const int above = (dev->row0 + rows - 1) % rows;
+                err |= clEnqueueWriteBuffer(dev->copy_q, dev->buf[0], CL_FALSE, 0, pitch,
+                                            initial + (size_t)above * pitch, 0, NULL, &ev[n_ev++]);
+            }
+            if (wrap || dev->row0 + dev->strip_rows < rows) {
+                const int below = (dev->row0 + dev->strip_rows) % rows;
+                err |= clEnqueueWriteBuffer(dev->copy_q, dev->buf[0], CL_FALSE, ((size_t)dev->strip_rows + 1) * pitch, pitch,
+                                            initial + (size_t)below * pitch, 0, NULL, &ev[n_ev++]);
+            }
+            if (err != CL_SUCCESS) gol_die_cl("clEnqueueWriteBuffer(strip)", err);
+
+            // The first edge kernel waits for the upload through a marker on the copy queue.
+            err = clEnqueueMarkerWithWaitList(dev->copy_q, n_ev, ev, &dev->halo_ready[0]);
+            if (err != CL_SUCCESS) gol_die_cl("clEnqueueMarkerWithWaitList", err);
+            dev->n_halo_ready = 1;
+            clFlush(dev->copy_q);
+            n_up[d] = n_ev;
+            dev->kernel_ns = 0;
+            dev->halo_ns = 0;
+        }
+        for (int d = 0; d < n_dev; ++d) {
+            clWaitForEvents(n_up[d], ev_up[d]);
+            for (cl_uint k = 0; k < n_up[d]; ++k) {
+                h2d_ns += gol_event_ns(ev_up[d][k]);
+                clReleaseEvent(ev_up[d][k]);
+            }
+        }
+
+        for (int t = 0; t < iters; ++t) {
+            const int par = t & 1;
+            cl_event ev_edge[GOL_MULTI_MAX_DEVICES];
+            cl_event ev_interior[GOL_MULTI_MAX_DEVICES];
+            cl_event ev_read[GOL_MULTI_MAX_DEVICES][2];
+            cl_uint n_read[GOL_MULTI_MAX_DEVICES];
+
+            // Edge rows first, then their readback on the copy queue alongside the interior kernel.
+            for (int d = 0; d < n_dev; ++d) {
+                StripDevice* dev = &devs[d];
+                const int L = dev->strip_rows;
+                const size_t edge_global[2] = { gol_round_up(L > 1 ? 2u : 1u, lx), gol_round_up((size_t)cols, ly) };
+                const size_t local[2] = { lx, ly };
+
+                err = clEnqueueNDRangeKernel(dev->compute_q, dev->edge_kernels[par], 2, NULL, edge_global, local,
+                                             dev->n_halo_ready, dev->halo_ready, &ev_edge[d]);
+                if (err != CL_SUCCESS) gol_die_cl("clEnqueueNDRangeKernel(edge)", err);
+                for (cl_uint k = 0; k < dev->n_halo_ready; ++k) clReleaseEvent(dev->halo_ready[k]);
+                dev->n_halo_ready = 0;
+
+                cl_mem next = dev->buf[par ^ 1];
+                n_read[d] = 0;
+                err = clEnqueueReadBuffer(dev->copy_q, next, CL_FALSE, pitch, pitch, dev->edge_rows[par],
+                                          1, &ev_edge[d], &ev_read[d][n_read[d]++]);
+                if (L > 1) {
+                    err |= clEnqueueReadBuffer(dev->copy_q, next, CL_FALSE, (size_t)L * pitch, pitch, dev->edge_rows[par] + pitch,
+                                               1, &ev_edge[d], &ev_read[d][n_read[d]++]);
+                }
+                if (err != CL_SUCCESS) gol_die_cl("clEnqueueReadBuffer(edge)", err);
+                clFlush(dev->copy_q);
+
+                ev_interior[d] = NULL;
+                if (L > 2) {
+                    const size_t interior_global[2] = { gol_round_up((size_t)L - 2, lx), gol_round_up((size_t)cols, ly) };
+                    err = clEnqueueNDRangeKernel(dev->compute_q, dev->interior_kernels[par], 2, NULL, interior_global, local,
+                                                 0, NULL, &ev_interior[d]);
+                    if (err != CL_SUCCESS) gol_die_cl("clEnqueueNDRangeKernel(interior)", err);
+                }
+                clFlush(dev->compute_q);
+            }
+
+            // Every strip's edge rows must be on the host before any halo is written.
+            for (int d = 0; d < n_dev; ++d) {
+                err = clWaitForEvents(n_read[d], ev_read[d]);
+                if (err != CL_SUCCESS) gol_die_cl("clWaitForEvents(edge)", err);
+            }
+
+            // Both in-order queues are now past the previous generation, so its interior
+            // kernel and halo writes have finished and can be profiled as well.
+            for (int d = 0; d < n_dev; ++d) {
+                StripDevice* dev = &devs[d];
+                collect_strip_events(dev, &ev_edge[d], 1, ev_read[d], n_read[d]);
+                collect_strip_events(dev, &dev->pending_kernel, dev->pending_kernel ? 1u : 0u,
+                                     dev->pending_copies, dev->n_pending_copies);
+                dev->pending_kernel = ev_interior[d];
+                dev->n_pending_copies = 0;
+            }
+
+            // Write the new edge rows into the halo rows of the neighbors' next buffers.
+            for (int d = 0; d < n_dev; ++d) {
+                StripDevice* dev = &devs[d];
+                cl_mem next = dev->buf[par ^ 1];
+                if (wrap || d > 0) {
+                    const StripDevice* up = &devs[(d + n_dev - 1) % n_dev];
+                    const unsigned char* last_row = up->edge_rows[par] + (up->strip_rows > 1 ? pitch : 0);
+                    err = clEnqueueWriteBuffer(dev->copy_q, next, CL_FALSE, 0, pitch, last_row,
+                                               0, NULL, &dev->halo_ready[dev->n_halo_ready]);
+                    if (err != CL_SUCCESS) gol_die_cl("clEnqueueWriteBuffer(halo)", err);
+                    clRetainEvent(dev->halo_ready[dev->n_halo_ready]);
+                    dev->pending_copies[dev->n_pending_copies++] = dev->halo_ready[dev->n_halo_ready++];
+                }
+                if (wrap || d < n_dev - 1) {
+                    const StripDevice* down = &devs[(d + 1) % n_dev];
+                    err = clEnqueueWriteBuffer(dev->copy_q, next, CL_FALSE, ((size_t)dev->strip_rows + 1) * pitch, pitch,
+                                               down->edge_rows[par], 0, NULL, &dev->halo_ready[dev->n_halo_ready]);
+                    if (err != CL_SUCCESS) gol_die_cl("clEnqueueWriteBuffer(halo)", err);
+                    clRetainEvent(dev->halo_ready[dev->n_halo_ready]);
+                    dev->pending_copies[dev->n_pending_copies++] = dev->halo_ready[dev->n_halo_ready++];
+                }
+                clFlush(dev->copy_q);
+            }
+        }
+
+        // Read the owned rows of every strip back into the board.
+        const int final_par = iters & 1;
+        for (int d = 0; d < n_dev; ++d) {
+            StripDevice* dev = &devs[d];
+            cl_event ev_d2h;
+            err = clEnqueueReadBuffer(dev->compute_q, dev->buf[final_par], CL_FALSE, pitch, (size_t)dev->strip_rows * pitch,
+                                      result + (size_t)dev->row0 * pitch, dev->n_halo_ready, dev->halo_ready, &ev_d2h);
+            if (err != CL_SUCCESS) gol_die_cl("clEnqueueReadBuffer(strip)", err);
+            err  = clFinish(dev->compute_q);
+            err |= clFinish(dev->copy_q);
+            if (err != CL_SUCCESS) gol_die_cl("clFinish", err);
+
+            d2h_ns += gol_event_ns(ev_d2h);
+            clReleaseEvent(ev_d2h);
+            for (cl_uint k = 0; k < dev->n_halo_ready; ++k) clReleaseEvent(dev->halo_ready[k]);
+            dev->n_halo_ready = 0;
+
+            // The last generation's interior kernel and halo writes finished with the queues.
+            collect_strip_events(dev, &dev->pending_kernel, dev->pending_kernel ? 1u : 0u,
+                                 dev->pending_copies, dev->n_pending_copies);
+            dev->pending_kernel = NULL;
+            dev->n_pending_copies = 0;
+        }
+
+        double wall_total_ms = gol_now_ms() - wall_start_ms;
+        if (run >= warmup) {
+            stats->h2d_ms += (double)h2d_ns / 1e6 / (double)repeat;
+            stats->d2h_ms += (double)d2h_ns / 1e6 / (double)repeat;
+            stats->wall_total_ms += wall_total_ms / (double)repeat;
+            for (int d = 0; d < n_dev; ++d) {
+                stats->kernel_ms[d] += (double)devs[d].kernel_ns / 1e6 / (double)repeat;
+                stats->halo_ms += (double)devs[d].halo_ns / 1e6 / (double)repeat;
+            }
+        }
+    }
+
+    // Release the per-device objects.
+    for (int d = 0; d < n_dev; ++d) {
+        StripDevice* dev = &devs[d];
+        for (int b = 0; b < 2; ++b) {
+            clReleaseKernel(dev->edge_kernels[b]);
+            if (dev->interior_kernels[b]) clReleaseKernel(dev->interior_kernels[b]);
+            clReleaseMemObject(dev->buf[b]);
+            free(dev->edge_rows[b]);
+        }
+        clReleaseProgram(dev->program);
+        clReleaseCommandQueue(dev->copy_q);
+        clReleaseCommandQueue(dev->compute_q);
+        clReleaseContext(dev->context);
+        if (dev->is_sub) clReleaseDevice(dev->device);
+    }
+}
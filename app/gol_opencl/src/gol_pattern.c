@@ -0,0 +1,483 @@
+#include "../include/gol_pattern.h"
+#include "../include/gol_random.h"
+
+#include <ctype.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RLE_LINE_WIDTH 70
+
+const char* gol_pattern_format_name(GolPatternFormat format) {
+    switch (format) {
+        case GOL_FORMAT_RLE: return "RLE";
+        case GOL_FORMAT_LIFE106: return "Life 1.06";
+        case GOL_FORMAT_PLAINTEXT: return "plaintext";
+        case GOL_FORMAT_SNAPSHOT: return "snapshot";
+        default: return "unknown";
+    }
+}
+
+const char* gol_pattern_error_string(int code) {
+    switch (code) {
+        case 0: return "success";
+        case -1: return "file open / read / write error";
+        case -2: return "malformed pattern file";
+        case -3: return "pattern is larger than the board";
+        case -4: return "invalid argument";
+        default: return "unknown error";
+    }
+}
+
+// Compare the extension of path (case-insensitive) with ext, which includes the dot.
+static int has_extension(const char* path, const char* ext) {
+    const char* dot = strrchr(path, '.');
+    if (!dot) return 0;
+    for (; *dot && *ext; ++dot, ++ext) {
+        if (tolower((unsigned char)*dot) != tolower((unsigned char)*ext)) return 0;
+    }
+    return *dot == 0 && *ext == 0;
+}
+
+GolPatternFormat gol_pattern_format_for_path(const char* path) {
+    if (has_extension(path, ".rle")) return GOL_FORMAT_RLE;
+    if (has_extension(path, ".lif") || has_extension(path, ".life")) return GOL_FORMAT_LIFE106;
+    if (has_extension(path, ".cells") || has_extension(path, ".txt")) return GOL_FORMAT_PLAINTEXT;
+    return GOL_FORMAT_SNAPSHOT;
+}
+
+GolPatternFormat gol_pattern_detect(const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return GOL_FORMAT_UNKNOWN;
+
+    char head[64];
+    size_t got = fread(head, 1, sizeof(head) - 1, f);
+    fclose(f);
+    head[got] = 0;
+
+    if (got >= 8 && memcmp(head, GOL_SNAPSHOT_MAGIC, 8) == 0) return GOL_FORMAT_SNAPSHOT;
+    if (strncmp(head, "#Life 1.06", 10) == 0) return GOL_FORMAT_LIFE106;
+    if (head[0] == '!' || head[0] == '.' || head[0] == 'O' || head[0] == '*') return GOL_FORMAT_PLAINTEXT;
+    // RLE files start with '#' comment lines or directly with the "x = .." header.
+    if (head[0] == '#' || head[0] == 'x') return GOL_FORMAT_RLE;
+    return GOL_FORMAT_UNKNOWN;
+}
+
+// Read one line into buf (truncated to size - 1, the rest is consumed); returns 0 at end of file.
+static int read_line(FILE* f, char* buf, size_t size) {
+    size_t len = 0;
+    int c;
+    while ((c = getc(f)) != EOF && c != '\n') {
+        if (len + 1 < size) buf[len++] = (char)c;
+    }
+    if (len > 0 && buf[len - 1] == '\r') --len;
+    buf[len] = 0;
+    return !(c == EOF && len == 0);
+}
+
+// Offset that centers a pattern extent inside the board extent.
+static int center_offset(int board, int pattern) {
+    return (board - pattern) / 2;
+}
+
+/* ---------- RLE ---------- */
+
+// Skip '#' comment lines and parse the "x = .., y = .., rule = .." header; the stream is left at the body.
+// The optional rule is copied into rule (if not NULL), otherwise rule is left empty.
+static int rle_read_header(FILE* f, int* rows, int* cols, char* rule, size_t rule_size) {
+    char line[512];
+    while (read_line(f, line, sizeof(line))) {
+        if (line[0] == '#' || line[0] == 0) continue;
+        int x = 0, y = 0;
+        if (sscanf(line, " x = %d , y = %d", &x, &y) != 2 || x < 0 || y < 0) return -2;
+        *rows = y;
+        *cols = x;
+        if (rule && rule_size > 0) {
+            rule[0] = 0;
+            const char* r = strstr(line, "rule");
+            if (r) {
+                r += 4;
+                while (*r == ' ' || *r == '=') ++r;
+                size_t len = strcspn(r, " ,:\t");  // stop before a ":T.." bounded-grid suffix
+                if (len >= rule_size) len = rule_size - 1;
+                memcpy(rule, r, len);
+                rule[len] = 0;
+            }
+        }
+        return 0;
+    }
+    return -2;
+}
+
+// Decode the RLE body straight into the board, run by run.
+static int rle_read_body(FILE* f, unsigned char* grid, int rows, int cols, int off_r, int off_c) {
+    long long count = 0;
+    long long r = 0, c = 0;
+    int ch;
+
+    while ((ch = getc(f)) != EOF) {
+        if (isdigit(ch)) {
+            count = count * 10 + (ch - '0');
+            if (count > INT_MAX) return -2;
+            continue;
+        }
+        const long long n = count ? count : 1;
+        count = 0;
+
+        if (ch == '!') return 0;
+        if (ch == '$') {
+            r += n;
+            c = 0;
+        } else if (ch == 'b' || ch == '.') {
+            c += n;
+        } else if (isalpha(ch) || ch == '*') {
+            // Any other state letter counts as alive.
+            if (off_r + r >= rows || off_c + c + n > cols) return -3;
+            memset(grid + (size_t)(off_r + r) * (size_t)cols + (size_t)(off_c + c), 1, (size_t)n);
+            c += n;
+        } else if (ch == '#') {
+            char skip[256];
+            read_line(f, skip, sizeof(skip));
+        } else if (!isspace(ch)) {
+            return -2;
+        }
+    }
+    // A missing '!' terminator is tolerated.
+    return 0;
+}
+
+// Write one RLE token, wrapping lines at RLE_LINE_WIDTH characters.
+static int rle_put(FILE* f, long long n, char tag, int* line_len) {
+    char token[32];
+    int len = (n > 1) ? snprintf(token, sizeof(token), "%lld%c", n, tag) : snprintf(token, sizeof(token), "%c", tag);
+    if (*line_len + len > RLE_LINE_WIDTH) {
+        if (fputc('\n', f) == EOF) return -1;
+        *line_len = 0;
+    }
+    *line_len += len;
+    return fputs(token, f) == EOF ? -1 : 0;
+}
+
+static int rle_write(FILE* f, const unsigned char* grid, int rows, int cols, const char* rule) {
+    if (fprintf(f, "x = %d, y = %d, rule = %s\n", cols, rows, rule) < 0) return -1;
+
+    int line_len = 0;
+    int last_row = 0;
+    for (int x = 0; x < rows; ++x) {
+        const unsigned char* row = grid + (size_t)x * (size_t)cols;
+        int last = cols - 1;
+        while (last >= 0 && !row[last]) --last;
+        if (last < 0) continue;
+
+        // Empty rows in between collapse into one end-of-row run; trailing dead cells are omitted.
+        if (x > last_row && rle_put(f, x - last_row, '$', &line_len) != 0) return -1;
+        last_row = x;
+
+        for (int y = 0; y <= last;) {
+            const unsigned char v = row[y] ? 1 : 0;
+            int run = 1;
+            while (y + run <= last && (row[y + run] ? 1 : 0) == v) ++run;
+            if (rle_put(f, run, v ? 'o' : 'b', &line_len) != 0) return -1;
+            y += run;
+        }
+    }
+    return fputs("!\n", f) == EOF ? -1 : 0;
+}
+
+/* ---------- Life 1.06 ---------- */
+
+// Visit every "x y" line after the header; with grid == NULL only the bounding box is computed.
+static int life106_scan(FILE* f, long long* min_x, long long* min_y, long long* max_x, long long* max_y,
+                        unsigned char* grid, int rows, int cols, long long shift_r, long long shift_c)
+{
+    char line[256];
+    int any = 0;
+    while (read_line(f, line, sizeof(line))) {
+        if (line[0] == '#' || line[0] == 0) continue;
+        long long x = 0, y = 0;
+        if (sscanf(line, "%lld %lld", &x, &y) != 2) return -2;
+        if (grid) {
+            const long long r = y + shift_r;
+            const long long c = x + shift_c;
+            if (r < 0 || r >= rows || c < 0 || c >= cols) return -3;
+            grid[(size_t)r * (size_t)cols + (size_t)c] = 1;
+        } else {
+            if (!any || x < *min_x) *min_x = x;
+            if (!any || y < *min_y) *min_y = y;
+            if (!any || x > *max_x) *max_x = x;
+            if (!any || y > *max_y) *max_y = y;
+        }
+        any = 1;
+    }
+    if (!grid && !any) {
+        // An empty pattern has an empty bounding box.
+        *min_x = *min_y = 0;
+        *max_x = *max_y = -1;
+    }
+    return 0;
+}
+
+static int life106_write(FILE* f, const unsigned char* grid, int rows, int cols) {
+    if (fputs("#Life 1.06\n", f) == EOF) return -1;
+    for (int x = 0; x < rows; ++x) {
+        const unsigned char* row = grid + (size_t)x * (size_t)cols;
+        for (int y = 0; y < cols; ++y) {
+            if (row[y] && fprintf(f, "%d %d\n", y, x) < 0) return -1;
+        }
+    }
+    return 0;
+}
+
+/* ---------- plaintext ---------- */
+
+// Count the board lines and the widest line, skipping '!' comments.
+static int plaintext_probe(FILE* f, int* rows, int* cols) {
+    long long n_rows = 0, width = 0, len = 0;
+    int comment = 0, at_start = 1;
+    int ch;
+    while ((ch = getc(f)) != EOF) {
+        if (at_start) {
+            comment = (ch == '!');
+            at_start = 0;
+        }
+        if (ch == '\n') {
+            if (!comment) {
+                ++n_rows;
+                if (len > width) width = len;
+            }
+            len = 0;
+            at_start = 1;
+            continue;
+        }
+        if (!comment && ch != '\r') ++len;
+    }
+    if (!at_start && !comment) {
+        ++n_rows;
+        if (len > width) width = len;
+    }
+    if (n_rows > INT_MAX || width > INT_MAX) return -2;
+    *rows = (int)n_rows;
+    *cols = (int)width;
+    return 0;
+}
+
+static int plaintext_read(FILE* f, unsigned char* grid, int rows, int cols, int off_r, int off_c) {
+    long long r = 0, c = 0;
+    int comment = 0, at_start = 1;
+    int ch;
+    while ((ch = getc(f)) != EOF) {
+        if (at_start) {
+            comment = (ch == '!');
+            at_start = 0;
+        }
+        if (ch == '\n') {
+            if (!comment) ++r;
+            c = 0;
+            at_start = 1;
+            continue;
+        }
+        if (comment || ch == '\r') continue;
+        if (ch == 'O' || ch == '*') {
+            if (off_r + r >= rows || off_c + c >= cols) return -3;
+            grid[(size_t)(off_r + r) * (size_t)cols + (size_t)(off_c + c)] = 1;
+        } else if (ch != '.') {
+            return -2;
+        }
+        ++c;
+    }
+    return 0;
+}
+
+static int plaintext_write(FILE* f, const unsigned char* grid, int rows, int cols, const GolSnapshotHeader* meta) {
+    if (meta && fprintf(f, "!Generation: %llu\n", (unsigned long long)meta->generation) < 0) return -1;
+
+    char* line = (char*)malloc((size_t)cols + 2);
+    if (!line) return -1;
+    for (int x = 0; x < rows; ++x) {
+        const unsigned char* row = grid + (size_t)x * (size_t)cols;
+        for (int y = 0; y < cols; ++y) line[y] = row[y] ? 'O' : '.';
+        line[cols] = '\n';
+        if (fwrite(line, 1, (size_t)cols + 1, f) != (size_t)cols + 1) {
+            free(line);
+            return -1;
+        }
+    }
+    free(line);
+    return 0;
+}
+
+/* ---------- snapshot ---------- */
+
+static int snapshot_read_header(FILE* f, GolSnapshotHeader* h) {
+    if (fread(h, sizeof(*h), 1, f) != 1) return -1;
+    if (memcmp(h->magic, GOL_SNAPSHOT_MAGIC, 8) != 0) return -2;
+    if (h->header_bytes < sizeof(*h) || h->rows == 0 || h->cols == 0 ||
+        h->rows > INT_MAX || h->cols > INT_MAX) return -2;
+    h->rule[sizeof(h->rule) - 1] = 0;
+    return 0;
+}
+
+// Read the snapshot cells row by row into the centered window of the board.
+static int snapshot_read(FILE* f, const GolSnapshotHeader* h, unsigned char* grid, int rows, int cols) {
+    const int prows = (int)h->rows;
+    const int pcols = (int)h->cols;
+    if (prows > rows || pcols > cols) return -3;
+    if (fseek(f, (long)h->header_bytes, SEEK_SET) != 0) return -1;
+
+    const int off_r = center_offset(rows, prows);
+    const int off_c = center_offset(cols, pcols);
+    for (int x = 0; x < prows; ++x) {
+        unsigned char* dst = grid + (size_t)(off_r + x) * (size_t)cols + (size_t)off_c;
+        if (fread(dst, 1, (size_t)pcols, f) != (size_t)pcols) return -1;
+    }
+    return 0;
+}
+
+static int snapshot_write(FILE* f, const unsigned char* grid, int rows, int cols, const GolSnapshotHeader* meta) {
+    // The header is padded to a full page so the cells can be mapped aligned.
+    unsigned char page[GOL_SNAPSHOT_HEADER_BYTES];
+    memset(page, 0, sizeof(page));
+
+    GolSnapshotHeader h;
+    if (meta) h = *meta;
+    else memset(&h, 0, sizeof(h));
+    memcpy(h.magic, GOL_SNAPSHOT_MAGIC, 8);
+    h.header_bytes = GOL_SNAPSHOT_HEADER_BYTES;
+    h.rows = (uint64_t)rows;
+    h.cols = (uint64_t)cols;
+    if (!h.rule[0]) strcpy(h.rule, "B3/S23");
+    memcpy(page, &h, sizeof(h));
+
+    if (fwrite(page, 1, sizeof(page), f) != sizeof(page)) return -1;
+    const size_t n = (size_t)rows * (size_t)cols;
+    return fwrite(grid, 1, n, f) == n ? 0 : -1;
+}
+
+/* ---------- public entry points ---------- */
+
+int gol_pattern_probe(const char* path, GolPatternFormat format, int* rows, int* cols, GolSnapshotHeader* header) {
+    if (!path || !rows || !cols) return -4;
+    FILE* f = fopen(path, "rb");
+    if (!f) return -1;
+
+    int rc = -4;
+    if (format == GOL_FORMAT_RLE) {
+        if (header) memset(header, 0, sizeof(*header));
+        rc = rle_read_header(f, rows, cols, header ? header->rule : NULL, header ? sizeof(header->rule) : 0);
+    } else if (format == GOL_FORMAT_LIFE106) {
+        long long min_x, min_y, max_x, max_y;
+        rc = life106_scan(f, &min_x, &min_y, &max_x, &max_y, NULL, 0, 0, 0, 0);
+        if (rc == 0 && (max_y - min_y + 1 > INT_MAX || max_x - min_x + 1 > INT_MAX)) rc = -3;
+        if (rc == 0) {
+            *rows = (int)(max_y - min_y + 1);
+            *cols = (int)(max_x - min_x + 1);
+        }
+    } else if (format == GOL_FORMAT_PLAINTEXT) {
+        rc = plaintext_probe(f, rows, cols);
+    } else if (format == GOL_FORMAT_SNAPSHOT) {
+        GolSnapshotHeader h;
+        rc = snapshot_read_header(f, &h);
+        if (rc == 0) {
+            *rows = (int)h.rows;
+            *cols = (int)h.cols;
+            if (header) *header = h;
+        }
+    }
+
+    fclose(f);
+    return rc;
+}
+
+int gol_pattern_load(const char* path, GolPatternFormat format, unsigned char* grid, int rows, int cols) {
+    if (!path || !grid || rows <= 0 || cols <= 0) return -4;
+
+    int prows = 0, pcols = 0;
+    GolSnapshotHeader h;
+    int rc = gol_pattern_probe(path, format, &prows, &pcols, &h);
+    if (rc != 0) return rc;
+    if (prows > rows || pcols > cols) return -3;
+
+    FILE* f = fopen(path, "rb");
+    if (!f) return -1;
+
+    memset(grid, 0, (size_t)rows * (size_t)cols);
+    const int off_r = center_offset(rows, prows);
+    const int off_c = center_offset(cols, pcols);
+
+    if (format == GOL_FORMAT_RLE) {
+        int hr = 0, hc = 0;
+        rc = rle_read_header(f, &hr, &hc, NULL, 0);
+        if (rc == 0) rc = rle_read_body(f, grid, rows, cols, off_r, off_c);
+    } else if (format == GOL_FORMAT_LIFE106) {
+        // The first pass found the bounding box; shift its corner to the centered offset.
+        long long min_x = 0, min_y = 0, max_x = 0, max_y = 0;
+        rc = life106_scan(f, &min_x, &min_y, &max_x, &max_y, NULL, 0, 0, 0, 0);
+        if (rc == 0 && fseek(f, 0, SEEK_SET) != 0) rc = -1;
+        if (rc == 0) rc = life106_scan(f, NULL, NULL, NULL, NULL, grid, rows, cols, off_r - min_y, off_c - min_x);
+    } else if (format == GOL_FORMAT_PLAINTEXT) {
+        rc = plaintext_read(f, grid, rows, cols, off_r, off_c);
+    } else if (format == GOL_FORMAT_SNAPSHOT) {
+        rc = snapshot_read(f, &h, grid, rows, cols);
+    } else {
+        rc = -4;
+    }
+
+    fclose(f);
+    return rc;
+}
+
+int gol_board_init(unsigned char* grid, int rows, int cols, unsigned int seed, double density,
+                   const char* path, GolPatternFormat format)
+{
+    if (!path) {
+        gol_random_fill(grid, (size_t)rows * (size_t)cols, seed, density, 0);
+        return 0;
+    }
+    return gol_pattern_load(path, format, grid, rows, cols);
+}
+
+int gol_pattern_save(const char* path, GolPatternFormat format,
+                     const unsigned char* grid, int rows, int cols,
+                     const GolSnapshotHeader* meta)
+{
+    if (!path || !grid || rows <= 0 || cols <= 0) return -4;
+    FILE* f = fopen(path, "wb");
+    if (!f) return -1;
+
+    int rc;
+    const char* rule = (meta && meta->rule[0]) ? meta->rule : "B3/S23";
+    switch (format) {
+        case GOL_FORMAT_RLE: rc = rle_write(f, grid, rows, cols, rule); break;
+        case GOL_FORMAT_LIFE106: rc = life106_write(f, grid, rows, cols); break;
+        case GOL_FORMAT_PLAINTEXT: rc = plaintext_write(f, grid, rows, cols, meta); break;
+        case GOL_FORMAT_SNAPSHOT: rc = snapshot_write(f, grid, rows, cols, meta); break;
+        default: rc = -4; break;
+    }
+
+    if (fclose(f) != 0 && rc == 0) rc = -1;
+    return rc;
+}
+
+int gol_snapshot_map(GolMappedFile* m, const char* path, GolSnapshotHeader* header, unsigned char** cells) {
+    if (!m || !path || !header || !cells) return -4;
+    if (gol_map_file_private(m, path) != 0) return -1;
+
+    GolSnapshotHeader h;
+    if (m->size < sizeof(h)) {
+        gol_unmap_file(m);
+        return -2;
+    }
+    memcpy(&h, m->data, sizeof(h));
+    if (memcmp(h.magic, GOL_SNAPSHOT_MAGIC, 8) != 0 || h.header_bytes < sizeof(h) ||
+        h.rows == 0 || h.cols == 0 || h.rows > INT_MAX || h.cols > INT_MAX ||
+        m->size < (size_t)h.header_bytes + (size_t)h.rows * (size_t)h.cols) {
+        gol_unmap_file(m);
+        return -2;
+    }
+    h.rule[sizeof(h.rule) - 1] = 0;
+
+    *header = h;
+    *cells = m->data + h.header_bytes;
+    return 0;
+}
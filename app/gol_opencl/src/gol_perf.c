@@ -0,0 +1,108 @@
+#include "../include/gol_perf.h"
+
+#include <string.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+static const char* const counter_names[GOL_PERF_COUNTERS] = {
+    "cycles", "instructions", "llc_misses", "branch_misses"
+};
+
+const char* gol_perf_name(int counter) {
+    return (counter >= 0 && counter < GOL_PERF_COUNTERS) ? counter_names[counter] : "?";
+}
+
+int gol_perf_has(const GolPerf* p, int counter) {
+    return p->available[counter];
+}
+
+#ifdef __linux__
+
+static const uint64_t counter_configs[GOL_PERF_COUNTERS] = {
+    PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+};
+
+// The group leader is the first counter that opened; the ioctls act on the whole group.
+static int leader_fd(const GolPerf* p) {
+    for (int i = 0; i < GOL_PERF_COUNTERS; ++i) {
+        if (p->fd[i] >= 0) return p->fd[i];
+    }
+    return -1;
+}
+
+int gol_perf_open(GolPerf* p, int inherit) {
+    memset(p, 0, sizeof(*p));
+    for (int i = 0; i < GOL_PERF_COUNTERS; ++i) p->fd[i] = -1;
+    int opened = 0;
+    for (int i = 0; i < GOL_PERF_COUNTERS; ++i) {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = counter_configs[i];
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        attr.disabled = opened == 0;   // siblings follow the leader
+        attr.inherit = inherit ? 1 : 0;
+
+        // Retry without kernel-space counting, which perf_event_paranoid 2 forbids.
+        const int group = leader_fd(p);
+        int fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, group, 0);
+        if (fd < 0) {
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, group, 0);
+        }
+        p->fd[i] = fd;
+        p->available[i] = fd >= 0;
+        if (fd >= 0) ++opened;
+    }
+    return opened;
+}
+
+void gol_perf_start(GolPerf* p) {
+    const int leader = leader_fd(p);
+    if (leader < 0) return;
+    ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+void gol_perf_stop(GolPerf* p) {
+    const int leader = leader_fd(p);
+    if (leader < 0) return;
+    ioctl(leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    for (int i = 0; i < GOL_PERF_COUNTERS; ++i) {
+        uint64_t data[3];   // value, time enabled, time running
+        if (p->fd[i] < 0 || read(p->fd[i], data, sizeof(data)) != (ssize_t)sizeof(data) || data[2] == 0) continue;
+        p->value[i] += (double)data[0] * ((double)data[1] / (double)data[2]);
+    }
+    ++p->intervals;
+}
+
+void gol_perf_close(GolPerf* p) {
+    // Close the siblings before the leader.
+    for (int i = GOL_PERF_COUNTERS - 1; i >= 0; --i) {
+        if (p->fd[i] >= 0) close(p->fd[i]);
+        p->fd[i] = -1;
+    }
+}
+
+#else
+
+int gol_perf_open(GolPerf* p, int inherit) {
+    (void)inherit;
+    memset(p, 0, sizeof(*p));
+    for (int i = 0; i < GOL_PERF_COUNTERS; ++i) p->fd[i] = -1;
+    return 0;
+}
+
+void gol_perf_start(GolPerf* p) { (void)p; }
+void gol_perf_stop(GolPerf* p) { ++p->intervals; }
+void gol_perf_close(GolPerf* p) { (void)p; }
+
+#endif
@@ -0,0 +1,158 @@
+#include "../include/gol_program_cache.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+#define GOL_PROGRAM_CACHE_MAGIC "GOLBIN01"
+
+typedef struct GolProgramCacheHeader {
+    char magic[8];   // GOL_PROGRAM_CACHE_MAGIC, not null-terminated
+    uint64_t key;
+    uint64_t size;   // bytes of program binary after the header
+} GolProgramCacheHeader;
+
+// FNV-1a over a byte range, continuing from hash.
+static uint64_t fnv1a(uint64_t hash, const void* data, size_t size) {
+    const unsigned char* p = (const unsigned char*)data;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= p[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+// Hash a string together with its terminator, so "ab" + "c" and "a" + "bc" differ.
+static uint64_t fnv1a_str(uint64_t hash, const char* s) {
+    return fnv1a(hash, s ? s : "", strlen(s ? s : "") + 1);
+}
+
+// Hash one string-valued device property.
+static uint64_t hash_device_info(uint64_t hash, cl_device_id device, cl_device_info param) {
+    char value[256] = "";
+    clGetDeviceInfo(device, param, sizeof(value) - 1, value, NULL);
+    return fnv1a_str(hash, value);
+}
+
+uint64_t gol_program_cache_key(cl_device_id device, const char* source, const char* options) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    hash = hash_device_info(hash, device, CL_DEVICE_NAME);
+    hash = hash_device_info(hash, device, CL_DEVICE_VERSION);
+    hash = hash_device_info(hash, device, CL_DRIVER_VERSION);
+    hash = fnv1a_str(hash, source);
+    hash = fnv1a_str(hash, options);
+    return hash;
+}
+
+// "<dir>/<key>.bin", with an optional suffix for the temporary file.
+static void entry_path(char* buf, size_t size, const char* dir, uint64_t key, const char* suffix) {
+    snprintf(buf, size, "%s/%016llx.bin%s", dir, (unsigned long long)key, suffix);
+}
+
+cl_program gol_program_cache_load(const char* dir, uint64_t key,
+                                  cl_context context, cl_device_id device, const char* options) {
+    char path[1024];
+    entry_path(path, sizeof(path), dir, key, "");
+    FILE* f = fopen(path, "rb");
+    if (!f) return NULL;
+
+    // A truncated file or a hash collision with an older layout counts as a miss.
+    GolProgramCacheHeader header;
+    unsigned char* binary = NULL;
+    if (fread(&header, sizeof(header), 1, f) != 1
+        || memcmp(header.magic, GOL_PROGRAM_CACHE_MAGIC, sizeof(header.magic)) != 0
+        || header.key != key || header.size == 0 || header.size > (uint64_t)(SIZE_MAX / 2)) {
+        fclose(f);
+        return NULL;
+    }
+    const size_t size = (size_t)header.size;
+    binary = (unsigned char*)malloc(size);
+    if (!binary || fread(binary, 1, size, f) != size) {
+        free(binary);
+        fclose(f);
+        return NULL;
+    }
+    fclose(f);
+
+    // Binaries still need clBuildProgram; the runtime may reject them after all.
+    cl_int status = CL_SUCCESS;
+    cl_int err = CL_SUCCESS;
+    const unsigned char* binaries[1] = { binary };
+    cl_program program = clCreateProgramWithBinary(context, 1, &device, &size, binaries, &status, &err);
+    free(binary);
+    if (!program || err != CL_SUCCESS || status != CL_SUCCESS) {
+        if (program) clReleaseProgram(program);
+        return NULL;
+    }
+    if (clBuildProgram(program, 1, &device, options, NULL, NULL) != CL_SUCCESS) {
+        clReleaseProgram(program);
+        return NULL;
+    }
+    return program;
+}
+
+// Create the cache directory; an existing one is fine.
+static int make_dir(const char* dir) {
+#ifdef _WIN32
+    if (_mkdir(dir) == 0 || errno == EEXIST) return 0;
+#else
+    if (mkdir(dir, 0755) == 0 || errno == EEXIST) return 0;
+#endif
+    return -1;
+}
+
+int gol_program_cache_store(const char* dir, uint64_t key, cl_program program) {
+    cl_uint n_devices = 0;
+    size_t size = 0;
+    if (clGetProgramInfo(program, CL_PROGRAM_NUM_DEVICES, sizeof(n_devices), &n_devices, NULL) != CL_SUCCESS
+        || n_devices != 1
+        || clGetProgramInfo(program, CL_PROGRAM_BINARY_SIZES, sizeof(size), &size, NULL) != CL_SUCCESS
+        || size == 0) {
+        return -1;
+    }
+
+    unsigned char* binary = (unsigned char*)malloc(size);
+    if (!binary) return -1;
+    unsigned char* binaries[1] = { binary };
+    if (clGetProgramInfo(program, CL_PROGRAM_BINARIES, sizeof(binaries), binaries, NULL) != CL_SUCCESS
+        || make_dir(dir) != 0) {
+        free(binary);
+        return -1;
+    }
+
+    // Write to a temporary file and rename it, so a concurrent run never reads half an entry.
+    char path[1024];
+    char tmp_path[1024];
+    entry_path(path, sizeof(path), dir, key, "");
+    entry_path(tmp_path, sizeof(tmp_path), dir, key, ".tmp");
+    GolProgramCacheHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, GOL_PROGRAM_CACHE_MAGIC, sizeof(header.magic));
+    header.key = key;
+    header.size = (uint64_t)size;
+
+    int rc = -1;
+    FILE* f = fopen(tmp_path, "wb");
+    if (f) {
+        rc = (fwrite(&header, sizeof(header), 1, f) == 1 && fwrite(binary, 1, size, f) == size) ? 0 : -1;
+        if (fclose(f) != 0) rc = -1;
+#ifdef _WIN32
+        if (rc == 0 && !MoveFileExA(tmp_path, path, MOVEFILE_REPLACE_EXISTING)) rc = -1;
+#else
+        if (rc == 0 && rename(tmp_path, path) != 0) rc = -1;
+#endif
+        if (rc != 0) remove(tmp_path);
+    }
+    free(binary);
+    return rc;
+}
@@ -0,0 +1,80 @@
+#include "../include/gol_random.h"
+#include "../include/gol_cpu_par.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+
+// Boards below this many cells are filled by the calling thread alone.
+#define GOL_RANDOM_MIN_PARALLEL ((size_t)1 << 18)
+
+// splitmix64 finalizer.
+static uint64_t mix64(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+uint64_t gol_random_key(unsigned int seed) {
+    return mix64((uint64_t)seed + GOL_RANDOM_GAMMA);
+}
+
+uint64_t gol_random_threshold(double density) {
+    if (density <= 0.0) return 0;
+    if (density >= 1.0) return (uint64_t)1 << 32;
+    return (uint64_t)(density * 4294967296.0);
+}
+
+typedef struct FillJob {
+    unsigned char* grid;
+    size_t begin;
+    size_t end;
+    uint64_t key;
+    uint64_t threshold;
+} FillJob;
+
+// Fill cells [begin, end) of one job.
+static void* fill_range(void* arg) {
+    const FillJob* job = (const FillJob*)arg;
+    uint64_t counter = job->key + (uint64_t)job->begin * GOL_RANDOM_GAMMA;
+    for (size_t i = job->begin; i < job->end; ++i, counter += GOL_RANDOM_GAMMA) {
+        job->grid[i] = (unsigned char)((mix64(counter) >> 32) < job->threshold);
+    }
+    return NULL;
+}
+
+void gol_random_fill(unsigned char* grid, size_t n, unsigned int seed, double density, int threads) {
+    if (threads <= 0) threads = gol_cpu_count();
+    if (n < GOL_RANDOM_MIN_PARALLEL) threads = 1;
+
+    FillJob* jobs = threads > 1 ? (FillJob*)malloc((size_t)threads * sizeof(FillJob)) : NULL;
+    pthread_t* ids = threads > 1 ? (pthread_t*)malloc((size_t)threads * sizeof(pthread_t)) : NULL;
+    if (!jobs || !ids) {
+        // Single-threaded, either by choice or because the job table could not be allocated.
+        FillJob job = { grid, 0, n, gol_random_key(seed), gol_random_threshold(density) };
+        fill_range(&job);
+        free(jobs);
+        free(ids);
+        return;
+    }
+
+    // Equal contiguous chunks; the calling thread takes the first one.
+    int started = 1;
+    for (int t = 0; t < threads; ++t) {
+        jobs[t].grid = grid;
+        jobs[t].begin = n / (size_t)threads * (size_t)t;
+        jobs[t].end = t + 1 < threads ? n / (size_t)threads * (size_t)(t + 1) : n;
+        jobs[t].key = gol_random_key(seed);
+        jobs[t].threshold = gol_random_threshold(density);
+    }
+    for (int t = 1; t < threads; ++t) {
+        if (pthread_create(&ids[t], NULL, fill_range, &jobs[t]) != 0) break;
+        ++started;
+    }
+    // Chunks without a thread are filled here as well.
+    for (int t = 0; t < threads; ++t) {
+        if (t == 0 || t >= started) fill_range(&jobs[t]);
+    }
+    for (int t = 1; t < started; ++t) pthread_join(ids[t], NULL);
+    free(jobs);
+    free(ids);
+}
@@ -0,0 +1,118 @@
+#include "../include/gol_rule.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+
+typedef struct NamedRule {
+    const char* name;
+    const char* text;
+} NamedRule;
+
+static const NamedRule named_rules[] = {
+    { "conway", "B3/S23" },
+    { "life", "B3/S23" },
+    { "highlife", "B36/S23" },
+    { "daynight", "B3678/S34678" },
+    { "seeds", "B2/S" },
+    { "briansbrain", "B2/S/C3" },
+    { "starwars", "B2/S345/C4" },
+};
+
+// Collect a run of neighbor digits into a 9-bit mask; returns the number of characters consumed or -1.
+static int parse_digits(const char* s, uint32_t* mask) {
+    int i = 0;
+    *mask = 0;
+    while (isdigit((unsigned char)s[i])) {
+        const int d = s[i] - '0';
+        if (d > 8) return -1;
+        *mask |= 1u << d;
+        ++i;
+    }
+    return i;
+}
+
+// Parse an optional "/C<n>" (or, in S/B form, "/<n>") state count suffix.
+static int parse_states(const char* p, int allow_bare, int* states) {
+    *states = 2;
+    if (!*p) return 0;
+    if (*p != '/') return -1;
+    ++p;
+    if (*p == 'C' || *p == 'c' || *p == 'G' || *p == 'g') ++p;
+    else if (!allow_bare) return -1;
+    if (!isdigit((unsigned char)*p)) return -1;
+    long n = 0;
+    while (isdigit((unsigned char)*p)) {
+        n = n * 10 + (*p - '0');
+        if (n > GOL_RULE_MAX_STATES) return -1;
+        ++p;
+    }
+    if (*p || n < 2) return -1;
+    *states = (int)n;
+    return 0;
+}
+
+int gol_rule_parse(const char* text, uint32_t* table, int* states) {
+    if (!text || !table || !states) return -1;
+
+    for (size_t k = 0; k < sizeof(named_rules) / sizeof(named_rules[0]); ++k) {
+        const char* a = text;
+        const char* b = named_rules[k].name;
+        while (*a && tolower((unsigned char)*a) == *b) { ++a; ++b; }
+        if (!*a && !*b) {
+            text = named_rules[k].text;
+            break;
+        }
+    }
+
+    uint32_t birth = 0, survive = 0;
+    int bare_states = 0;
+    const char* p = text;
+    if (*p == 'B' || *p == 'b') {
+        // B<digits>/S<digits>[/C<states>]
+        int n = parse_digits(p + 1, &birth);
+        if (n < 0) return -1;
+        p += 1 + n;
+        if (*p != '/' || (p[1] != 'S' && p[1] != 's')) return -1;
+        n = parse_digits(p + 2, &survive);
+        if (n < 0) return -1;
+        p += 2 + n;
+    } else {
+        // <survive digits>/<birth digits>[/<states>]
+        int n = parse_digits(p, &survive);
+        if (n < 0 || p[n] != '/') return -1;
+        p += n + 1;
+        n = parse_digits(p, &birth);
+        if (n < 0) return -1;
+        p += n;
+        bare_states = 1;
+    }
+    int count = 2;
+    if (parse_states(p, bare_states, &count) != 0) return -1;
+    if (birth & 1u) return -2;
+
+    *table = birth | (survive << 9);
+    *states = count;
+    return 0;
+}
+
+void gol_rule_format(uint32_t table, int states, char* buf, size_t size) {
+    char text[24];
+    size_t len = 0;
+    text[len++] = 'B';
+    for (int n = 0; n <= 8; ++n) {
+        if ((table >> n) & 1u) text[len++] = (char)('0' + n);
+    }
+    text[len++] = '/';
+    text[len++] = 'S';
+    for (int n = 0; n <= 8; ++n) {
+        if ((table >> (9 + n)) & 1u) text[len++] = (char)('0' + n);
+    }
+    text[len] = 0;
+    if (states > 2) snprintf(buf, size, "%s/C%d", text, states);
+    else snprintf(buf, size, "%s", text);
+}
+
+void gol_rule_build_options(uint32_t table, int states, char* buf, size_t size) {
+    snprintf(buf, size, "-DGOL_RULE_TABLE=0x%05xu -DGOL_STATES=%d", (unsigned)table, states > 2 ? states : 2);
+}
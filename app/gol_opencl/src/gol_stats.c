@@ -0,0 +1,87 @@
+#include "../include/gol_stats.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// splitmix64 finalizer, the same mix as gol_stats_mix in kernels/gol_stats.cl.
+static uint64_t mix(uint64_t z) {
+    z += 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+void gol_stats_decode(const uint32_t* words, int n, GolGenStats* out) {
+    for (int g = 0; g < n; ++g) {
+        const uint32_t* w = words + (size_t)g * GOL_STATS_WORDS;
+        out[g].population = w[0];
+        out[g].changed = w[1];
+        out[g].hash = (uint64_t)w[2] | ((uint64_t)w[3] << 32);
+    }
+}
+
+GolGenStats gol_stats_board(const unsigned char* grid, size_t n) {
+    GolGenStats s = {0, 0, 0};
+    for (size_t i = 0; i < n; ++i) {
+        if (!grid[i]) continue;
+        ++s.population;
+        s.hash ^= mix((uint64_t)i);
+    }
+    return s;
+}
+
+int gol_stats_find_stop(const GolGenStats* gens, int from, int to, int stable, int period, const char** reason) {
+    for (int g = from; g < to; ++g) {
+        if (stable && (gens[g].changed == 0 || gens[g].population == 0)) {
+            *reason = gens[g].population == 0 ? "died out" : "stable";
+            return g;
+        }
+        if (period > 0 && g >= period && gens[g].hash == gens[g - period].hash
+            && gens[g].population == gens[g - period].population) {
+            *reason = "periodic";
+            return g;
+        }
+    }
+    return -1;
+}
+
+int gol_stats_history_init(GolStatsHistory* h, int chunk, int period) {
+    h->keep = period > 1 ? period : 1;
+    h->chunk = chunk;
+    h->gens = (GolGenStats*)malloc((size_t)(h->keep + chunk) * sizeof(GolGenStats));
+    gol_stats_history_reset(h);
+    return h->gens ? 0 : -1;
+}
+
+void gol_stats_history_reset(GolStatsHistory* h) {
+    h->kept = 0;
+    h->count = 0;
+    h->total = 0;
+}
+
+int gol_stats_history_push(GolStatsHistory* h, const uint32_t* words, int n, int stable, int period,
+                           const char** reason) {
+    // Slide the newest keep generations in front of the slots the new chunk goes into.
+    const int avail = h->kept + h->count;
+    const int kept = avail < h->keep ? avail : h->keep;
+    memmove(h->gens + h->keep - kept, h->gens + h->keep + h->count - kept, (size_t)kept * sizeof(GolGenStats));
+    h->kept = kept;
+    h->count = n;
+    gol_stats_decode(words, n, h->gens + h->keep);
+
+    // The window starts at the oldest valid generation, so period checks never look before the run.
+    const GolGenStats* window = h->gens + h->keep - kept;
+    const int g = gol_stats_find_stop(window, kept, kept + n, stable, period, reason);
+    const int first = h->total;
+    h->total += n;
+    return g < 0 ? -1 : first + (g - kept);
+}
+
+const GolGenStats* gol_stats_history_last(const GolStatsHistory* h) {
+    return &h->gens[h->keep + h->count - 1];
+}
+
+void gol_stats_history_free(GolStatsHistory* h) {
+    free(h->gens);
+    h->gens = NULL;
+}
@@ -0,0 +1,329 @@
+#include "../include/gol_stream.h"
+#include "../include/gol_device.h"
+#include "../include/gol_rule.h"
+#include "../include/kernel_loader.h"
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Most pieces a band upload is split into: zero fills and the two sides of the wrap seam.
+#define GOL_STREAM_MAX_PIECES 8
+
+// Device-side state of one of the two band slots used for double buffering.
+typedef struct StreamSlot {
+    cl_command_queue queue;
+    cl_mem buf[2];
+    cl_event writes[GOL_STREAM_MAX_PIECES];
+    cl_uint n_writes;
+    cl_event* kernels;
+    int n_kernels;
+    cl_event read;
+    int row0;       // first board row of the band in this slot
+    int band_rows;  // number of board rows the band writes back
+    int halo;       // halo rows on each side (generations of this pass)
+} StreamSlot;
+
+/*
+ * Enqueue the writes that fill local rows [0, count) of a band buffer with
+ * board rows [first, first + count). Rows outside a bounded board become zero;
+ * with wrap-around they come from the opposite edge. Board rows below head_rows
+ * are taken from the head copy, because the first band may already be written back.
+ */
+static cl_uint upload_band_rows(cl_command_queue queue, cl_mem buf,
+                                const unsigned char* board, const unsigned char* head, int head_rows,
+                                int rows, int cols, int wrap, int first, int count, cl_event* events)
+{
+    const size_t pitch = (size_t)cols;
+    cl_uint n = 0;
+    cl_int err = CL_SUCCESS;
+
+    for (int i = 0; i < count;) {
+        const int g = first + i;
+        int run;
+        if (!wrap && (g < 0 || g >= rows)) {
+            const cl_uchar zero = 0;
+            run = (g < 0) ? -g : count - i;
+            if (run > count - i) run = count - i;
+            err = clEnqueueFillBuffer(queue, buf, &zero, 1, (size_t)i * pitch, (size_t)run * pitch, 0, NULL, &events[n]);
+        } else {
+            const int gm = ((g % rows) + rows) % rows;
+            const unsigned char* src;
+            if (gm < head_rows) {
+                src = head + (size_t)gm * pitch;
+                run = head_rows - gm;
+            } else {
+                src = board + (size_t)gm * pitch;
+                run = rows - gm;
+            }
+            if (run > count - i) run = count - i;
+            err = clEnqueueWriteBuffer(queue, buf, CL_FALSE, (size_t)i * pitch, (size_t)run * pitch, src, 0, NULL, &events[n]);
+        }
+        if (err != CL_SUCCESS) gol_die_cl("upload_band_rows", err);
+        if (++n == GOL_STREAM_MAX_PIECES && i + run < count) {
+            fprintf(stderr, "Band upload split into too many pieces.\n");
+            exit(1);
+        }
+        i += run;
+    }
+    return n;
+}
+
+// Add the profiled times of a finished band to the totals and release its events.
+static void collect_stream_slot(StreamSlot* slot, cl_ulong* h2d_ns, cl_ulong* kernel_ns, cl_ulong* d2h_ns) {
+    for (cl_uint k = 0; k < slot->n_writes; ++k) {
+        *h2d_ns += gol_event_ns(slot->writes[k]);
+        clReleaseEvent(slot->writes[k]);
+    }
+    for (int k = 0; k < slot->n_kernels; ++k) {
+        *kernel_ns += gol_event_ns(slot->kernels[k]);
+        clReleaseEvent(slot->kernels[k]);
+    }
+    if (slot->read) {
+        *d2h_ns += gol_event_ns(slot->read);
+        clReleaseEvent(slot->read);
+    }
+    slot->n_writes = 0;
+    slot->n_kernels = 0;
+    slot->read = NULL;
+}
+
+// Read the finished band of a slot back into the board once `after` (the next band's upload) is done.
+static void enqueue_band_readback(StreamSlot* slot, unsigned char* board, int cols, cl_event after) {
+    const size_t pitch = (size_t)cols;
+    cl_int err = clEnqueueReadBuffer(slot->queue, slot->buf[slot->halo & 1], CL_FALSE,
+                                     (size_t)slot->halo * pitch, (size_t)slot->band_rows * pitch,
+                                     board + (size_t)slot->row0 * pitch,
+                                     after ? 1u : 0u, after ? &after : NULL, &slot->read);
+    if (err != CL_SUCCESS) gol_die_cl("clEnqueueReadBuffer(band)", err);
+    clFlush(slot->queue);
+}
+
+/*
+ * Out-of-core simulation: the board stays in a memory-mapped file and is streamed
+ * through the device in horizontal bands of band_rows rows with band_steps halo rows
+ * on each side, so every upload advances band_steps generations. Two slots with their
+ * own queues alternate, so one band's upload overlaps the previous band's kernels,
+ * and a band is only written back after the next band has read its shared halo rows.
+ */
+void gol_stream_run(GolMappedFile* board,
+                    int rows,
+                    int cols,
+                    int iters,
+                    int wrap,
+                    uint32_t rule,
+                    unsigned int seed,
+                    double density,
+                    const char* load_path,
+                    GolPatternFormat load_format,
+                    int band_rows,
+                    int band_steps,
+                    size_t lx,
+                    size_t ly,
+                    int repeat,
+                    int warmup,
+                    const char* kernel_dir,
+                    const char* kernel_cache,
+                    GolStreamStats* stats)
+{
+    cl_int err;
+    GolBuildStats build = {0, 0, 0.0, 0};
+    cl_platform_id platform;
+    cl_device_id device = gol_pick_device(&platform);
+    if (!device) {
+        fprintf(stderr, "No OpenCL GPU/CPU device found.\n");
+        exit(1);
+    }
+    gol_print_device_info(device);
+
+    cl_ulong gmem = 0, max_alloc = 0;
+    clGetDeviceInfo(device, CL_DEVICE_GLOBAL_MEM_SIZE, sizeof(gmem), &gmem, NULL);
+    clGetDeviceInfo(device, CL_DEVICE_MAX_MEM_ALLOC_SIZE, sizeof(max_alloc), &max_alloc, NULL);
+    char why[160];
+    if (!gol_local_size_fits(device, NULL, lx, ly, 0, 1, why, sizeof(why))) {
+        fprintf(stderr, "Invalid local size: %s\n", why);
+        exit(1);
+    }
+
+    // By default the four band buffers take about half of the device memory.
+    const size_t pitch = (size_t)cols;
+    if (band_rows <= 0) {
+        cl_ulong budget = gmem / 8;
+        if (budget > max_alloc) budget = max_alloc;
+        if (budget > (cl_ulong)INT_MAX) budget = INT_MAX;  // the step kernels index cells with int
+        const long long fit = (long long)(budget / pitch) - 2LL * band_steps;
+        band_rows = fit > (long long)rows ? rows : (int)(fit > 0 ? fit : 0);
+    }
+    if (band_rows > rows) band_rows = rows;
+    if (band_rows < band_steps) {
+        fprintf(stderr, "Band of %d rows cannot hold %d generations of halo; lower --band-steps or raise --band-rows.\n",
+                band_rows, band_steps);
+        exit(1);
+    }
+    const size_t buf_bytes = ((size_t)band_rows + 2u * (size_t)band_steps) * pitch;
+    if (buf_bytes > (size_t)INT_MAX) {
+        fprintf(stderr, "Band of %.0f cells exceeds the kernels' %d-cell index range; lower --band-rows.\n",
+                (double)buf_bytes, INT_MAX);
+        exit(1);
+    }
+    if (buf_bytes > max_alloc || 4u * (cl_ulong)buf_bytes > gmem) {
+        fprintf(stderr, "Band buffers of %.2f MB do not fit on the device; lower --band-rows.\n",
+                (double)buf_bytes / (1024.0 * 1024.0));
+        exit(1);
+    }
+    const int n_bands = (rows + band_rows - 1) / band_rows;
+
+    cl_context context = clCreateContext(NULL, 1, &device, NULL, NULL, &err);
+    if (!context || err != CL_SUCCESS) gol_die_cl("clCreateContext", err);
+
+    int loader_err = 0;
+    char* src = load_kernel("gol_stream.cl", kernel_dir, &loader_err);
+    if (loader_err != 0 || !src) {
+        gol_print_kernel_load_error("gol_stream.cl", kernel_dir, loader_err);
+        exit(1);
+    }
+    char build_options[64];
+    gol_rule_build_options(rule, 2, build_options, sizeof(build_options));
+    cl_program program = gol_build_program(context, device, src, build_options, kernel_cache, &build, &err);
+    if (!program) gol_die_cl("clBuildProgram", err);
+    free(src);
+
+    cl_kernel kernel = clCreateKernel(program, "gol_step_band", &err);
+    if (!kernel || err != CL_SUCCESS) gol_die_cl("clCreateKernel(gol_step_band)", err);
+
+    // Two slots, each with its own queue and ping-pong pair of band buffers.
+    StreamSlot slots[2];
+    memset(slots, 0, sizeof(slots));
+    for (int s = 0; s < 2; ++s) {
+        slots[s].queue = clCreateCommandQueueWithProperties(
+            context, device,
+            (cl_queue_properties[]){ CL_QUEUE_PROPERTIES, (cl_queue_properties)CL_QUEUE_PROFILING_ENABLE, 0 },
+            &err);
+        if (!slots[s].queue || err != CL_SUCCESS) gol_die_cl("clCreateCommandQueueWithProperties", err);
+        for (int b = 0; b < 2; ++b) {
+            slots[s].buf[b] = clCreateBuffer(context, CL_MEM_READ_WRITE, buf_bytes, NULL, &err);
+            if (!slots[s].buf[b] || err != CL_SUCCESS) gol_die_cl("clCreateBuffer(band)", err);
+        }
+        slots[s].kernels = (cl_event*)malloc((size_t)band_steps * sizeof(cl_event));
+        if (!slots[s].kernels) {
+            fprintf(stderr, "Event allocation failed.\n");
+            exit(1);
+        }
+    }
+
+    // With wrap-around the last band needs the first rows as they were before the pass.
+    unsigned char* head = NULL;
+    if (wrap) {
+        head = (unsigned char*)malloc((size_t)band_steps * pitch);
+        if (!head) {
+            fprintf(stderr, "Host allocation failed (head rows)\n");
+            exit(1);
+        }
+    }
+
+    memset(stats, 0, sizeof(*stats));
+    stats->band_rows = band_rows;
+    stats->build = build;
+    stats->n_bands = n_bands;
+    stats->passes = (iters + band_steps - 1) / band_steps;
+    gol_map_advise_sequential(board);
+
+    for (int run = 0; run < warmup + repeat; ++run) {
+        // Every run starts from the same board; generating or loading it is not timed.
+        const int rc = gol_board_init(board->data, rows, cols, seed, density, load_path, load_format);
+        if (rc != 0) {
+            fprintf(stderr, "Could not load %s: %s\n", load_path, gol_pattern_error_string(rc));
+            exit(1);
+        }
+
+        cl_ulong h2d_ns = 0, kernel_ns = 0, d2h_ns = 0;
+        double wall_start_ms = gol_now_ms();
+
+        for (int done = 0; done < iters;) {
+            const int halo = (iters - done < band_steps) ? iters - done : band_steps;
+            if (wrap) memcpy(head, board->data, (size_t)halo * pitch);
+
+            for (int b = 0; b < n_bands; ++b) {
+                StreamSlot* slot = &slots[b & 1];
+
+                // Double buffering: wait until the band that used this slot two bands ago is back on the host.
+                if (slot->read) {
+                    err = clWaitForEvents(1, &slot->read);
+                    if (err != CL_SUCCESS) gol_die_cl("clWaitForEvents(band)", err);
+                    collect_stream_slot(slot, &h2d_ns, &kernel_ns, &d2h_ns);
+                }
+
+                slot->row0 = b * band_rows;
+                slot->band_rows = (rows - slot->row0 < band_rows) ? rows - slot->row0 : band_rows;
+                slot->halo = halo;
+                const int local_rows = slot->band_rows + 2 * halo;
+
+                slot->n_writes = upload_band_rows(slot->queue, slot->buf[0], board->data, head, wrap ? halo : 0,
+                                                  rows, cols, wrap, slot->row0 - halo, local_rows, slot->writes);
+                cl_event ev_uploaded;
+                err = clEnqueueMarkerWithWaitList(slot->queue, slot->n_writes, slot->writes, &ev_uploaded);
+                if (err != CL_SUCCESS) gol_die_cl("clEnqueueMarkerWithWaitList", err);
+                clFlush(slot->queue);
+
+                // The previous band shares halo rows with this one, so it is written back only now.
+                if (b > 0) enqueue_band_readback(&slots[(b - 1) & 1], board->data, cols, ev_uploaded);
+                clReleaseEvent(ev_uploaded);
+
+                // Advance the band `halo` generations, dropping one stale row at each end per generation.
+                const int board_row0 = slot->row0 - halo;
+                for (int s = 1; s <= halo; ++s) {
+                    const int row_begin = s;
+                    const int row_count = local_rows - 2 * s;
+                    cl_mem cur = slot->buf[(s - 1) & 1];
+                    cl_mem next = slot->buf[s & 1];
+                    err  = clSetKernelArg(kernel, 0, sizeof(cl_mem), &cur);
+                    err |= clSetKernelArg(kernel, 1, sizeof(cl_mem), &next);
+                    err |= clSetKernelArg(kernel, 2, sizeof(int), &cols);
+                    err |= clSetKernelArg(kernel, 3, sizeof(int), &wrap);
+                    err |= clSetKernelArg(kernel, 4, sizeof(int), &row_begin);
+                    err |= clSetKernelArg(kernel, 5, sizeof(int), &row_count);
+                    err |= clSetKernelArg(kernel, 6, sizeof(int), &board_row0);
+                    err |= clSetKernelArg(kernel, 7, sizeof(int), &rows);
+                    if (err != CL_SUCCESS) gol_die_cl("clSetKernelArg(gol_step_band)", err);
+
+                    const size_t global[2] = { gol_round_up((size_t)row_count, lx), gol_round_up((size_t)cols, ly) };
+                    const size_t local[2] = { lx, ly };
+                    err = clEnqueueNDRangeKernel(slot->queue, kernel, 2, NULL, global, local, 0, NULL, &slot->kernels[s - 1]);
+                    if (err != CL_SUCCESS) gol_die_cl("clEnqueueNDRangeKernel(gol_step_band)", err);
+                }
+                slot->n_kernels = halo;
+                clFlush(slot->queue);
+            }
+
+            // The last band has nobody left to wait for; the next pass needs the whole board back.
+            enqueue_band_readback(&slots[(n_bands - 1) & 1], board->data, cols, NULL);
+            for (int s = 0; s < 2; ++s) {
+                err = clFinish(slots[s].queue);
+                if (err != CL_SUCCESS) gol_die_cl("clFinish", err);
+                collect_stream_slot(&slots[s], &h2d_ns, &kernel_ns, &d2h_ns);
+            }
+            done += halo;
+        }
+
+        double wall_total_ms = gol_now_ms() - wall_start_ms;
+        if (run >= warmup) {
+            stats->h2d_ms += (double)h2d_ns / 1e6 / (double)repeat;
+            stats->kernel_ms += (double)kernel_ns / 1e6 / (double)repeat;
+            stats->d2h_ms += (double)d2h_ns / 1e6 / (double)repeat;
+            stats->wall_total_ms += wall_total_ms / (double)repeat;
+        }
+    }
+
+    // Release all streaming objects.
+    free(head);
+    for (int s = 0; s < 2; ++s) {
+        free(slots[s].kernels);
+        clReleaseMemObject(slots[s].buf[0]);
+        clReleaseMemObject(slots[s].buf[1]);
+        clReleaseCommandQueue(slots[s].queue);
+    }
+    clReleaseKernel(kernel);
+    clReleaseProgram(program);
+    clReleaseContext(context);
+}
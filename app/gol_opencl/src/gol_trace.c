@@ -0,0 +1,119 @@
+#include "../include/gol_trace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct GolTraceRecord {
+    const char* name;
+    const char* category;   // NULL for host phases
+    double times_ms[4];     // host: start, end; command: queued, submit, start, end
+} GolTraceRecord;
+
+struct GolTrace {
+    char* path;
+    double origin_ms;
+    double device_offset_ms;   // host ms = device ns / 1e6 + device_offset_ms
+    GolTraceRecord* records;
+    size_t count;
+    size_t capacity;
+};
+
+GolTrace* gol_trace_open(const char* path, double origin_ms) {
+    GolTrace* t = (GolTrace*)calloc(1, sizeof(GolTrace));
+    if (!t) return NULL;
+    t->path = (char*)malloc(strlen(path) + 1);
+    t->capacity = 4096;
+    t->records = (GolTraceRecord*)malloc(t->capacity * sizeof(GolTraceRecord));
+    if (!t->path || !t->records) {
+        free(t->path);
+        free(t->records);
+        free(t);
+        return NULL;
+    }
+    strcpy(t->path, path);
+    t->origin_ms = origin_ms;
+    return t;
+}
+
+// Room for one more record; the array doubles when full. NULL when that fails.
+static GolTraceRecord* next_record(GolTrace* t) {
+    if (t->count == t->capacity) {
+        GolTraceRecord* grown = (GolTraceRecord*)realloc(t->records, 2 * t->capacity * sizeof(GolTraceRecord));
+        if (!grown) return NULL;
+        t->records = grown;
+        t->capacity *= 2;
+    }
+    return &t->records[t->count++];
+}
+
+void gol_trace_sync_device(GolTrace* t, cl_command_queue queue, double host_ms) {
+    cl_event ev;
+    cl_ulong queued = 0;
+    if (clEnqueueMarkerWithWaitList(queue, 0, NULL, &ev) != CL_SUCCESS) return;
+    clWaitForEvents(1, &ev);
+    clGetEventProfilingInfo(ev, CL_PROFILING_COMMAND_QUEUED, sizeof(queued), &queued, NULL);
+    clReleaseEvent(ev);
+    t->device_offset_ms = host_ms - (double)queued / 1e6;
+}
+
+void gol_trace_host(GolTrace* t, const char* name, double start_ms, double end_ms) {
+    GolTraceRecord* r = next_record(t);
+    if (!r) return;
+    r->name = name;
+    r->category = NULL;
+    r->times_ms[0] = start_ms;
+    r->times_ms[1] = end_ms;
+}
+
+void gol_trace_command(GolTrace* t, const char* name, const char* category, cl_event ev) {
+    static const cl_profiling_info params[4] = {
+        CL_PROFILING_COMMAND_QUEUED, CL_PROFILING_COMMAND_SUBMIT,
+        CL_PROFILING_COMMAND_START, CL_PROFILING_COMMAND_END
+    };
+    GolTraceRecord* r = next_record(t);
+    if (!r) return;
+    r->name = name;
+    r->category = category;
+    for (int i = 0; i < 4; ++i) {
+        cl_ulong ns = 0;
+        clGetEventProfilingInfo(ev, params[i], sizeof(ns), &ns, NULL);
+        r->times_ms[i] = (double)ns / 1e6 + t->device_offset_ms;
+    }
+}
+
+int gol_trace_close(GolTrace* t) {
+    FILE* f = fopen(t->path, "w");
+    int rc = f ? 0 : -1;
+    if (f) {
+        // Process 1 is the host, process 2 the OpenCL queue with an execution and a queued track.
+        fprintf(f, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+        fprintf(f, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"host\"}},\n");
+        fprintf(f, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":2,\"args\":{\"name\":\"OpenCL queue\"}},\n");
+        fprintf(f, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":2,\"tid\":1,\"args\":{\"name\":\"execution\"}},\n");
+        fprintf(f, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":2,\"tid\":2,\"args\":{\"name\":\"queued\"}}");
+
+        // Chrome trace timestamps are microseconds since the trace origin.
+        for (size_t i = 0; i < t->count; ++i) {
+            const GolTraceRecord* r = &t->records[i];
+            double us[4];
+            for (int k = 0; k < 4; ++k) us[k] = (r->times_ms[k] - t->origin_ms) * 1e3;
+            if (!r->category) {
+                fprintf(f, ",\n{\"name\":\"%s\",\"cat\":\"host\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f}",
+                        r->name, us[0], us[1] - us[0]);
+                continue;
+            }
+            fprintf(f, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":2,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f,"
+                       "\"args\":{\"queued_us\":%.3f,\"submit_us\":%.3f,\"start_us\":%.3f,\"end_us\":%.3f}}",
+                    r->name, r->category, us[2], us[3] - us[2], us[0], us[1], us[2], us[3]);
+            fprintf(f, ",\n{\"name\":\"%s\",\"cat\":\"queued\",\"ph\":\"X\",\"pid\":2,\"tid\":2,\"ts\":%.3f,\"dur\":%.3f}",
+                    r->name, us[0], us[2] - us[0]);
+        }
+        fprintf(f, "\n]}\n");
+        if (fclose(f) != 0) rc = -1;
+    }
+    free(t->records);
+    free(t->path);
+    free(t);
+    return rc;
+}
@@ -0,0 +1,114 @@
+#include "../include/gol_tuning.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+#define GOL_TUNING_LINE 1024
+
+// Split one database line into its key fields and the tuned values.
+// Returns 1 for a well-formed entry, 0 for comments and malformed lines.
+static int parse_line(char* line, char** device, char** driver, int* rows, int* cols, int* wrap, GolTuning* t) {
+    if (line[0] == '#' || line[0] == '\n' || line[0] == '\0') return 0;
+
+    char* fields[11];
+    int n = 0;
+    for (char* p = line; n < 11; ++n) {
+        fields[n] = p;
+        char* tab = strchr(p, '\t');
+        if (!tab) {
+            p[strcspn(p, "\r\n")] = '\0';
+            ++n;
+            break;
+        }
+        *tab = '\0';
+        p = tab + 1;
+    }
+    if (n != 11) return 0;
+
+    *device = fields[0];
+    *driver = fields[1];
+    *rows = atoi(fields[2]);
+    *cols = atoi(fields[3]);
+    *wrap = atoi(fields[4]);
+    t->lx = atoi(fields[5]);
+    t->ly = atoi(fields[6]);
+    t->tiled = atoi(fields[7]);
+    t->packed = atoi(fields[8]);
+    t->steps_per_launch = atoi(fields[9]);
+    t->ms_per_gen = atof(fields[10]);
+    return t->lx > 0 && t->ly > 0 && t->steps_per_launch > 0;
+}
+
+int gol_tuning_lookup(const char* path, const char* device, const char* driver,
+                      int rows, int cols, int wrap, GolTuning* out) {
+    FILE* f = fopen(path, "r");
+    if (!f) return 0;
+
+    char line[GOL_TUNING_LINE];
+    int found = 0;
+    while (!found && fgets(line, sizeof(line), f)) {
+        char* d = NULL;
+        char* v = NULL;
+        int r = 0, c = 0, w = 0;
+        GolTuning t;
+        if (parse_line(line, &d, &v, &r, &c, &w, &t) && !strcmp(d, device) && !strcmp(v, driver)
+            && r == rows && c == cols && w == wrap) {
+            *out = t;
+            found = 1;
+        }
+    }
+    fclose(f);
+    return found;
+}
+
+int gol_tuning_store(const char* path, const char* device, const char* driver,
+                     int rows, int cols, int wrap, const GolTuning* tuning) {
+    char tmp_path[1024];
+    if (snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path) >= (int)sizeof(tmp_path)) return -1;
+    FILE* out = fopen(tmp_path, "w");
+    if (!out) return -1;
+
+    // Copy every other entry, then append the new one.
+    int rc = 0;
+    FILE* in = fopen(path, "r");
+    if (in) {
+        char line[GOL_TUNING_LINE];
+        char copy[GOL_TUNING_LINE];
+        while (fgets(line, sizeof(line), in)) {
+            char* d = NULL;
+            char* v = NULL;
+            int r = 0, c = 0, w = 0;
+            GolTuning t;
+            memcpy(copy, line, sizeof(copy));
+            if (parse_line(copy, &d, &v, &r, &c, &w, &t) && !strcmp(d, device) && !strcmp(v, driver)
+                && r == rows && c == cols && w == wrap) {
+                continue;
+            }
+            if (fputs(line, out) == EOF) rc = -1;
+        }
+        fclose(in);
+    } else if (fputs("# device\tdriver\trows\tcols\twrap\tlx\tly\ttiled\tpacked\tsteps\tms_per_gen\n", out) == EOF) {
+        rc = -1;
+    }
+
+    if (fprintf(out, "%s\t%s\t%d\t%d\t%d\t%d\t%d\t%d\t%d\t%d\t%.6f\n",
+                device, driver, rows, cols, wrap, tuning->lx, tuning->ly, tuning->tiled,
+                tuning->packed, tuning->steps_per_launch, tuning->ms_per_gen) < 0) {
+        rc = -1;
+    }
+    if (fclose(out) != 0) rc = -1;
+
+    // Replace the database in one step so a concurrent reader sees either version.
+#ifdef _WIN32
+    if (rc == 0 && !MoveFileExA(tmp_path, path, MOVEFILE_REPLACE_EXISTING)) rc = -1;
+#else
+    if (rc == 0 && rename(tmp_path, path) != 0) rc = -1;
+#endif
+    if (rc != 0) remove(tmp_path);
+    return rc;
+}
@@ -4,6 +4,7 @@
 #include <stdlib.h>
 #include <limits.h>
 #include <stdint.h>
+#include <string.h>
 
 // Load an OpenCL kernel file into a null-terminated heap buffer.
 char* load_kernel_source(const char* path, int* error_code) {
@@ -93,3 +94,45 @@ char* load_kernel_source(const char* path, int* error_code) {
 
     return source;
 }
+
+// Copy an embedded kernel, or read it from kernel_dir when that override is set.
+char* load_kernel(const char* name, const char* kernel_dir, int* error_code) {
+    if (error_code == NULL) {
+        return NULL;
+    }
+
+    *error_code = 0;
+
+    if (name == NULL) {
+        *error_code = -5;  // invalid argument
+        return NULL;
+    }
+
+    // Development override: read the current file instead of the built-in copy.
+    if (kernel_dir != NULL) {
+        char path[1024];
+        if (snprintf(path, sizeof(path), "%s/%s", kernel_dir, name) >= (int)sizeof(path)) {
+            *error_code = -5;  // path too long
+            return NULL;
+        }
+        return load_kernel_source(path, error_code);
+    }
+
+    for (const EmbeddedKernel* k = embedded_kernels; k->name != NULL; ++k) {
+        if (strcmp(k->name, name) != 0) {
+            continue;
+        }
+
+        const size_t size = strlen(k->source);
+        char* source = (char*)malloc(size + 1);
+        if (!source) {
+            *error_code = -3;  // allocation error
+            return NULL;
+        }
+        memcpy(source, k->source, size + 1);
+        return source;
+    }
+
+    *error_code = -6;  // not embedded
+    return NULL;
+}
@@ -0,0 +1,161 @@
+// Checks the gol_engine library against the sequential CPU reference step:
+// every kernel variant, loads of growing and shrinking boards on one engine,
+// and reloads of more rules than the engine keeps programs for.
+// Run with `make check`; exits non-zero on the first mismatch or engine error.
+
+#include "gol_engine.h"
+#include "gol_cpu_seq.h"
+#include "gol_random.h"
+#include "gol_rule.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Programs the engine built or took from the binary cache so far; a program kept in the
+// engine's LRU is neither, so the difference across a load tells whether it compiled.
+static int programs_created(const GolEngine* engine) {
+    const GolBuildStats* build = gol_engine_build_stats(engine);
+    return build->hits + build->misses;
+}
+
+// Load a random board, step it in two calls and compare the result with the CPU reference.
+// Returns 1 when they match.
+static int check_board(GolEngine* engine, const GolEngineConfig* variant, const char* name,
+                       int rows, int cols, int wrap, const char* rule_text, int gens, unsigned int seed)
+{
+    uint32_t rule = 0;
+    int states = 0;
+    if (gol_rule_parse(rule_text, &rule, &states) != 0) {
+        fprintf(stderr, "Malformed rule: %s\n", rule_text);
+        return 0;
+    }
+    GolEngineConfig config = *variant;
+    config.states = states;
+    int rc = gol_engine_configure(engine, &config);
+
+    const size_t n = (size_t)rows * (size_t)cols;
+    unsigned char* expected = (unsigned char*)malloc(n);
+    unsigned char* scratch = (unsigned char*)malloc(n);
+    unsigned char* result = (unsigned char*)malloc(n);
+    if (!expected || !scratch || !result) {
+        fprintf(stderr, "Host allocation failed (n=%u)\n", (unsigned)n);
+        free(expected);
+        free(scratch);
+        free(result);
+        return 0;
+    }
+    gol_random_fill(expected, n, seed, 0.35, 1);
+
+    if (rc == GOL_ENGINE_OK) rc = gol_load(engine, expected, rows, cols, wrap, rule);
+    if (rc == GOL_ENGINE_OK) rc = gol_step_n(engine, gens / 2);
+    if (rc == GOL_ENGINE_OK) rc = gol_step_n(engine, gens - gens / 2);
+    if (rc == GOL_ENGINE_OK) rc = gol_read(engine, result);
+
+    int ok = rc == GOL_ENGINE_OK && gol_generation(engine) == (uint64_t)gens;
+    if (ok) {
+        for (int t = 0; t < gens; ++t) {
+            gol_cpu_step(expected, scratch, rows, cols, wrap, rule, states);
+            unsigned char* tmp = expected;
+            expected = scratch;
+            scratch = tmp;
+        }
+        ok = memcmp(expected, result, n) == 0;
+    }
+
+    printf("%-12s %4d x %-4d wrap=%d %-16s %s\n", name, rows, cols, wrap, rule_text, ok ? "ok" : "FAILED");
+    if (rc != GOL_ENGINE_OK) fprintf(stderr, "  %s: %s\n", gol_engine_error_string(rc), gol_engine_message(engine));
+    free(expected);
+    free(scratch);
+    free(result);
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    // An optional argument overrides the kernels embedded in the library, like --kernel-dir.
+    GolEngineConfig base = { 0 };
+    base.kernel_dir = argc > 1 ? argv[1] : NULL;
+    base.cache_dir = "kernel_cache";
+
+    int err = 0;
+    GolEngine* engine = gol_engine_create(&base, &err);
+    if (!engine) {
+        fprintf(stderr, "gol_engine_create: %s\n", gol_engine_error_string(err));
+        return 1;
+    }
+    printf("Device: %s\n", gol_engine_device_name(engine));
+
+    GolEngineConfig tiled = base;
+    tiled.tiled = 1;
+    tiled.lx = 8;
+    tiled.ly = 8;
+    GolEngineConfig multi = tiled;
+    multi.steps_per_launch = 3;
+    multi.batch = 1;
+    GolEngineConfig packed = base;
+    packed.packed = 1;
+    GolEngineConfig sparse = base;
+    sparse.sparse = 1;
+    GolEngineConfig stats = base;
+    stats.stats_slots = 16;
+    GolEngineConfig zero_copy = base;
+    zero_copy.zero_copy = 1;
+
+    // Each variant reloads the same engine with boards that shrink and grow again; the
+    // buffers only grow, so the smaller boards run in the larger buffers of earlier loads.
+    static const int sizes[][2] = { { 64, 48 }, { 40, 33 }, { 130, 97 }, { 17, 200 } };
+    const struct { const char* name; const GolEngineConfig* config; const char* rule; } variants[] = {
+        { "naive", &base, "B3/S23" },
+        { "tiled", &tiled, "B36/S23" },
+        { "tiled-multi", &multi, "B3/S23" },
+        { "packed", &packed, "B36/S23" },
+        { "sparse", &sparse, "B3/S23" },
+        { "stats", &stats, "B3/S23" },
+        { "zero-copy", &zero_copy, "B36/S23" },
+        { "generations", &base, "B2/S/C3" },
+    };
+    int ok = 1;
+    for (size_t v = 0; v < sizeof(variants) / sizeof(variants[0]); ++v) {
+        for (int s = 0; s < 4; ++s) {
+            ok &= check_board(engine, variants[v].config, variants[v].name, sizes[s][0], sizes[s][1], s & 1,
+                              variants[v].rule, 11, (unsigned int)(v * 4 + (size_t)s + 1));
+        }
+    }
+
+    // Sparse boards whose tile count grows by at most 4x: the flag buffers hold a byte per tile
+    // and the tile list an int, so the flags must grow even when the list already fits.
+    GolEngineConfig sparse_grow = sparse;
+    sparse_grow.lx = 16;
+    sparse_grow.ly = 16;
+    static const int grow_sizes[][2] = { { 64, 64 }, { 128, 128 }, { 200, 144 } };
+    for (int s = 0; s < 3; ++s) {
+        ok &= check_board(engine, &sparse_grow, "sparse-grow", grow_sizes[s][0], grow_sizes[s][1], s & 1,
+                          "B3/S23", 7, 50u + (unsigned)s);
+    }
+
+    // Nine rules the variants above did not use overflow the GOL_ENGINE_PROGRAMS slots: each
+    // compiles once, the first is evicted, and rules still in the LRU load without a build.
+    static const char* const rules[] = {
+        "B3/S12345", "B3678/S34678", "B368/S245", "B35678/S5678", "B34/S34",
+        "B1/S1", "B2/S23", "B36/S125", "B3/S238"
+    };
+    const int n_rules = (int)(sizeof(rules) / sizeof(rules[0]));
+    int created = programs_created(engine);
+    for (int r = 0; r < n_rules; ++r) ok &= check_board(engine, &base, "lru", 32, 32, 1, rules[r], 5, 100u + (unsigned)r);
+    const int built = programs_created(engine) - created;
+
+    // Most recently used first, then the evicted oldest, a resident one and the one just evicted.
+    const struct { int rule; int builds; } reloads[] = { { 8, 0 }, { 0, 1 }, { 2, 0 }, { 1, 1 } };
+    int reload_ok = built == n_rules;
+    for (int k = 0; k < 4; ++k) {
+        created = programs_created(engine);
+        ok &= check_board(engine, &base, "lru-reload", 32, 32, 1, rules[reloads[k].rule], 5, 200u + (unsigned)k);
+        reload_ok &= programs_created(engine) - created == reloads[k].builds;
+    }
+    printf("Program LRU: %d builds for %d rules, reloads %s\n", built, n_rules, reload_ok ? "ok" : "FAILED");
+    ok &= reload_ok;
+
+    gol_engine_destroy(engine);
+    printf("%s\n", ok ? "All engine checks passed." : "Engine checks FAILED.");
+    return ok ? 0 : 1;
+}